@@ -96,6 +96,7 @@ Amun::Amun(bool simulatorOnly, QObject *parent) :
     qRegisterMetaType<amun::Visualization>("amun::Visualization");
     qRegisterMetaType<SSLSimRobotControl>("SSLSimRobotControl");
     qRegisterMetaType<SSLSimError>("SSLSimError");
+    qRegisterMetaType<SimulatorVisionFramePtr>("SimulatorVisionFramePtr");
     qRegisterMetaType<QList<SSLSimError>>("QList<SSLSimError>");
     qRegisterMetaType<camun::simulator::ErrorSource>("ErrorSource");
     qRegisterMetaType<camun::simulator::ErrorSource>("camun::simulator::ErrorSource");
@@ -427,6 +428,7 @@ void Amun::setupReceiver(Receiver *&receiver, const QHostAddress &address, quint
 void Amun::createSimulator(const amun::SimulatorSetup &setup)
 {
     m_simulator = new Simulator(m_timer, setup);
+    m_simulator->setVisionFrameOutput(true);
     m_simulator->moveToThread(m_simulatorThread);
     connect(m_simulatorThread, SIGNAL(finished()), m_simulator, SLOT(deleteLater()));
     // pass on simulator and team settings
@@ -463,14 +465,6 @@ void Amun::handleCommandLocally(const Command &command)
             }
         }
 
-        if (sim.has_simulator_setup()) {
-            m_simulator->blockSignals(true);
-            m_simulator->deleteLater();
-            m_timer->reset();
-            createSimulator(sim.simulator_setup());
-            setSimulatorEnabled(m_simulatorEnabled, m_useNetworkTransceiver);
-        }
-
         if (sim.has_ssl_control() && sim.ssl_control().has_simulation_speed()) {
             float newSpeed = sim.ssl_control().simulation_speed();
             if (newSpeed != m_scaling) {
@@ -696,9 +690,8 @@ void Amun::setSimulatorEnabled(bool enabled, bool useNetworkTransceiver)
 
     // setup connections for vision
     if (enabled) {
-        connect(m_simulator, SIGNAL(gotPacket(QByteArray, qint64, QString)),
-                m_processor, SLOT(handleVisionPacket(QByteArray, qint64, QString)));
-        connect(m_simulator, &Simulator::sendRealData, m_processor, &Processor::handleSimulatorExtraVision);
+        // the simulator runs in the same process, thus the vision frames can be passed without serialization
+        connect(m_simulator, &Simulator::gotVisionFrame, m_processor, &Processor::handleSimulatorVisionFrame);
 
     } else {
         connect(m_vision, SIGNAL(gotPacket(QByteArray, qint64, QString)),
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LOCKSTEPAMUN_H
+#define LOCKSTEPAMUN_H
+
+#include "protobuf/command.h"
+#include "protobuf/status.h"
+#include "core/timer.h"
+#include <QObject>
+#include <QSet>
+#include <cstdint>
+#include <memory>
+
+class CommandConverter;
+class CompilerRegistry;
+class Processor;
+class Strategy;
+namespace camun {
+    namespace simulator {
+        class Simulator;
+    }
+}
+
+/*!
+ * \brief Single threaded replacement for Amun, which runs as fast as possible
+ *
+ * Simulator, processor and strategies all live in the calling thread and are
+ * connected directly. Instead of timers, each call to step advances the simulated
+ * time by one processor tick and then runs the processor and the strategies.
+ * Thus a run only depends on the seed and the commands, not on the load of the machine.
+ *
+ * The internal game controller and autoref are not available, referee commands
+ * are passed directly to the processor.
+ */
+class LockstepAmun : public QObject
+{
+    Q_OBJECT
+
+public:
+    // the simulator requires a non-zero start time
+    static const qint64 START_TIME;
+    static const qint64 STEP_TIME;
+
+    // only the strategies of the selected teams are created
+    LockstepAmun(const amun::SimulatorSetup &setup, CompilerRegistry *registry, uint32_t seed,
+                 bool runBlue, bool runYellow, QObject *parent = nullptr);
+    ~LockstepAmun() override;
+    LockstepAmun(const LockstepAmun&) = delete;
+    LockstepAmun& operator=(const LockstepAmun&) = delete;
+
+    // removes the timings measured with the wall clock from all status messages
+    void setDeterministicStatus(bool deterministic) { m_deterministicStatus = deterministic; }
+    // advances the simulation by one processor tick, does nothing while paused
+    void step();
+    bool isPaused() const { return !m_pauseReasons.isEmpty(); }
+    qint64 currentTime() const { return m_timer.currentTime(); }
+
+signals:
+    void sendStatus(const Status &status);
+    void pausedChanged(bool paused);
+
+public slots:
+    void handleCommand(const Command &command);
+
+private:
+    void createSimulator(const amun::SimulatorSetup &setup);
+    void handleStatus(const Status &status);
+
+private:
+    Timer m_timer;
+    const uint32_t m_seed;
+    std::unique_ptr<camun::simulator::Simulator> m_simulator;
+    std::unique_ptr<Processor> m_processor;
+    std::unique_ptr<CommandConverter> m_converter;
+    std::unique_ptr<Strategy> m_strategy[2];
+    QSet<amun::PauseSimulatorReason> m_pauseReasons;
+    bool m_deterministicStatus = false;
+};
+
+#endif // LOCKSTEPAMUN_H
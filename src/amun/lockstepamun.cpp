@@ -0,0 +1,164 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "lockstepamun.h"
+#include "commandconverter.h"
+#include "processor/processor.h"
+#include "simulator/fastsimulator.h"
+#include "simulator/simulator.h"
+#include "strategy/strategy.h"
+
+using camun::simulator::Simulator;
+
+const qint64 LockstepAmun::START_TIME = 1000 * 1000 * 1000;
+const qint64 LockstepAmun::STEP_TIME = 10 * 1000 * 1000;
+
+LockstepAmun::LockstepAmun(const amun::SimulatorSetup &setup, CompilerRegistry *registry, uint32_t seed,
+                           bool runBlue, bool runYellow, QObject *parent) :
+    QObject(parent),
+    m_seed(seed)
+{
+    m_timer.setTime(START_TIME, 0);
+
+    // the processor is run in replay mode, which disables its own timers
+    m_processor.reset(new Processor(&m_timer, true));
+    m_converter.reset(new CommandConverter(&m_timer));
+    connect(m_processor.get(), &Processor::sendStatus, this, &LockstepAmun::handleStatus);
+    connect(m_converter.get(), &CommandConverter::sendStatus, this, &LockstepAmun::handleStatus);
+    connect(m_processor.get(), &Processor::sendRadioCommands, m_converter.get(), &CommandConverter::handleRadioCommands);
+
+    const StrategyType types[2] = {StrategyType::BLUE, StrategyType::YELLOW};
+    const bool runStrategy[2] = {runBlue, runYellow};
+    for (int i = 0; i < 2; i++) {
+        if (!runStrategy[i]) {
+            continue;
+        }
+        auto connection = std::make_shared<StrategyGameControllerMediator>(false);
+        m_strategy[i].reset(new Strategy(&m_timer, types[i], nullptr, registry, connection));
+        Strategy *strategy = m_strategy[i].get();
+        connect(m_processor.get(), &Processor::sendStrategyStatus, strategy, &Strategy::handleStatus);
+        connect(m_processor.get(), &Processor::setFlipped, strategy, &Strategy::setFlipped);
+        connect(strategy, &Strategy::sendStrategyCommands, m_processor.get(), &Processor::handleStrategyCommands);
+        connect(strategy, &Strategy::sendHalt, m_processor.get(), &Processor::handleStrategyHalt);
+        connect(strategy, &Strategy::sendStatus, this, &LockstepAmun::handleStatus);
+        connect(strategy, &Strategy::gotCommand, this, &LockstepAmun::handleCommand);
+    }
+
+    createSimulator(setup);
+
+    // the referee packets are passed to the processor's referee for external game controllers
+    Command command(new amun::Command);
+    command->mutable_referee()->set_active(false);
+    m_processor->handleCommand(command);
+}
+
+LockstepAmun::~LockstepAmun() = default;
+
+void LockstepAmun::createSimulator(const amun::SimulatorSetup &setup)
+{
+    m_simulator.reset(new Simulator(&m_timer, setup, true));
+    m_simulator->seedPRGN(m_seed);
+    m_simulator->setVisionFrameOutput(true);
+    connect(m_simulator.get(), &Simulator::gotVisionFrame, m_processor.get(), &Processor::handleSimulatorVisionFrame);
+    connect(m_simulator.get(), &Simulator::sendRadioResponses, m_processor.get(), &Processor::handleRadioResponses);
+    connect(m_simulator.get(), &Simulator::sendSSLSimError, m_converter.get(), &CommandConverter::handleSimulatorErrors);
+    connect(m_simulator.get(), &Simulator::sendStatus, this, &LockstepAmun::handleStatus);
+    connect(m_converter.get(), &CommandConverter::sendSSLSim, m_simulator.get(), &Simulator::handleRadioCommands);
+    connect(m_processor.get(), &Processor::setFlipped, m_simulator.get(), &Simulator::setFlipped);
+}
+
+void LockstepAmun::handleCommand(const Command &command)
+{
+    const bool wasPaused = isPaused();
+    if (command->has_pause_simulator()) {
+        const amun::PauseSimulatorCommand &pause = command->pause_simulator();
+        if (pause.has_pause()) {
+            if (pause.pause()) {
+                m_pauseReasons.insert(pause.reason());
+            } else {
+                m_pauseReasons.remove(pause.reason());
+            }
+        }
+        if (pause.has_toggle() && pause.toggle()) {
+            if (m_pauseReasons.contains(pause.reason())) {
+                m_pauseReasons.remove(pause.reason());
+            } else {
+                m_pauseReasons.insert(pause.reason());
+            }
+        }
+    }
+
+    Command forwarded = command;
+    if (command->has_referee()) {
+        // the internal game controller runs in a thread of its own, thus bypass it
+        // and use the processor's referee for external game controllers instead
+        if (command->referee().has_command()) {
+            const std::string &packet = command->referee().command();
+            m_processor->handleRefereePacket(QByteArray(packet.data(), int(packet.size())), m_timer.currentTime(), "lockstep");
+        }
+        forwarded = Command(new amun::Command(*command));
+        forwarded->mutable_referee()->set_active(false);
+    }
+
+    m_simulator->handleCommand(forwarded);
+    m_processor->handleCommand(forwarded);
+    m_converter->handleCommand(forwarded);
+    for (auto &strategy : m_strategy) {
+        if (strategy) {
+            strategy->handleCommand(forwarded);
+        }
+    }
+
+    if (isPaused() != wasPaused) {
+        emit pausedChanged(isPaused());
+    }
+}
+
+void LockstepAmun::step()
+{
+    if (isPaused()) {
+        return;
+    }
+    FastSimulator::goDelta(m_simulator.get(), &m_timer, STEP_TIME);
+    m_processor->process();
+    for (auto &strategy : m_strategy) {
+        if (strategy) {
+            strategy->tryProcess();
+        }
+    }
+}
+
+void LockstepAmun::handleStatus(const Status &original)
+{
+    // the status may be shared with other receivers of the sender, thus never modify it
+    Status status(new amun::Status(*original));
+    status->set_time(m_timer.currentTime());
+    if (m_deterministicStatus && status->has_timing()) {
+        // only keep the latency, it is measured in simulated time
+        amun::Timing *timing = status->mutable_timing();
+        const bool hasLatency = timing->has_vision_to_command();
+        const float latency = timing->vision_to_command();
+        timing->Clear();
+        if (hasLatency) {
+            timing->set_vision_to_command(latency);
+        }
+    }
+    emit sendStatus(status);
+}
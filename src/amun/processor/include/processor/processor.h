@@ -26,9 +26,11 @@
 #include "protobuf/ssl_mixed_team.pb.h"
 #include "protobuf/ssl_wrapper.pb.h"
 #include "protobuf/status.h"
+#include "protobuf/visionframe.h"
 #include <QMap>
 #include <QPair>
 #include <QObject>
+#include <QSet>
 #include <QThread>
 #include <cstddef>
 #include <cstdint>
@@ -50,6 +52,7 @@ class Processor : public QObject
 
 public:
     static const int FREQUENCY;
+    static const qint64 DEFAULT_FRAME_DEADLINE;
 
     explicit Processor(const Timer *timer, bool isReplay);
     ~Processor() override;
@@ -71,6 +74,7 @@ public slots:
     void handleRefereePacket(const QByteArray &data, qint64 time, QString sender);
     void handleVisionPacket(const QByteArray &data, qint64 time, QString sender);
     void handleSimulatorExtraVision(const QByteArray &data);
+    void handleSimulatorVisionFrame(const SimulatorVisionFramePtr &frame, qint64 time);
     void handleMixedTeamInfo(const QByteArray &data, qint64 time);
     void handleRadioResponses(const QList<robot::RadioResponse> &responses);
     void handleCommand(const Command &command);
@@ -102,9 +106,12 @@ private:
     void injectRawWorldState(Status &status);
     void clearRawWorldState();
     void injectUserControl(Status &status, bool isBlue);
-    Status assembleStatus(qint64 time, bool resetRaw);
+    Status assembleStatus(qint64 time, bool resetRaw, world::State *trackedState = nullptr);
     void injectAndClearDebugValues(qint64 currentTime, Status &status);
     world::WorldSource currentWorldSource() const;
+    void scheduleFrameAlignedProcessing(quint32 cameraId, qint64 time);
+    void handleVisionWrapper(const SSL_WrapperPacket &wrapper, qint64 time, const QString &sender);
+    void updateVisionToCommandTiming(Status &status, qint64 sendTime);
 
     void sendTeams();
 
@@ -113,7 +120,9 @@ private:
     bool m_externalSimulatorEnabled = false;
 
     const Timer *m_timer;
+    const bool m_isReplay;
     QTimer* m_trigger;
+    QTimer* m_frameDeadlineTrigger;
     Referee *m_referee;
     Referee *m_refereeInternal;
     std::unique_ptr<WorldParameters> m_worldParameters;
@@ -124,6 +133,8 @@ private:
     QList<QByteArray> m_extraVision;
     /*! \brief Pair of SSL_WrapperPacket and the time it was received. */
     std::vector<std::pair<SSL_WrapperPacket, qint64>> m_visionWrapperPackets;
+    /*! \brief Vision frames passed directly by the internal simulator and the time they were received. */
+    std::vector<std::pair<SimulatorVisionFramePtr, qint64>> m_visionFrames;
     ssl::TeamPlan m_mixedTeamInfo;
     bool m_mixedTeamInfoSet;
     bool m_refereeInternalActive;
@@ -137,6 +148,21 @@ private:
     // about the setup changes.
     uint64_t m_trackingRadioCommandDelay = 0;
 
+    // Frame aligned processing runs the tracking as soon as a new frame of
+    // every active camera was received (or the deadline is reached). The
+    // fixed timer is then only used as fallback if no vision data arrives.
+    bool m_frameAlignedProcessing = false;
+    qint64 m_frameDeadline = DEFAULT_FRAME_DEADLINE;
+    /*! \brief Receive time of the latest detection frame, indexed by camera id */
+    QMap<quint32, qint64> m_lastCameraFrame;
+    QSet<quint32> m_pendingCameras;
+    /*! \brief Exponentially smoothed interval between two frames of a camera, zero until known */
+    double m_framePeriod = 0;
+    /*! \brief Receive times of the detection frames since the last process call */
+    std::vector<qint64> m_pendingVisionTimes;
+    /*! \brief Time spent parsing vision packets since the last process call */
+    qint64 m_visionParseTime = 0;
+
     Team m_blueTeam;
     Team m_yellowTeam;
 
@@ -23,6 +23,7 @@
 
 #include <QObject>
 #include <QCache>
+#include <QByteArray>
 
 #include "protobuf/ssl_referee.h"
 #include "protobuf/status.h"
@@ -41,6 +42,8 @@ signals:
 public slots:
     // this function will set the replay timer itself
     void handleStatus(const Status &status);
+    // forwards the command to the replay processor, e.g. to change tracking options
+    void handleCommand(const Command &command);
 
 private slots:
     void ammendStatus(const Status &status);
@@ -52,8 +55,9 @@ private:
     SSLRefereeExtractor m_refereeExtractor;
 
     // the tracking can not go back in time, therefore add a cache for already processed packages
-    QCache<QString, Status> m_statusCache;
-    QString m_currentPacketString;
+    // the cache is keyed on a hash that identifies the input status and shares the result
+    QCache<quint64, Status> m_statusCache;
+    quint64 m_currentPacketIdentifier = 0;
 };
 
 #endif // TRACKINGREPLAY_H
@@ -118,6 +118,14 @@ struct Processor::Robot
  */
 
 const int Processor::FREQUENCY(100);
+// wait at most 5ms for the remaining cameras once the first frame of a frame set arrived
+const qint64 Processor::DEFAULT_FRAME_DEADLINE(5 * 1000 * 1000);
+// cameras which did not send a frame for this time are not waited for
+static const qint64 CAMERA_TIMEOUT(100 * 1000 * 1000);
+// frame intervals below this are duplicate or split frames and are not used to estimate the frame period
+static const qint64 MIN_FRAME_PERIOD(4 * 1000 * 1000);
+// weight of a new frame interval in the smoothed frame period
+static const double FRAME_PERIOD_SMOOTHING(0.1);
 
 /*!
  * \brief Constructs a Processor
@@ -125,6 +133,7 @@ const int Processor::FREQUENCY(100);
  */
 Processor::Processor(const Timer *timer, bool isReplay) :
     m_timer(timer),
+    m_isReplay(isReplay),
     m_worldParameters(new WorldParameters { m_simulatorEnabled, isReplay }),
     m_tracker(new Tracker(false, false, m_worldParameters.get())),
     m_speedTracker(new Tracker(true, true, m_worldParameters.get())),
@@ -170,6 +179,12 @@ Processor::Processor(const Timer *timer, bool isReplay) :
         m_trigger->start(1000/FREQUENCY);
     }
 
+    // deadline for frame aligned processing, if not all cameras deliver their frame in time
+    m_frameDeadlineTrigger = new QTimer(this);
+    m_frameDeadlineTrigger->setSingleShot(true);
+    m_frameDeadlineTrigger->setTimerType(Qt::PreciseTimer);
+    connect(m_frameDeadlineTrigger, &QTimer::timeout, this, [this]() { process(); });
+
     connect(timer, &Timer::scalingChanged, this, &Processor::setScaling);
 
     loadConfiguration("division-dimensions", &m_divisionDimensions, false);
@@ -190,11 +205,15 @@ Processor::~Processor()
     qDeleteAll(m_yellowTeam.robots);
 }
 
-Status Processor::assembleStatus(qint64 time, bool resetRaw)
+Status Processor::assembleStatus(qint64 time, bool resetRaw, world::State *trackedState)
 {
     Status status { new amun::Status };
 
-    m_tracker->worldState(status->mutable_world_state(), time, resetRaw);
+    if (trackedState) {
+        status->mutable_world_state()->Swap(trackedState);
+    } else {
+        m_tracker->worldState(status->mutable_world_state(), time, resetRaw);
+    }
 
     if (auto geometry = m_worldParameters->getGeometryUpdate(); geometry) {
         status->mutable_geometry()->Swap(&*geometry);
@@ -304,12 +323,26 @@ void Processor::process(qint64 overwriteTime)
 {
     const qint64 tracker_start = Timer::systemTime();
 
-    // the controller runs with 100 Hz -> 10ms ticks
-    const qint64 tickDuration = 1000 * 1000 * 1000 / FREQUENCY;
-
     // We have these three different times to consider for each processing step.
     // currentTime is the time we have *now*, which is used to compute the world state in this point in time.
     const qint64 currentTime = overwriteTime == -1 ? m_timer->currentTime() : overwriteTime;
+
+    // the controller runs with 100 Hz -> 10ms ticks
+    // with frame aligned processing the next tick follows the next frame set,
+    // which is estimated using the smoothed camera frame period
+    qint64 tickDuration = 1000 * 1000 * 1000 / FREQUENCY;
+    if (m_frameAlignedProcessing && m_framePeriod > 0) {
+        tickDuration = qBound(MIN_FRAME_PERIOD, qint64(m_framePeriod), tickDuration);
+    }
+
+    if (m_frameAlignedProcessing) {
+        m_pendingCameras.clear();
+        m_frameDeadlineTrigger->stop();
+        // the timer only serves as fallback if no vision frames arrive
+        if (m_trigger->isActive()) {
+            m_trigger->start();
+        }
+    }
     // controllerTime is supposed to be the time at which the command we will send out in this call arrives
     // at the robot and the robot can actually act on it
     const qint64 controllerTime = currentTime + m_trackingRadioCommandDelay;
@@ -323,7 +356,12 @@ void Processor::process(qint64 overwriteTime)
     m_speedTracker->process(currentTime);
     m_simpleTracker->process(currentTime);
 
-    Status status = assembleStatus(currentTime, false);
+    // predict the world state for now and for the time at which the command reaches the robot in one pass
+    std::vector<world::State> trackedStates;
+    m_tracker->worldStates({ currentTime, controllerTime }, trackedStates, false);
+    world::State &commandWorldState = trackedStates[1];
+
+    Status status = assembleStatus(currentTime, false, &trackedStates[0]);
     injectAndClearDebugValues(currentTime, status);
 
     // run referee
@@ -333,6 +371,9 @@ void Processor::process(qint64 overwriteTime)
         m_lastFlipped = activeReferee->getFlipped();
 
         m_worldParameters->setFlip(m_lastFlipped);
+        // the command world state was predicted with the previous field transform
+        commandWorldState.Clear();
+        m_tracker->worldState(&commandWorldState, controllerTime, false);
 
         emit setFlipped(m_lastFlipped);
     }
@@ -358,6 +399,11 @@ void Processor::process(qint64 overwriteTime)
     const qint64 controller_start = Timer::systemTime();
     // just ignore the referee for timing
     status->mutable_timing()->set_tracking((controller_start - tracker_start) * 1E-9f);
+    if (!m_pendingVisionTimes.empty()) {
+        status->mutable_timing()->set_vision_parse(m_visionParseTime * 1E-9f);
+    }
+    m_visionParseTime = 0;
+    m_tracker->takeFilterTimings(status->mutable_timing());
 
     amun::DebugValues *debug = status->add_debug();
     debug->set_source(amun::Controller);
@@ -365,9 +411,8 @@ void Processor::process(qint64 overwriteTime)
 
     {
         QList<robot::RadioCommand> radio_commands;
-        // compute world state and speed for the time at which the command reaches the robot
-        world::State commandWorldState, radioWorldState;
-        m_tracker->worldState(&commandWorldState, controllerTime, false);
+        // compute speed for the time at which the command reaches the robot
+        world::State radioWorldState;
         m_speedTracker->worldState(&radioWorldState, controllerTime, false);
 
         processTeam(m_blueTeam, true, commandWorldState.blue(), radio_commands_prio, radio_commands,
@@ -409,15 +454,64 @@ void Processor::process(qint64 overwriteTime)
 
     // publish world state and timing information
     status->mutable_timing()->set_controller((Timer::systemTime() - controller_start) * 1E-9f);
-    emit sendStatus(status);
 
     if (m_transceiverEnabled) {
         emit sendRadioCommands(radio_commands_prio, currentTime);
     }
+    if (overwriteTime == -1) {
+        updateVisionToCommandTiming(status, m_timer->currentTime());
+    }
+    m_pendingVisionTimes.clear();
+
+    emit sendStatus(status);
 
     m_worldParameters->finishProcessing();
 }
 
+void Processor::updateVisionToCommandTiming(Status &status, qint64 sendTime)
+{
+    if (m_pendingVisionTimes.empty()) {
+        return;
+    }
+    double latencySum = 0;
+    for (qint64 receiveTime : m_pendingVisionTimes) {
+        latencySum += sendTime - receiveTime;
+    }
+    status->mutable_timing()->set_vision_to_command(latencySum / m_pendingVisionTimes.size() * 1E-9);
+}
+
+void Processor::scheduleFrameAlignedProcessing(quint32 cameraId, qint64 time)
+{
+    // a second frame of the same camera means that the frame set won't get any more complete
+    const bool isRepeatedCamera = m_pendingCameras.contains(cameraId);
+    auto lastFrame = m_lastCameraFrame.find(cameraId);
+    if (lastFrame != m_lastCameraFrame.end()) {
+        const qint64 interval = time - lastFrame.value();
+        if (interval >= MIN_FRAME_PERIOD && interval < CAMERA_TIMEOUT) {
+            m_framePeriod = m_framePeriod > 0
+                    ? (1 - FRAME_PERIOD_SMOOTHING) * m_framePeriod + FRAME_PERIOD_SMOOTHING * interval
+                    : interval;
+        }
+    }
+    m_lastCameraFrame[cameraId] = time;
+    m_pendingCameras.insert(cameraId);
+
+    bool frameSetComplete = true;
+    for (auto it = m_lastCameraFrame.begin(); it != m_lastCameraFrame.end(); ++it) {
+        if (it.value() + CAMERA_TIMEOUT >= time && !m_pendingCameras.contains(it.key())) {
+            frameSetComplete = false;
+            break;
+        }
+    }
+
+    if (frameSetComplete || isRepeatedCamera) {
+        process();
+    } else if (!m_frameDeadlineTrigger->isActive()) {
+        const int deadline = std::max<qint64>(1, m_frameDeadline / (1000 * 1000));
+        m_frameDeadlineTrigger->start(deadline);
+    }
+}
+
 const world::Robot* Processor::getWorldRobot(const RobotList &robots, uint id) {
     for (RobotList::const_iterator it = robots.begin(); it != robots.end(); ++it) {
         const world::Robot &robot = *it;
@@ -457,17 +551,26 @@ void Processor::injectRawWorldState(Status &status)
         worldState->add_reality()->ParseFromArray(data.data(), data.size());
     }
 
-    worldState->set_has_vision_data(!m_visionWrapperPackets.empty());
+    worldState->set_has_vision_data(!m_visionWrapperPackets.empty() || !m_visionFrames.empty());
     for (const auto& [wrapper, time] : m_visionWrapperPackets) {
         worldState->add_vision_frames()->CopyFrom(wrapper);
         worldState->add_vision_frame_times(time);
     }
+    for (const auto& [frame, time] : m_visionFrames) {
+        for (const SSL_WrapperPacket &wrapper : frame->packets) {
+            worldState->add_vision_frames()->CopyFrom(wrapper);
+            worldState->add_vision_frame_times(time);
+        }
+        worldState->add_reality()->CopyFrom(frame->simulatorState);
+    }
 }
 
 void Processor::clearRawWorldState()
 {
     m_extraVision.clear();
     m_visionWrapperPackets.clear();
+    // releases the frames back to the pool of the simulator
+    m_visionFrames.clear();
 }
 
 void Processor::injectUserControl(Status &status, bool isBlue)
@@ -551,13 +654,29 @@ void Processor::handleRefereePacket(const QByteArray &data, qint64 /*time*/, QSt
 
 void Processor::handleVisionPacket(const QByteArray &data, qint64 time, QString sender)
 {
+    const qint64 parseStart = Timer::systemTime();
     SSL_WrapperPacket wrapper;
-    if (!wrapper.ParseFromArray(data.data(), data.size())) {
+    const bool parsed = wrapper.ParseFromArray(data.data(), data.size());
+    m_visionParseTime += Timer::systemTime() - parseStart;
+    if (!parsed) {
         return;
     }
 
     m_visionWrapperPackets.emplace_back(wrapper, time);
+    handleVisionWrapper(wrapper, time, sender);
+}
 
+void Processor::handleSimulatorVisionFrame(const SimulatorVisionFramePtr &frame, qint64 time)
+{
+    // the frame is shared with the simulator, keep it until the raw world state is published
+    m_visionFrames.emplace_back(frame, time);
+    for (const SSL_WrapperPacket &wrapper : frame->packets) {
+        handleVisionWrapper(wrapper, time, QStringLiteral("simulator"));
+    }
+}
+
+void Processor::handleVisionWrapper(const SSL_WrapperPacket &wrapper, qint64 time, const QString &sender)
+{
     if (wrapper.has_geometry()) {
         m_worldParameters->handleVisionGeometry(wrapper.geometry(), sender);
     }
@@ -568,6 +687,12 @@ void Processor::handleVisionPacket(const QByteArray &data, qint64 time, QString
         m_tracker->queuePacket(detection, time);
         m_speedTracker->queuePacket(detection, time);
         m_simpleTracker->queuePacket(detection, time);
+
+        m_pendingVisionTimes.push_back(time);
+        // processing is paused while the trigger is inactive
+        if (m_frameAlignedProcessing && !m_isReplay && m_trigger->isActive()) {
+            scheduleFrameAlignedProcessing(detection.camera_id(), time);
+        }
     }
 }
 
@@ -645,12 +770,26 @@ void Processor::handleCommand(const Command &command)
         const qint64 currentTime = m_timer->currentTime();
 
         m_tracker->handleCommand(command->tracking(), currentTime);
-        m_speedTracker->handleCommand(command->tracking(), currentTime);
-        m_simpleTracker->handleCommand(command->tracking(), currentTime);
+        // only the main tracker reports its filter timings
+        amun::CommandTracking auxiliaryTracking = command->tracking();
+        auxiliaryTracking.clear_measure_filter_timing();
+        m_speedTracker->handleCommand(auxiliaryTracking, currentTime);
+        m_simpleTracker->handleCommand(auxiliaryTracking, currentTime);
 
         if (command->tracking().has_radio_command_delay()) {
             m_trackingRadioCommandDelay = command->tracking().radio_command_delay();
         }
+
+        if (command->tracking().has_frame_aligned_processing()) {
+            m_frameAlignedProcessing = command->tracking().frame_aligned_processing();
+            m_pendingCameras.clear();
+            m_lastCameraFrame.clear();
+            m_frameDeadlineTrigger->stop();
+        }
+
+        if (command->tracking().has_frame_deadline()) {
+            m_frameDeadline = command->tracking().frame_deadline();
+        }
     }
 
     if (command->has_transceiver()) {
@@ -744,6 +883,7 @@ void Processor::setScaling(double scaling)
     // update scaling as told
     if (scaling <= 0) {
         m_trigger->stop();
+        m_frameDeadlineTrigger->stop();
     } else {
         const int t = 10 / scaling;
         m_trigger->start(qMax(1, t));
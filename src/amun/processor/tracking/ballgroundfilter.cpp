@@ -48,6 +48,7 @@ void GroundFilter::reset(const VisionFrame& frame)
     setObservationStdDev(0.003f);
 
     m_lastUpdate = frame.time;
+    m_baseMotionValid = false;
 }
 
 void GroundFilter::setSpeed(Eigen::Vector2f speed)
@@ -56,7 +57,17 @@ void GroundFilter::setSpeed(Eigen::Vector2f speed)
     m_kalman->modifyState(4, speed.y());
 }
 
-void GroundFilter::predict(qint64 time)
+void GroundFilter::updateBaseMotion()
+{
+    const Kalman::Vector d = m_kalman->baseState();
+    m_baseSpeed = std::sqrt(d(3) * d(3) + d(4) * d(4));
+    const double phi = std::atan2(d(4), d(3));
+    m_baseDirectionX = std::cos(phi);
+    m_baseDirectionY = std::sin(phi);
+    m_baseMotionValid = true;
+}
+
+void GroundFilter::predict(qint64 time, bool withCovariance)
 {
     if (time == m_lastUpdate) {
         return;
@@ -69,16 +80,18 @@ void GroundFilter::predict(qint64 time)
     m_kalman->F(0, 3) = timeDiff;
     m_kalman->F(1, 4) = timeDiff;
     m_kalman->F(2, 5) = timeDiff;
-    m_kalman->B = m_kalman->F;
 
     // simple ball rolling friction estimation
     const float deceleration = m_ballModel.slow_deceleration() * timeDiff;
-    const Kalman::Vector d = m_kalman->baseState();
-    const double v = std::sqrt(d(3) * d(3) + d(4) * d(4));
-    const double phi = std::atan2(d(4), d(3));
+    // the base state only changes with a vision frame, but is predicted for every world state
+    if (!m_baseMotionValid) {
+        updateBaseMotion();
+    }
+    const Kalman::Vector &d = m_kalman->baseState();
+    const double v = m_baseSpeed;
     if (v < deceleration) {
-        m_kalman->u(0) = -v * std::cos(phi) * timeDiff/2;
-        m_kalman->u(1) = -v * std::sin(phi) * timeDiff/2;
+        m_kalman->u(0) = -v * m_baseDirectionX * timeDiff/2;
+        m_kalman->u(1) = -v * m_baseDirectionY * timeDiff/2;
         m_kalman->u(3) = -d(3)/2;
         m_kalman->u(4) = -d(4)/2;
         // only a moving ball can fly
@@ -87,10 +100,10 @@ void GroundFilter::predict(qint64 time)
     } else {
         if (d(2) < 0.1f) {
             // rolling
-            m_kalman->u(0) = -deceleration * std::cos(phi) * timeDiff/2;
-            m_kalman->u(1) = -deceleration * std::sin(phi) * timeDiff/2;
-            m_kalman->u(3) = -deceleration * std::cos(phi);
-            m_kalman->u(4) = -deceleration * std::sin(phi);
+            m_kalman->u(0) = -deceleration * m_baseDirectionX * timeDiff/2;
+            m_kalman->u(1) = -deceleration * m_baseDirectionY * timeDiff/2;
+            m_kalman->u(3) = -deceleration * m_baseDirectionX;
+            m_kalman->u(4) = -deceleration * m_baseDirectionY;
             m_kalman->u(2) = -d(2)/2;
             m_kalman->u(5) = -d(5)/2;
         } else {
@@ -103,6 +116,14 @@ void GroundFilter::predict(qint64 time)
         }
     }
 
+    // the covariance is only required to apply a vision frame
+    if (!withCovariance) {
+        m_kalman->predictState();
+        return;
+    }
+
+    m_kalman->B = m_kalman->F;
+
     // Process noise: stddev for acceleration
     // just a random guess
     const bool probableShoot = false;
@@ -161,7 +182,7 @@ void GroundFilter::setObservationStdDev(float deviation)
 
 void GroundFilter::processVisionFrame(const VisionFrame& frame)
 {
-    predict(frame.time);
+    predict(frame.time, true);
 
     // linearGroundFilter
     m_kalman->z(0) = frame.x;
@@ -169,6 +190,7 @@ void GroundFilter::processVisionFrame(const VisionFrame& frame)
 
     m_kalman->update();
     m_lastUpdate = frame.time;
+    m_baseMotionValid = false;
 }
 
 float GroundFilter::distanceTo(Eigen::Vector2f objPos) const
@@ -189,7 +211,7 @@ float GroundFilter::distanceTo(Eigen::Vector2f objPos) const
 
 void GroundFilter::writeBallState(world::Ball *ball, qint64 time, const QVector<RobotInfo> &, qint64)
 {
-    predict(time);
+    predict(time, false);
 
     ball->set_p_x(m_kalman->state()(0));
     ball->set_p_y(m_kalman->state()(1));
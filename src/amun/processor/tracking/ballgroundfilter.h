@@ -45,8 +45,14 @@ public:
 
 private:
     std::unique_ptr<Kalman> m_kalman;
-    void predict(qint64 time);
+    void predict(qint64 time, bool withCovariance);
+    void updateBaseMotion();
     qint64 m_lastUpdate;
+    // speed and direction of the base state, cached between vision frames
+    bool m_baseMotionValid = false;
+    double m_baseSpeed = 0;
+    double m_baseDirectionX = 1;
+    double m_baseDirectionY = 0;
 };
 
 #endif // BALLGROUNDFILTER_H
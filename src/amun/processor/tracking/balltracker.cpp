@@ -22,11 +22,14 @@
 #include "ballflyfilter.h"
 #include "ballgroundcollisionfilter.h"
 
-BallTracker::BallTracker(const VisionFrame &frame, CameraInfo *cameraInfo, const FieldTransform &transform, const world::BallModel &ballModel) :
+BallTracker::BallTracker(const VisionFrame &frame, CameraInfo *cameraInfo, const FieldTransform &transform, const world::BallModel &ballModel,
+                         FilterTimings *timings) :
     Filter(frame.time),
     m_lastUpdateTime(frame.time),
     m_cameraInfo(cameraInfo),
+    m_timings(timings),
     m_initTime(frame.time),
+    m_lastBallPos(frame.x, frame.y),
     m_lastFrameTime(0),
     m_confidence(0),
     m_updateFrameCounter(0),
@@ -41,6 +44,7 @@ BallTracker::BallTracker(const BallTracker& previousFilter, qint32 primaryCamera
     Filter(previousFilter.lastUpdate()),
     m_lastUpdateTime(previousFilter.m_lastUpdateTime),
     m_cameraInfo(previousFilter.m_cameraInfo),
+    m_timings(previousFilter.m_timings),
     m_initTime(previousFilter.m_initTime),
     m_lastBallPos(previousFilter.m_lastBallPos),
     m_lastFrameTime(previousFilter.m_lastFrameTime),
@@ -64,8 +68,15 @@ BallTracker::~BallTracker()
 
 int BallTracker::chooseDetection(const std::vector<VisionFrame> &possibleFrames)
 {
-    const int flyFilterChoice = m_flyFilter->chooseDetection(possibleFrames);
-    const int groundFilterChoice = m_groundFilter->chooseDetection(possibleFrames);
+    int flyFilterChoice, groundFilterChoice;
+    {
+        ScopedFilterTiming timing(m_timings, &FilterTimings::flyFilter);
+        flyFilterChoice = m_flyFilter->chooseDetection(possibleFrames);
+    }
+    {
+        ScopedFilterTiming timing(m_timings, &FilterTimings::groundFilter);
+        groundFilterChoice = m_groundFilter->chooseDetection(possibleFrames);
+    }
     debug("accept", flyFilterChoice >= 0 || groundFilterChoice >= 0);
     debug("acceptId", possibleFrames.at(0).cameraId);
     debug("age", std::to_string(initTime()).c_str());
@@ -110,8 +121,14 @@ void BallTracker::update(qint64 time)
             break; // try again later
         }
 
-        m_flyFilter->processVisionFrame(frame);
-        m_groundFilter->processVisionFrame(frame);
+        {
+            ScopedFilterTiming timing(m_timings, &FilterTimings::flyFilter);
+            m_flyFilter->processVisionFrame(frame);
+        }
+        {
+            ScopedFilterTiming timing(m_timings, &FilterTimings::groundFilter);
+            m_groundFilter->processVisionFrame(frame);
+        }
         m_rawMeasurements.append(frame);
 
         m_lastFrameTime = frame.time;
@@ -136,9 +153,11 @@ void BallTracker::get(world::Ball *ball, const FieldTransform &transform, bool r
 
     if (m_flyFilter->isActive()) {
         debug("active", "fly filter");
+        ScopedFilterTiming timing(m_timings, &FilterTimings::flyFilter);
         m_flyFilter->writeBallState(ball, m_lastUpdateTime, robots, lastCameraFrameTime);
     } else {
         debug("active", "ground filter");
+        ScopedFilterTiming timing(m_timings, &FilterTimings::groundFilter);
         m_groundFilter->writeBallState(ball, m_lastUpdateTime, robots, lastCameraFrameTime);
     }
     // the flight tracker does not have a max speed, therefore, the ground tracker max speed is always used
@@ -35,7 +35,8 @@ class DribbleFilter;
 class BallTracker : public Filter
 {
 public:
-    BallTracker(const VisionFrame &frame, CameraInfo* cameraInfo, const FieldTransform &transform, const world::BallModel &ballModel);
+    BallTracker(const VisionFrame &frame, CameraInfo* cameraInfo, const FieldTransform &transform, const world::BallModel &ballModel,
+                FilterTimings *timings);
     BallTracker(const BallTracker& previousFilter, qint32 primaryCamera);
     ~BallTracker() override;
     BallTracker(const BallTracker&) = delete;
@@ -53,6 +54,7 @@ public:
     bool isFlying() const;
     qint64 initTime() const { return m_initTime; }
     double confidence() const { return m_confidence; }
+    const Eigen::Vector2f &lastBallPos() const { return m_lastBallPos; }
     bool isFeasiblyInvisible() const;
 
 #ifdef ENABLE_TRACKING_DEBUG
@@ -72,6 +74,7 @@ private:
     QList<VisionFrame> m_visionFrames;
     QList<VisionFrame> m_rawMeasurements;
     CameraInfo* m_cameraInfo;
+    FilterTimings *m_timings;
     qint64 m_initTime;
     Eigen::Vector2f m_lastBallPos;
     qint64 m_lastFrameTime;
@@ -21,8 +21,20 @@
 #ifndef FILTER_H
 #define FILTER_H
 
+#include "core/timer.h"
 #include <QtGlobal>
 
+// accumulated time in ns spent in the different filter types
+struct FilterTimings
+{
+    bool enabled = false;
+    qint64 robotFilter = 0;
+    qint64 groundFilter = 0;
+    qint64 flyFilter = 0;
+};
+
+using ScopedFilterTiming = ScopedTiming<FilterTimings>;
+
 class Filter
 {
 public:
@@ -25,11 +25,13 @@
 #include "protobuf/command.pb.h"
 #include "protobuf/debug.pb.h"
 #include "protobuf/ssl_detection.pb.h"
+#include "protobuf/status.pb.h"
 #include "protobuf/world.pb.h"
 #include <QMap>
 #include <QPair>
 #include <QByteArray>
 #include <QObject>
+#include <vector>
 
 class BallTracker;
 class RobotFilter;
@@ -42,6 +44,7 @@ class SSL_FieldLineSegment;
 class SSL_GeometryCameraCalibration;
 class WorldParameters;
 struct CameraInfo;
+struct FilterTimings;
 
 class Tracker : public QObject
 {
@@ -64,8 +67,11 @@ public:
 public:
     void process(qint64 currentTime);
     void worldState(world::State *worldState, qint64 currentTime, bool resetRaw);
+    void worldStates(const std::vector<qint64> &times, std::vector<world::State> &worldStates, bool resetRaw);
     bool injectDebugValues(qint64 currentTime, amun::DebugValues *debug);
     void clearDebugValues();
+    // adds the time spent in the filters since the last call to timing
+    void takeFilterTimings(amun::Timing *timing);
 
     void queuePacket(const SSL_DetectionFrame &detection, qint64 time);
     void queueRadioCommands(const QList<robot::RadioCommand> &radio_commands, qint64 time);
@@ -87,12 +93,17 @@ private:
     void trackRobot(RobotMap& robotMap, const SSL_DetectionRobot &robot, qint64 sourceTime, qint32 cameraId, qint64 visionProcessingDelay,
                     bool teamIsYellow);
 
+    void predictWorldStates(const std::vector<qint64> &times, const std::vector<world::State*> &worldStates, bool resetRaw);
+
     BallTracker* bestBallFilter();
     void prioritizeBallFilters();
+    QList<BallTracker*> ballFiltersByPriority() const;
+    void pruneBallFilters();
 
 private:
     typedef QPair<robot::RadioCommand, qint64> RadioCommand;
     CameraInfo * const m_cameraInfo;
+    FilterTimings * const m_filterTimings;
 
     qint64 m_visionTransmissionDelay;
     qint64 m_timeSinceLastReset;
@@ -112,6 +123,13 @@ private:
     QList<BallTracker*> m_ballFilter;
     BallTracker* m_currentBallFilter;
 
+    // ball hypothesis scheduling statistics, reset with the debug values
+    qint64 m_ballUpdateCounter = 0;
+    qint64 m_ballHypothesisTime = 0;
+    int m_ballHypothesisUpdates = 0;
+    int m_skippedBallHypotheses = 0;
+    int m_prunedBallHypotheses = 0;
+
     RobotMap m_robotFilterYellow;
     RobotMap m_robotFilterBlue;
 
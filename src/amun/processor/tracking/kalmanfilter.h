@@ -63,6 +63,12 @@ public:
         }
     }
 
+    // only predicts the state, the covariance is only required for the next update
+    void predictState()
+    {
+        m_xm = F * m_x + u;
+    }
+
     void update()
     {
         VectorM y = z - H * m_xm;
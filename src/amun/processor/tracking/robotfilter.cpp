@@ -193,6 +193,12 @@ void RobotFilter::predict(qint64 time, bool updateFuture, bool permanentUpdate,
         kalman->u(5) = std::max<float>(kalman->u(5), -OMEGA_MAX + omega);
     }
 
+    // temporary predictions are never updated with a vision frame
+    if (!permanentUpdate) {
+        kalman->predictState();
+        return;
+    }
+
     // update covariance jacobian
     kalman->B = kalman->F;
 
@@ -239,13 +245,11 @@ void RobotFilter::predict(qint64 time, bool updateFuture, bool permanentUpdate,
     kalman->Q(5, 2) = G(5) * G(2);
     kalman->Q(5, 5) = G(5) * G(5);
 
-    kalman->predict(permanentUpdate);
-    if (permanentUpdate) {
-        if (updateFuture) {
-            m_futureTime = time;
-        } else {
-            m_lastTime = time;
-        }
+    kalman->predict(true);
+    if (updateFuture) {
+        m_futureTime = time;
+    } else {
+        m_lastTime = time;
     }
 }
 
@@ -30,9 +30,25 @@
 #include "worldparameters.h"
 #include <QDebug>
 #include <limits>
+#include <numeric>
+#include <unordered_set>
+
+// Every ball detection which can not be assigned to an existing filter creates
+// a new ball hypothesis. With many false detections this causes the number of
+// filters and thereby the tracking time to explode. Thus only the most important
+// hypotheses are updated with every frame, while hypotheses with a low confidence
+// are only updated with every LOW_PRIORITY_INTERVAL-th frame. The total number of
+// hypotheses is capped, dropping the least important ones.
+static const int FULL_RATE_BALL_FILTERS = 4;
+static const double LOW_CONFIDENCE = 0.5;
+static const int LOW_PRIORITY_INTERVAL = 3;
+static const int MAX_BALL_FILTERS = 12;
+// unaccepted detections near a skipped hypothesis are given to that hypothesis
+static const float SKIPPED_CLAIM_DISTANCE = 0.3f;
 
 Tracker::Tracker(bool robotsOnly, bool isSpeedTracker, WorldParameters *m_worldParameters) :
     m_cameraInfo(new CameraInfo),
+    m_filterTimings(new FilterTimings),
     m_visionTransmissionDelay(0),
     m_timeSinceLastReset(0),
     m_lastSlowVisionFrame(0),
@@ -50,6 +66,7 @@ Tracker::~Tracker()
 {
     reset();
     delete m_cameraInfo;
+    delete m_filterTimings;
 }
 
 void Tracker::reset()
@@ -140,12 +157,15 @@ void Tracker::process(qint64 currentTime)
             continue;
         }
 
-        for (int i = 0; i < detection.robots_yellow_size(); i++) {
-            trackRobot(m_robotFilterYellow, detection.robots_yellow(i), sourceTime, detection.camera_id(), visionProcessingTime, true);
-        }
+        {
+            ScopedFilterTiming timing(m_filterTimings, &FilterTimings::robotFilter);
+            for (int i = 0; i < detection.robots_yellow_size(); i++) {
+                trackRobot(m_robotFilterYellow, detection.robots_yellow(i), sourceTime, detection.camera_id(), visionProcessingTime, true);
+            }
 
-        for (int i = 0; i < detection.robots_blue_size(); i++) {
-            trackRobot(m_robotFilterBlue, detection.robots_blue(i), sourceTime, detection.camera_id(), visionProcessingTime, false);
+            for (int i = 0; i < detection.robots_blue_size(); i++) {
+                trackRobot(m_robotFilterBlue, detection.robots_blue(i), sourceTime, detection.camera_id(), visionProcessingTime, false);
+            }
         }
 
         if (!m_robotsOnly) {
@@ -235,59 +255,136 @@ BallTracker* Tracker::bestBallFilter()
     return m_currentBallFilter;
 }
 
+QList<BallTracker*> Tracker::ballFiltersByPriority() const
+{
+    // the currently used filter is always the most important one
+    QList<BallTracker*> filters = m_ballFilter;
+    std::stable_sort(filters.begin(), filters.end(), [this](BallTracker *a, BallTracker *b) {
+        if ((a == m_currentBallFilter) != (b == m_currentBallFilter)) {
+            return a == m_currentBallFilter;
+        }
+        return a->confidence() > b->confidence();
+    });
+    return filters;
+}
+
+void Tracker::pruneBallFilters()
+{
+    if (m_ballFilter.size() <= MAX_BALL_FILTERS) {
+        return;
+    }
+    const QList<BallTracker*> filters = ballFiltersByPriority();
+    for (int i = MAX_BALL_FILTERS; i < filters.size(); i++) {
+        m_ballFilter.removeOne(filters[i]);
+        delete filters[i];
+        m_prunedBallHypotheses++;
+    }
+}
+
 void Tracker::worldState(world::State *worldState, qint64 currentTime, bool resetRaw)
+{
+    predictWorldStates({ currentTime }, { worldState }, resetRaw);
+}
+
+/*!
+ * \brief Predicts the world state for multiple points in time at once
+ *
+ * This is equivalent to calling worldState for every time in ascending order,
+ * except that the filters are only selected once for the earliest time. The
+ * robot filters continue from the prediction for the previous time and the
+ * ball filters reuse the motion of their base state, both only predict the
+ * state and skip the covariance, which is only needed to apply vision frames.
+ * Raw data is reset after the prediction for the latest time if resetRaw is set.
+ */
+void Tracker::worldStates(const std::vector<qint64> &times, std::vector<world::State> &worldStates, bool resetRaw)
+{
+    worldStates.resize(times.size());
+    if (times.empty()) {
+        return;
+    }
+
+    std::vector<std::size_t> order(times.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&times](std::size_t a, std::size_t b) { return times[a] < times[b]; });
+
+    std::vector<qint64> sortedTimes;
+    std::vector<world::State*> sortedStates;
+    sortedTimes.reserve(times.size());
+    sortedStates.reserve(times.size());
+    for (std::size_t index : order) {
+        sortedTimes.push_back(times[index]);
+        sortedStates.push_back(&worldStates[index]);
+    }
+    predictWorldStates(sortedTimes, sortedStates, resetRaw);
+}
+
+void Tracker::predictWorldStates(const std::vector<qint64> &times, const std::vector<world::State*> &worldStates, bool resetRaw)
 {
     // only return objects which have been tracked for more than minFrameCount frames
     // if the tracker was reset recently, allow for fast repopulation
-    const int minFrameCount = (currentTime > m_timeSinceLastReset + m_resetTimeout) ? 5: 0;
-
-    // create world state for the given time
-    worldState->set_time(currentTime);
-    worldState->set_vision_transmission_delay(m_visionTransmissionDelay);
+    const int minFrameCount = (times.front() > m_timeSinceLastReset + m_resetTimeout) ? 5: 0;
 
+    BallTracker *ball = nullptr;
     if (!m_robotsOnly) {
-        BallTracker *ball = bestBallFilter();
+        ball = bestBallFilter();
         if (ball != nullptr) {
             m_desiredRobotCamera = ball->primaryCamera();
         }
     }
 
-    QVector<RobotInfo> robotInfos;
-    robotInfos.reserve(m_robotFilterBlue.size() + m_robotFilterYellow.size());
+    QVector<RobotFilter*> yellowRobots, blueRobots;
     for(RobotMap::iterator it = m_robotFilterYellow.begin(); it != m_robotFilterYellow.end(); ++it) {
         RobotFilter *robot = bestFilter(*it, minFrameCount, m_desiredRobotCamera);
         if (robot != nullptr) {
-            robot->update(currentTime);
-            robot->get(worldState->add_yellow(), m_worldParameters->fieldTransform(), false);
-            robotInfos.append(robot->getRobotInfo());
+            yellowRobots.append(robot);
         }
     }
-
     for(RobotMap::iterator it = m_robotFilterBlue.begin(); it != m_robotFilterBlue.end(); ++it) {
         RobotFilter *robot = bestFilter(*it, minFrameCount, m_desiredRobotCamera);
         if (robot != nullptr) {
+            blueRobots.append(robot);
+        }
+    }
+
+    QVector<RobotInfo> robotInfos;
+    robotInfos.reserve(yellowRobots.size() + blueRobots.size());
+    for (std::size_t i = 0; i < times.size(); i++) {
+        const qint64 currentTime = times[i];
+        world::State *worldState = worldStates[i];
+
+        // create world state for the given time
+        worldState->set_time(currentTime);
+        worldState->set_vision_transmission_delay(m_visionTransmissionDelay);
+
+        robotInfos.clear();
+        for (RobotFilter *robot : yellowRobots) {
+            ScopedFilterTiming timing(m_filterTimings, &FilterTimings::robotFilter);
             robot->update(currentTime);
-            robot->get(worldState->add_blue(), m_worldParameters->fieldTransform(), false);
+            robot->get(worldState->add_yellow(), m_worldParameters->fieldTransform(), false);
             robotInfos.append(robot->getRobotInfo());
         }
-    }
 
-    if (!m_robotsOnly) {
-        BallTracker *ball = bestBallFilter();
+        for (RobotFilter *robot : blueRobots) {
+            ScopedFilterTiming timing(m_filterTimings, &FilterTimings::robotFilter);
+            robot->update(currentTime);
+            robot->get(worldState->add_blue(), m_worldParameters->fieldTransform(), false);
+            robotInfos.append(robot->getRobotInfo());
+        }
 
         if (ball != nullptr) {
             ball->update(currentTime);
             const qint64 lastCameraFrameTime = m_lastUpdateTime[ball->primaryCamera()];
-            ball->get(worldState->mutable_ball(), m_worldParameters->fieldTransform(), resetRaw, robotInfos, lastCameraFrameTime);
+            const bool isLast = i + 1 == times.size();
+            ball->get(worldState->mutable_ball(), m_worldParameters->fieldTransform(), resetRaw && isLast, robotInfos, lastCameraFrameTime);
         }
-    }
 
-    if (m_aoiEnabled) {
-        world::TrackingAOI *aoi = worldState->mutable_tracking_aoi();
-        aoi->set_x1(m_aoi.x1());
-        aoi->set_y1(m_aoi.y1());
-        aoi->set_x2(m_aoi.x2());
-        aoi->set_y2(m_aoi.y2());
+        if (m_aoiEnabled) {
+            world::TrackingAOI *aoi = worldState->mutable_tracking_aoi();
+            aoi->set_x1(m_aoi.x1());
+            aoi->set_y1(m_aoi.y1());
+            aoi->set_x2(m_aoi.x2());
+            aoi->set_y2(m_aoi.y2());
+        }
     }
 }
 
@@ -311,10 +408,26 @@ bool Tracker::injectDebugValues(qint64 currentTime, amun::DebugValues *debug)
         log->set_text(message.toStdString());
     }
 
+    // the hypothesis scheduling is reported every frame, so that its load is visible in normal operation
+    const bool hasHypothesisValues = !m_robotsOnly;
+    if (hasHypothesisValues) {
+        auto addValue = [debug](const char *key, float value) {
+            amun::DebugValue *debugValue = debug->add_value();
+            debugValue->set_key(key);
+            debugValue->set_float_value(value);
+        };
+        addValue("ball hypotheses/live", m_ballFilter.size());
+        addValue("ball hypotheses/skipped", m_skippedBallHypotheses);
+        addValue("ball hypotheses/pruned", m_prunedBallHypotheses);
+        if (m_ballHypothesisUpdates > 0) {
+            addValue("ball hypotheses/time per hypothesis (us)", m_ballHypothesisTime * 1E-3f / m_ballHypothesisUpdates);
+        }
+    }
+
 #ifdef ENABLE_TRACKING_DEBUG
     return true;
 #else
-    return m_errorMessages.size() > 0;
+    return m_errorMessages.size() > 0 || hasHypothesisValues;
 #endif
 }
 
@@ -327,6 +440,22 @@ void Tracker::clearDebugValues()
 #endif
 
     m_errorMessages.clear();
+
+    m_ballHypothesisTime = 0;
+    m_ballHypothesisUpdates = 0;
+    m_skippedBallHypotheses = 0;
+    m_prunedBallHypotheses = 0;
+}
+
+void Tracker::takeFilterTimings(amun::Timing *timing)
+{
+    if (!m_filterTimings->enabled) {
+        return;
+    }
+    timing->set_tracking_robot_filter(timing->tracking_robot_filter() + m_filterTimings->robotFilter * 1E-9f);
+    timing->set_tracking_ground_filter(timing->tracking_ground_filter() + m_filterTimings->groundFilter * 1E-9f);
+    timing->set_tracking_fly_filter(timing->tracking_fly_filter() + m_filterTimings->flyFilter * 1E-9f);
+    *m_filterTimings = FilterTimings { true };
 }
 
 void Tracker::updateCamera(const SSL_GeometryCameraCalibration &c, const QString &sender)
@@ -520,10 +649,27 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 source
         return;
     }
 
+    // schedule the ball hypotheses, low priority ones are skipped in most frames
+    m_ballUpdateCounter++;
+    std::unordered_set<BallTracker*> skippedFilters;
+    const QList<BallTracker*> filtersByPriority = ballFiltersByPriority();
+    for (int rank = FULL_RATE_BALL_FILTERS; rank < filtersByPriority.size(); rank++) {
+        BallTracker *filter = filtersByPriority[rank];
+        if (filter->confidence() < LOW_CONFIDENCE && (m_ballUpdateCounter + rank) % LOW_PRIORITY_INTERVAL != 0) {
+            skippedFilters.insert(filter);
+        }
+    }
+    m_skippedBallHypotheses += skippedFilters.size();
+
+    const qint64 hypothesisStart = Timer::systemTime();
     bool detectionWasAccepted = false;
     std::vector<bool> acceptingFilterWithCamId(ballFrames.size(), false);
     std::vector<BallTracker*> acceptingFilterWithOtherCamId(ballFrames.size(), nullptr);
     for (BallTracker *filter : m_ballFilter) {
+        if (skippedFilters.count(filter) > 0) {
+            continue;
+        }
+        m_ballHypothesisUpdates++;
         filter->update(sourceTime);
 
         // from a given vision packet, each filter can only accept one detection,
@@ -543,6 +689,34 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 source
         }
     }
 
+    // a detection which no filter accepted probably belongs to a skipped hypothesis,
+    // update that hypothesis now instead of creating yet another one
+    for (std::size_t i = 0;i<ballFrames.size();i++) {
+        if (acceptingFilterWithCamId[i]) {
+            continue;
+        }
+        const Eigen::Vector2f detectionPos(ballFrames[i].x, ballFrames[i].y);
+        for (BallTracker *filter : filtersByPriority) {
+            if (skippedFilters.count(filter) == 0 || filter->primaryCamera() != cameraId
+                    || (filter->lastBallPos() - detectionPos).norm() >= SKIPPED_CLAIM_DISTANCE) {
+                continue;
+            }
+            // each filter may still only accept one detection per frame
+            skippedFilters.erase(filter);
+            m_skippedBallHypotheses--;
+            m_ballHypothesisUpdates++;
+            filter->update(sourceTime);
+            if (filter->chooseDetection({ ballFrames[i] }) >= 0) {
+                filter->addVisionFrame(ballFrames[i]);
+                acceptingFilterWithCamId[i] = true;
+                detectionWasAccepted = true;
+                break;
+            }
+        }
+    }
+
+    m_ballHypothesisTime += Timer::systemTime() - hypothesisStart;
+
     for (std::size_t i = 0;i<ballFrames.size();i++) {
         if (!acceptingFilterWithCamId[i]) {
             BallTracker* bt;
@@ -551,13 +725,15 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 source
                 bt = new BallTracker(*acceptingFilterWithOtherCamId[i], cameraId);
             } else {
                 // create new Ball Filter without initial movement
-                bt = new BallTracker(ballFrames[i], m_cameraInfo, m_worldParameters->fieldTransform(), m_ballModel);
+                bt = new BallTracker(ballFrames[i], m_cameraInfo, m_worldParameters->fieldTransform(), m_ballModel, m_filterTimings);
             }
             m_ballFilter.append(bt);
             bt->addVisionFrame(ballFrames[i]);
         }
     }
 
+    pruneBallFilters();
+
     if (detectionWasAccepted) {
         // only prioritize when at least one detection was accepted
         prioritizeBallFilters();
@@ -670,6 +846,10 @@ void Tracker::handleCommand(const amun::CommandTracking &command, qint64 time)
         m_visionTransmissionDelay = command.vision_transmission_delay();
     }
 
+    if (command.has_measure_filter_timing()) {
+        *m_filterTimings = FilterTimings { command.measure_filter_timing() };
+    }
+
     // allows resetting by the strategy
     if (command.reset()) {
         m_timeToReset = time;
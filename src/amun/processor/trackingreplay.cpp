@@ -24,11 +24,43 @@
 
 static const QString SENDER_NAME_FOR_REFEREE = "TrackingReplay";
 
+// the cost of a cached result is its serialized size, limit the cache to about 64 MiB of it
+static const int STATUS_CACHE_SIZE = 64 * 1024 * 1024;
+
+// 64 bit FNV-1a hash step over the bytes of value
+static void hashValue(quint64 &hash, quint64 value)
+{
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (8 * i)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+}
+
+// identifies a log packet without serializing it, the time alone is not unique
+static quint64 statusIdentifier(const amun::Status &status)
+{
+    quint64 hash = 14695981039346656037ULL;
+    hashValue(hash, status.time());
+    hashValue(hash, status.ByteSize());
+    hashValue(hash, status.radio_command_size());
+    if (status.has_world_state()) {
+        const world::State &worldState = status.world_state();
+        hashValue(hash, worldState.time());
+        for (const auto &vision : worldState.vision_frames()) {
+            if (vision.has_detection()) {
+                hashValue(hash, vision.detection().camera_id());
+                hashValue(hash, vision.detection().frame_number());
+            }
+        }
+    }
+    return hash;
+}
+
 TrackingReplay::TrackingReplay(Timer *timer) :
     m_timer(timer),
     m_replayProcessor(timer, true),
     m_refereeExtractor(timer->currentTime()),
-    m_statusCache(2000)
+    m_statusCache(STATUS_CACHE_SIZE)
 {
     connect(&m_replayProcessor, &Processor::sendStatus, this, &TrackingReplay::ammendStatus);
 
@@ -55,26 +87,28 @@ void TrackingReplay::ammendStatus(const Status &status)
         // add game state information since the replay processor does not have the required data
         status->mutable_game_state()->CopyFrom(m_lastTrackingReplayGameState->game_state());
     }
-    // yes, I also do not want to use smart pointers like this
-    m_statusCache.insert(m_currentPacketString, new Status(status));
+    m_statusCache.insert(m_currentPacketIdentifier, new Status(status), status->ByteSize());
     emit gotStatus(status);
 }
 
+void TrackingReplay::handleCommand(const Command &command)
+{
+    m_replayProcessor.handleCommand(command);
+}
+
 void TrackingReplay::handleStatus(const Status &status)
 {
     const auto previousTime = m_timer->currentTime();
     m_timer->setTime(status->time(), 0);
 
-    // the time does not uniquely identify a status packet, therefore use its full string as identifier
-    // performance is not really a concern here, therefore serializing and hashing string is acceptable
-    const QString identifier = QString::fromStdString(status->SerializeAsString());
-    Status *cached = m_statusCache.object(identifier);
+    const quint64 identifier = statusIdentifier(*status);
+    const Status *cached = m_statusCache.object(identifier);
     if (cached != nullptr) {
-        emit gotStatus(Status(*cached));
+        emit gotStatus(*cached);
         return;
     }
     // since ammendStatus is called synchrenously, this is fine if a bit inelegant
-    m_currentPacketString = identifier;
+    m_currentPacketIdentifier = identifier;
 
     if (status->has_game_state()) {
         m_lastTrackingReplayGameState = status;
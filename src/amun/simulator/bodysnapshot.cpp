@@ -0,0 +1,60 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "bodysnapshot.h"
+
+using namespace camun::simulator;
+
+void BodySnapshot::save(const btRigidBody *body)
+{
+    transform = body->getWorldTransform();
+    interpolationTransform = body->getInterpolationWorldTransform();
+    motionStateTransform = transform;
+    if (body->getMotionState()) {
+        body->getMotionState()->getWorldTransform(motionStateTransform);
+    }
+    linearVelocity = body->getLinearVelocity();
+    angularVelocity = body->getAngularVelocity();
+    interpolationLinearVelocity = body->getInterpolationLinearVelocity();
+    interpolationAngularVelocity = body->getInterpolationAngularVelocity();
+    linearDamping = body->getLinearDamping();
+    angularDamping = body->getAngularDamping();
+    deactivationTime = body->getDeactivationTime();
+    activationState = body->getActivationState();
+}
+
+void BodySnapshot::restore(btRigidBody *body) const
+{
+    body->setWorldTransform(transform);
+    body->setInterpolationWorldTransform(interpolationTransform);
+    if (body->getMotionState()) {
+        body->getMotionState()->setWorldTransform(motionStateTransform);
+    }
+    body->setLinearVelocity(linearVelocity);
+    body->setAngularVelocity(angularVelocity);
+    body->setInterpolationLinearVelocity(interpolationLinearVelocity);
+    body->setInterpolationAngularVelocity(interpolationAngularVelocity);
+    body->setDamping(linearDamping, angularDamping);
+    body->setDeactivationTime(deactivationTime);
+    body->forceActivationState(activationState);
+    body->clearForces();
+    // the world space inertia depends on the orientation
+    body->updateInertiaTensor();
+}
@@ -0,0 +1,51 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef BODYSNAPSHOT_H
+#define BODYSNAPSHOT_H
+
+#include <btBulletDynamicsCommon.h>
+
+namespace camun {
+    namespace simulator {
+        struct BodySnapshot;
+    }
+}
+
+// complete dynamic state of a single rigid body
+struct camun::simulator::BodySnapshot
+{
+    void save(const btRigidBody *body);
+    void restore(btRigidBody *body) const;
+
+    btTransform transform;
+    btTransform interpolationTransform;
+    btTransform motionStateTransform;
+    btVector3 linearVelocity;
+    btVector3 angularVelocity;
+    btVector3 interpolationLinearVelocity;
+    btVector3 interpolationAngularVelocity;
+    btScalar linearDamping;
+    btScalar angularDamping;
+    btScalar deactivationTime;
+    int activationState;
+};
+
+#endif // BODYSNAPSHOT_H
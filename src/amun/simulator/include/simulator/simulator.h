@@ -24,13 +24,17 @@
 #include "protobuf/command.h"
 #include "protobuf/status.h"
 #include "protobuf/sslsim.h"
+#include "protobuf/visionframe.h"
 #include <QList>
 #include <QMap>
 #include <QPair>
 #include <QQueue>
 #include <QByteArray>
+#include <QVector>
+#include <memory>
 #include <tuple>
 #include <random>
+#include <vector>
 
 // higher values break the rolling friction of the ball
 const float SIMULATOR_SCALE = 10.0f;
@@ -49,6 +53,7 @@ namespace camun {
         class Simulator;
         class ErrorAggregator;
         struct SimulatorData;
+        struct SimulatorSnapshot;
 
         enum class ErrorSource {
             BLUE,
@@ -71,9 +76,26 @@ public:
     Simulator& operator=(const Simulator&) = delete;
     void handleSimulatorTick(double timeStep);
     void seedPRGN(uint32_t seed);
+    // Captures the simulation state, that is the physics bodies, the robot and ball state,
+    // the random number generators, queued radio commands and pending vision packets.
+    // The configuration (geometry, realism settings, flip) is not included, neither are the
+    // contact caches of the physics engine. Thus every restore of a snapshot continues identically,
+    // but may differ slightly from the run in which the checkpoint was taken.
+    // A snapshot can be restored any number of times, also into a different simulator
+    // created with the same setup. The timer has to be reset to the time of the checkpoint by the caller,
+    // in realtime mode before calling restore, as the pending vision packets are rescheduled based on it.
+    std::shared_ptr<const SimulatorSnapshot> checkpoint() const;
+    void restore(const SimulatorSnapshot &snapshot);
+    // hand out the vision frames via gotVisionFrame instead of serializing them for
+    // gotPacket and sendRealData, only usable if the receiver lives in the same process
+    void setVisionFrameOutput(bool enabled) { m_visionFrameOutput = enabled; }
+    // applies a new geometry and camera setup, only the field is rebuilt if the geometry changed.
+    // Ball and robots keep their state. Also used for CommandSimulator.simulator_setup
+    void setSetup(const amun::SimulatorSetup &setup);
 
 signals:
     void gotPacket(const QByteArray &data, qint64 time, QString sender);
+    void gotVisionFrame(const SimulatorVisionFramePtr &frame, qint64 time);
     void sendStatus(const Status &status);
     void sendRadioResponses(const QList<robot::RadioResponse> &responses);
     void sendRealData(const QByteArray& data); // sends amun::SimulatorState
@@ -90,12 +112,21 @@ public slots:
     void process();
 
 private slots:
-    void sendVisionPacket();
+    void sendDueVisionPackets();
 
 private:
     void sendSSLSimErrorInternal(ErrorSource source);
+    void stepSimplifiedPhysics(double timeDelta);
+    void setCameraSetup(const google::protobuf::RepeatedPtrField<SSL_GeometryCameraCalibration> &cameras);
     void resetFlipped(RobotMap &robots, float side);
-    std::tuple<QList<QByteArray>, QByteArray, qint64> createVisionPacket();
+    // vision frame and the time at which it is sent
+    typedef std::tuple<SimulatorVisionFramePtr, qint64> VisionPacket;
+    std::shared_ptr<SimulatorVisionFrame> acquireVisionFrame();
+    SimulatorVisionFramePtr createVisionPacket();
+    void queueVisionPacket(const VisionPacket &packet);
+    void scheduleVisionTimer();
+    void sendVisionPacket();
+    void serializeVisionFrame(const SimulatorVisionFrame &frame);
     void resetVisionPackets();
     void setTeam(RobotMap &list, float side, const robot::Team &team, QMap<uint32_t, robot::Specs>& specs);
     void moveBall(const sslsim::TeleportBall &ball);
@@ -107,8 +138,18 @@ private:
     typedef std::tuple<SSLSimRobotControl, qint64, bool> RadioCommand;
     SimulatorData *m_data;
     QQueue<RadioCommand> m_radioCommands;
-    QQueue<std::tuple<QList<QByteArray>, QByteArray, qint64>> m_visionPackets;
-    QQueue<QTimer *> m_visionTimers;
+    QQueue<VisionPacket> m_visionPackets;
+    QTimer *m_visionTimer;
+    bool m_visionFrameOutput = false;
+    // frames are reused once they are neither queued nor held by a receiver
+    std::vector<std::shared_ptr<SimulatorVisionFrame>> m_visionFramePool;
+    // reused serialization buffers, only reallocated if a receiver still holds the previous content
+    QVector<QByteArray> m_visionBuffers;
+    QByteArray m_simulatorStateBuffer;
+    // time spent creating and serializing vision packets since the last status
+    qint64 m_visionEncodeTime = 0;
+    // time spent applying team, geometry and camera changes since the last status
+    qint64 m_reconfigureTime = 0;
     bool m_isPartial;
     const Timer *m_timer;
     QTimer *m_trigger;
@@ -120,6 +161,10 @@ private:
     // systemDelay + visionProcessingTime = visionDelay
     qint64 m_visionDelay;
     qint64 m_visionProcessingTime;
+    // deviation of the actual from the intended vision send time since the last status
+    qint64 m_visionJitterSum = 0;
+    qint64 m_visionJitterMax = 0;
+    int m_visionJitterCount = 0;
 
     qint64 m_minRobotDetectionTime = 0;
     qint64 m_minBallDetectionTime = 0;
@@ -20,6 +20,7 @@
 
 #include "simball.h"
 #include "simulator.h"
+#include "simplifiedphysics.h"
 #include "core/rng.h"
 #include "core/coordinates.h"
 #include "core/vector.h"
@@ -81,15 +82,18 @@ void SimBall::begin()
             // just apply rolling friction, normal friction is somehow handled by bullet
             // this is quite a hack as it's always applied
             // but as the strong deceleration is more or less magic, some additional deceleration doesn't matter
-            const btScalar hackFactor = 1.4;
-            const btScalar rollingDeceleration = hackFactor * 0.35;
+            const btScalar rollingDeceleration = BALL_ROLLING_FRICTION_FACTOR * 0.35;
             btVector3 force(velocity.x(), velocity.y(), 0.0f);
             force.safeNormalize();
             m_body->applyCentralImpulse(-force * rollingDeceleration * SIMULATOR_SCALE * BALL_MASS * SUB_TIMESTEP);
         }
     }
 
+    handleMoveCommand();
+}
 
+void SimBall::handleMoveCommand()
+{
     bool moveCommand = false;
     auto sendPartialCoordError = [this](const char* msg){
         SSLSimError error{new sslsim::SimulatorError};
@@ -172,6 +176,72 @@ void SimBall::begin()
     }
 }
 
+world::BallModel SimBall::ballModel(const world::Geometry &geometry)
+{
+    world::BallModel model;
+    model.set_fast_deceleration(3.9f);
+    model.set_slow_deceleration(0.35f);
+    model.set_switch_ratio(0.69f);
+    model.set_z_damping(0.566f);
+    model.set_xy_damping(0.715f);
+    model.MergeFrom(geometry.ball_model());
+    return model;
+}
+
+void SimBall::stepSimplified(float timeStep, const world::BallModel &ballModel)
+{
+    // teleports directly modify the body, moving by force applies an impulse and sets a damping
+    handleMoveCommand();
+
+    // the rolling friction is scaled like in begin() to match the full simulation
+    const float slidingDeceleration = ballModel.fast_deceleration();
+    const float rollingDeceleration = BALL_ROLLING_FRICTION_FACTOR * ballModel.slow_deceleration();
+    const float bounceDampingZ = ballModel.z_damping();
+    const float gravity = 9.81f;
+
+    btVector3 p = m_body->getWorldTransform().getOrigin() / SIMULATOR_SCALE;
+    btVector3 v = m_body->getLinearVelocity() / SIMULATOR_SCALE;
+    btVector3 w = m_body->getAngularVelocity();
+    v *= std::pow(1 - m_body->getLinearDamping(), timeStep);
+
+    const bool onGround = p.z() <= BALL_RADIUS * 1.1f && v.z() < 0.1f;
+    if (onGround) {
+        p.setZ(BALL_RADIUS);
+        v.setZ(0);
+        // velocity of the contact point relative to the floor, zero while rolling
+        const btVector3 slip(v.x() - BALL_RADIUS * w.y(), v.y() + BALL_RADIUS * w.x(), 0);
+        // for a solid sphere the friction reduces the slip 3.5 times as fast as the linear velocity
+        const float slipReduction = 3.5f * slidingDeceleration * timeStep;
+        if (slip.length() > slipReduction) {
+            const btVector3 a = -slip.normalized() * slidingDeceleration;
+            v += a * timeStep;
+            w += btVector3(a.y(), -a.x(), 0) * (2.5f / BALL_RADIUS * timeStep);
+        } else {
+            // rolling without slip
+            v -= slip * (2.0f / 7.0f);
+            const float speed = v.length();
+            if (speed < 0.01f || speed < rollingDeceleration * timeStep) {
+                // -> the real ball snaps to a dimple
+                v.setZero();
+            } else {
+                v *= (speed - rollingDeceleration * timeStep) / speed;
+            }
+            w = btVector3(-v.y(), v.x(), 0) / BALL_RADIUS;
+        }
+        p += v * timeStep;
+    } else {
+        v.setZ(v.z() - gravity * timeStep);
+        p += v * timeStep;
+        if (p.z() < BALL_RADIUS) {
+            p.setZ(BALL_RADIUS);
+            v.setZ(-v.z() * bounceDampingZ);
+        }
+    }
+
+    setKinematicBodyState(m_body, btTransform(m_body->getWorldTransform().getRotation(), p * SIMULATOR_SCALE),
+                          v * SIMULATOR_SCALE, w);
+}
+
 // samples a plane rotated towards the camera, sets p to the average position of the visible points and returns the relative amount of visible pixels
 static float positionOfVisiblePixels(btVector3& p, const btVector3& simulatorBallPosition, const btVector3& simulatorCameraPosition, const btCollisionWorld* const m_world)
 {
@@ -311,6 +381,17 @@ btVector3 SimBall::speed() const
     return m_body->getLinearVelocity();
 }
 
+btVector3 SimBall::fullPosition() const
+{
+    return m_body->getWorldTransform().getOrigin();
+}
+
+void SimBall::setSimplifiedState(const btVector3 &position, const btVector3 &velocity)
+{
+    setKinematicBodyState(m_body, btTransform(m_body->getWorldTransform().getRotation(), position),
+                          velocity, m_body->getAngularVelocity());
+}
+
 void SimBall::writeBallState(world::SimBall *ball) const
 {
     const btVector3 ballPosition = m_body->getWorldTransform().getOrigin() / SIMULATOR_SCALE;
@@ -337,6 +418,18 @@ void SimBall::restoreState(const world::SimBall &ball)
     m_body->setAngularVelocity(angular);
 }
 
+void SimBall::saveSnapshot(Snapshot *snapshot) const
+{
+    snapshot->body.save(m_body);
+    snapshot->move = m_move;
+}
+
+void SimBall::restoreSnapshot(const Snapshot &snapshot)
+{
+    snapshot.body.restore(m_body);
+    m_move = snapshot.move;
+}
+
 bool SimBall::isInvalid() const
 {
     const btTransform transform = m_body->getWorldTransform();
@@ -25,11 +25,14 @@
 #include "protobuf/sslsim.h"
 #include <btBulletDynamicsCommon.h>
 #include "simfield.h"
+#include "bodysnapshot.h"
 #include <QObject>
 
 static const float BALL_RADIUS = 0.0215f;
 static const float BALL_MASS = 0.046f;
 static const float BALL_DECELERATION = 0.5f;
+// bullet alone underestimates the rolling friction, it is scaled by this factor, see SimBall::begin
+static const float BALL_ROLLING_FRICTION_FACTOR = 1.4f;
 
 class RNG;
 class SSL_DetectionBall;
@@ -50,11 +53,21 @@ public:
     SimBall(const SimBall&) = delete;
     SimBall& operator=(const SimBall&) = delete;
 
+    struct Snapshot
+    {
+        BodySnapshot body;
+        sslsim::TeleportBall move;
+    };
+
 signals:
     void sendSSLSimError(const SSLSimError& error, ErrorSource s);
 
 public:
     void begin();
+    // replaces begin and the physics step when using the simplified physics
+    void stepSimplified(float timeStep, const world::BallModel &ballModel);
+    // the ball model of the geometry, unset values are filled with the ones of the simulated ball
+    static world::BallModel ballModel(const world::Geometry &geometry);
     bool update(SSL_DetectionBall *ball, float stddev, float stddevArea, const btVector3 &cameraPosition,
                bool enableInvisibleBall, float visibilityThreshold, btVector3 positionOffset);
     void move(const sslsim::TeleportBall &ball);
@@ -62,8 +75,14 @@ public:
     // returns the ball position projected onto the floor (z component is not included)
     btVector3 position() const;
     btVector3 speed() const;
+    // position including the height, in simulator coordinates
+    btVector3 fullPosition() const;
+    // keeps the spin of the ball, used to resolve collisions of the simplified physics
+    void setSimplifiedState(const btVector3 &position, const btVector3 &velocity);
     void writeBallState(world::SimBall *ball) const;
     void restoreState(const world::SimBall &ball);
+    void saveSnapshot(Snapshot *snapshot) const;
+    void restoreSnapshot(const Snapshot &snapshot);
     btRigidBody *body() const { return m_body; }
     bool isInvalid() const;
 
@@ -71,6 +90,9 @@ public:
     bool addDetection(SSL_DetectionBall *ball, btVector3 pos, float stddev, float stddevArea, const btVector3 &cameraPosition,
                       bool enableInvisibleBall, float visibilityThreshold, btVector3 positionOffset);
 
+private:
+    void handleMoveCommand();
+
 private:
     RNG *m_rng;
     btDiscreteDynamicsWorld *m_world;
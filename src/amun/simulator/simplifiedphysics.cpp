@@ -0,0 +1,209 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "simplifiedphysics.h"
+#include "simball.h"
+#include "simrobot.h"
+#include "simulator.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace camun::simulator;
+
+// restitution of the field boundary and the goal walls combined with the ball, see SimField
+static const float WALL_RESTITUTION = 0.3f;
+// restitution of the robot body and the dribbler combined with the ball, see SimRobot
+static const float ROBOT_RESTITUTION = 0.6f;
+static const float DRIBBLER_RESTITUTION = 0.2f;
+
+static btVector3 withHeight(btVector3 position, btScalar height)
+{
+    position.setZ(height);
+    return position;
+}
+
+void camun::simulator::setKinematicBodyState(btRigidBody *body, const btTransform &transform, const btVector3 &linearVelocity, const btVector3 &angularVelocity)
+{
+    body->setWorldTransform(transform);
+    body->setInterpolationWorldTransform(transform);
+    body->getMotionState()->setWorldTransform(transform);
+    body->setLinearVelocity(linearVelocity);
+    body->setAngularVelocity(angularVelocity);
+    body->setInterpolationLinearVelocity(linearVelocity);
+    body->setInterpolationAngularVelocity(angularVelocity);
+}
+
+SimplifiedPhysics::SimplifiedPhysics(const world::Geometry &geometry)
+{
+    m_boundaryX = (geometry.field_width() / 2.0f + geometry.boundary_width()) * SIMULATOR_SCALE;
+    m_boundaryY = (geometry.field_height() / 2.0f + geometry.boundary_width()) * SIMULATOR_SCALE;
+    // if the game is played without boundary area the goal stands on the outside of the line
+    const float lineWidthOffset = geometry.boundary_width() != 0.0f ? 0.0f : geometry.line_width() * 0.5f;
+    const float goalLine = geometry.field_height() / 2.0f - geometry.line_width() + lineWidthOffset;
+    m_goalLineY = goalLine * SIMULATOR_SCALE;
+    m_goalBackY = (goalLine + geometry.goal_depth()) * SIMULATOR_SCALE;
+    m_goalInnerX = geometry.goal_width() / 2.0f * SIMULATOR_SCALE;
+    m_goalHeight = geometry.goal_height() * SIMULATOR_SCALE;
+    m_ballModel = SimBall::ballModel(geometry);
+}
+
+void SimplifiedPhysics::step(SimBall *ball, const QList<SimRobot*> &robots, float timeStep) const
+{
+    ball->stepSimplified(timeStep, m_ballModel);
+    for (SimRobot *robot : robots) {
+        robot->stepSimplified(ball, timeStep);
+    }
+
+    for (int i = 0; i < robots.size(); i++) {
+        for (int j = i + 1; j < robots.size(); j++) {
+            collideRobots(robots[i], robots[j]);
+        }
+        collideRobotWithField(robots[i]);
+    }
+    for (const SimRobot *robot : robots) {
+        collideBallWithRobot(ball, robot);
+    }
+    collideBallWithField(ball);
+}
+
+void SimplifiedPhysics::collideRobots(SimRobot *a, SimRobot *b) const
+{
+    btVector3 distance = b->position() - a->position();
+    const float minDistance = (a->specs().radius() + b->specs().radius()) * SIMULATOR_SCALE;
+    const float length = distance.length();
+    if (length >= minDistance || length == 0) {
+        return;
+    }
+    const btVector3 normal = distance / length;
+    const btVector3 correction = normal * (0.5f * (minDistance - length));
+
+    // fully inelastic collision of two robots with equal mass
+    btVector3 velocityA = a->velocity();
+    btVector3 velocityB = b->velocity();
+    const float approach = (velocityA - velocityB).dot(normal);
+    if (approach > 0) {
+        velocityA -= normal * (0.5f * approach);
+        velocityB += normal * (0.5f * approach);
+    }
+
+    a->setSimplifiedState(withHeight(a->position() - correction, a->transform().getOrigin().z()), velocityA);
+    b->setSimplifiedState(withHeight(b->position() + correction, b->transform().getOrigin().z()), velocityB);
+}
+
+void SimplifiedPhysics::collideRobotWithField(SimRobot *robot) const
+{
+    const float radius = robot->specs().radius() * SIMULATOR_SCALE;
+    btVector3 position = robot->transform().getOrigin();
+    btVector3 velocity = robot->velocity();
+    bool collided = false;
+    for (int axis : {0, 1}) {
+        const float limit = (axis == 0 ? m_boundaryX : m_boundaryY) - radius;
+        if (std::abs(position[axis]) > limit) {
+            const float side = position[axis] > 0 ? 1.0f : -1.0f;
+            position[axis] = side * limit;
+            if (velocity[axis] * side > 0) {
+                velocity[axis] = 0;
+            }
+            collided = true;
+        }
+    }
+    if (collided) {
+        robot->setSimplifiedState(position, velocity);
+    }
+}
+
+void SimplifiedPhysics::collideBallWithRobot(SimBall *ball, const SimRobot *robot) const
+{
+    const btVector3 ballPosition = ball->fullPosition();
+    const btTransform &transform = robot->transform();
+    if (ballPosition.z() > robot->specs().height() * SIMULATOR_SCALE) {
+        return;
+    }
+
+    // the robot is a circle with a flat front at the dribbler
+    const btVector3 local = transform.inverse() * ballPosition / SIMULATOR_SCALE;
+    const float radius = robot->specs().radius();
+    const float frontHalfWidth = radius * std::sin(robot->specs().angle() / 2.0f);
+
+    btVector3 localNormal;
+    float penetration;
+    float restitution;
+    if (local.y() > 0 && std::abs(local.x()) < frontHalfWidth) {
+        localNormal = btVector3(0, 1, 0);
+        penetration = robot->specs().shoot_radius() + BALL_RADIUS - local.y();
+        restitution = DRIBBLER_RESTITUTION;
+    } else {
+        const float distance = btVector3(local.x(), local.y(), 0).length();
+        if (distance == 0) {
+            return;
+        }
+        localNormal = btVector3(local.x(), local.y(), 0) / distance;
+        penetration = radius + BALL_RADIUS - distance;
+        restitution = ROBOT_RESTITUTION;
+    }
+    if (penetration <= 0) {
+        return;
+    }
+
+    btTransform rotation = transform;
+    rotation.setOrigin(btVector3(0, 0, 0));
+    const btVector3 normal = rotation * localNormal;
+
+    // velocity of the robot surface at the contact point
+    const btVector3 lever = ballPosition - transform.getOrigin();
+    const float omega = robot->angularVelocity().z();
+    const btVector3 surfaceVelocity = robot->velocity() + btVector3(-omega * lever.y(), omega * lever.x(), 0);
+
+    btVector3 velocity = ball->speed();
+    const float approach = (velocity - surfaceVelocity).dot(normal);
+    if (approach < 0) {
+        velocity -= normal * ((1 + restitution) * approach);
+    }
+    ball->setSimplifiedState(ballPosition + normal * (penetration * SIMULATOR_SCALE), velocity);
+}
+
+void SimplifiedPhysics::collideBallWithField(SimBall *ball) const
+{
+    const float radius = BALL_RADIUS * SIMULATOR_SCALE;
+    btVector3 position = ball->fullPosition();
+    btVector3 velocity = ball->speed();
+
+    // inside of the goal only the goal walls are relevant
+    const bool inGoal = std::abs(position.y()) > m_goalLineY && std::abs(position.x()) < m_goalInnerX
+            && position.z() < m_goalHeight;
+    const float limitX = (inGoal ? m_goalInnerX : m_boundaryX) - radius;
+    const float limitY = (inGoal ? std::min(m_goalBackY, m_boundaryY) : m_boundaryY) - radius;
+
+    bool collided = false;
+    for (int axis : {0, 1}) {
+        const float limit = axis == 0 ? limitX : limitY;
+        if (std::abs(position[axis]) > limit) {
+            const float side = position[axis] > 0 ? 1.0f : -1.0f;
+            position[axis] = side * limit;
+            if (velocity[axis] * side > 0) {
+                velocity[axis] = -velocity[axis] * WALL_RESTITUTION;
+            }
+            collided = true;
+        }
+    }
+    if (collided) {
+        ball->setSimplifiedState(position, velocity);
+    }
+}
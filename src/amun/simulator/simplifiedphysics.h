@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef SIMPLIFIEDPHYSICS_H
+#define SIMPLIFIEDPHYSICS_H
+
+#include "protobuf/world.pb.h"
+#include <QList>
+#include <btBulletDynamicsCommon.h>
+
+namespace camun {
+    namespace simulator {
+        class SimBall;
+        class SimRobot;
+        class SimplifiedPhysics;
+
+        // moves a body without a simulation step, also updates the motion state which is used for the vision
+        void setKinematicBodyState(btRigidBody *body, const btTransform &transform, const btVector3 &linearVelocity, const btVector3 &angularVelocity);
+    }
+}
+
+/*!
+ * \brief Simplified 2.5D replacement for the rigid body simulation
+ *
+ * Robots are moved kinematically with the acceleration limits from their specs,
+ * the ball slides, rolls and flies according to an analytic model. Collisions are only
+ * computed between circles (the robots have a flat front) and the field boundary and goals.
+ * The bullet bodies are still used to store the state, thus vision, snapshots and
+ * teleporting work the same as with the full simulation.
+ */
+class camun::simulator::SimplifiedPhysics
+{
+public:
+    explicit SimplifiedPhysics(const world::Geometry &geometry);
+
+    void step(SimBall *ball, const QList<SimRobot*> &robots, float timeStep) const;
+
+private:
+    void collideRobots(SimRobot *a, SimRobot *b) const;
+    void collideBallWithRobot(SimBall *ball, const SimRobot *robot) const;
+    void collideBallWithField(SimBall *ball) const;
+    void collideRobotWithField(SimRobot *robot) const;
+
+private:
+    // all in simulator coordinates
+    float m_boundaryX;
+    float m_boundaryY;
+    float m_goalLineY;
+    float m_goalInnerX;
+    float m_goalBackY;
+    float m_goalHeight;
+    world::BallModel m_ballModel;
+};
+
+#endif // SIMPLIFIEDPHYSICS_H
@@ -25,6 +25,7 @@
 #include "simball.h"
 #include "simrobot.h"
 #include "simulator.h"
+#include "simplifiedphysics.h"
 #include <cmath>
 #include <QDebug>
 
@@ -156,25 +157,9 @@ void SimRobot::dribble(SimBall *ball, float speed)
 {
     if (m_perfectDribbler) {
         if (canKickBall(ball) && !m_holdBallConstraint) {
-            btVector3 localA, localB;
-            localB.setZero();
-
             const auto robotWorldTransform = m_body->getWorldTransform();
             const auto worldToRobot = robotWorldTransform.inverse();
-            localA = worldToRobot * ball->position();
-
-            m_holdBallConstraint.reset(new btPoint2PointConstraint(*m_body, *ball->body(), localA, localB));
-            m_world->addConstraint(m_holdBallConstraint.get(), true);
-
-            // add a constraint to prevent the robot from tipping over
-            // previously it was common for one robot tipping over if both had the dribbling constraint
-            // this is an ugly hack, but then again so is this the holdBallConstraint
-            m_notTipOverConstraint.reset(new btGeneric6DofSpring2Constraint(*m_body, robotWorldTransform));
-            m_notTipOverConstraint->setAngularLowerLimit(btVector3(0,0,1));
-            m_notTipOverConstraint->setAngularUpperLimit(btVector3(0,0,0));
-            m_notTipOverConstraint->setLinearLowerLimit(btVector3(1,1,1));
-            m_notTipOverConstraint->setLinearUpperLimit(btVector3(0,0,0));
-            m_world->addConstraint(m_notTipOverConstraint.get(),true);
+            holdBall(ball, worldToRobot * ball->position(), robotWorldTransform);
         }
     } else {
         // unit for rotation is  (rad / s) in bullet, but (rpm) in sslCommand
@@ -186,6 +171,25 @@ void SimRobot::dribble(SimBall *ball, float speed)
     }
 }
 
+void SimRobot::holdBall(SimBall *ball, const btVector3 &pivot, const btTransform &robotTransform)
+{
+    btVector3 localB;
+    localB.setZero();
+
+    m_holdBallConstraint.reset(new btPoint2PointConstraint(*m_body, *ball->body(), pivot, localB));
+    m_world->addConstraint(m_holdBallConstraint.get(), true);
+
+    // add a constraint to prevent the robot from tipping over
+    // previously it was common for one robot tipping over if both had the dribbling constraint
+    // this is an ugly hack, but then again so is this the holdBallConstraint
+    m_notTipOverConstraint.reset(new btGeneric6DofSpring2Constraint(*m_body, robotTransform));
+    m_notTipOverConstraint->setAngularLowerLimit(btVector3(0,0,1));
+    m_notTipOverConstraint->setAngularUpperLimit(btVector3(0,0,0));
+    m_notTipOverConstraint->setLinearLowerLimit(btVector3(1,1,1));
+    m_notTipOverConstraint->setLinearUpperLimit(btVector3(0,0,0));
+    m_world->addConstraint(m_notTipOverConstraint.get(),true);
+}
+
 void SimRobot::stopDribbling()
 {
     m_dribblerConstraint->enableAngularMotor(false, 0, 0);
@@ -323,7 +327,7 @@ bool SimRobot::handleMoveCommand()
     return false;
 }
 
-void SimRobot::begin(SimBall *ball, double time)
+void SimRobot::handleCommandTimeout(double time)
 {
     m_commandTime += time;
     m_inStandby = false;
@@ -335,23 +339,10 @@ void SimRobot::begin(SimBall *ball, double time)
         // the real robot switches to standby after a short delay
         m_inStandby = true;
     }
+}
 
-    // enable dribbler if necessary
-    if (!m_inStandby && m_sslCommand.has_dribbler_speed() && m_sslCommand.dribbler_speed() > 0) {
-        dribble(ball, m_sslCommand.dribbler_speed());
-    } else {
-        stopDribbling();
-    }
-
-    if (handleMoveCommand()) {
-        return;
-    }
-
-    m_body->setDamping(0.7, 0.8);
-
-    btTransform t = m_body->getWorldTransform();
-    t.setOrigin(btVector3(0,0,0));
-
+void SimRobot::updateCharge(double time)
+{
     // charge kicker only if enabled
     if (!m_inStandby && m_charge) {
         m_shootTime += time;
@@ -363,36 +354,71 @@ void SimRobot::begin(SimBall *ball, double time)
         m_isCharged = false;
         m_shootTime = 0.0;
     }
-    // check if should kick and can do that
-    if (m_isCharged && m_sslCommand.has_kick_speed() && m_sslCommand.kick_speed() > 0 && canKickBall(ball)) {
-        float power = 0.0;
-        const float angle = m_sslCommand.kick_angle()/180*M_PI;
-        const float dirFloor = std::cos(angle);
-        const float dirUp = std::sin(angle);
+}
 
-        stopDribbling();
+bool SimRobot::wantsToKick() const
+{
+    return m_isCharged && m_sslCommand.has_kick_speed() && m_sslCommand.kick_speed() > 0;
+}
+
+btVector3 SimRobot::kickVelocity(SimBall *ball) const
+{
+    btTransform t = m_body->getWorldTransform();
+    t.setOrigin(btVector3(0,0,0));
+
+    float power = 0.0;
+    const float angle = m_sslCommand.kick_angle()/180*M_PI;
+    const float dirFloor = std::cos(angle);
+    const float dirUp = std::sin(angle);
+
+    if (m_sslCommand.kick_angle() == 0) {
+        power = qBound(0.05f, m_sslCommand.kick_speed(), m_specs.shot_linear_max());
+    } else {
+        // FIXME: for now we just recalc the max distance based on the given angle
+        const float maxShootSpeed = coordinates::chipVelFromChipDistance(m_specs.shot_chip_max());
+        power = qBound(0.05f, m_sslCommand.kick_speed(), maxShootSpeed);
+    }
 
+    const auto getSpeedCompensation = [&]() -> float {
         if (m_sslCommand.kick_angle() == 0) {
-            power = qBound(0.05f, m_sslCommand.kick_speed(), m_specs.shot_linear_max());
+            return 0.0f;
         } else {
-            // FIXME: for now we just recalc the max distance based on the given angle
-            const float maxShootSpeed = coordinates::chipVelFromChipDistance(m_specs.shot_chip_max());
-            power = qBound(0.05f, m_sslCommand.kick_speed(), maxShootSpeed);
+            // if the ball hits the robot the chip distance actually decreases
+            const btVector3 relBallSpeed = relativeBallSpeed(ball) / SIMULATOR_SCALE;
+            return std::max((btScalar)0, relBallSpeed.y())
+                - qBound((btScalar)0, (btScalar)0.5 * relBallSpeed.y(), (btScalar)0.5 * dirFloor);
         }
+    };
+    const float speedCompensation = getSpeedCompensation();
 
-        const auto getSpeedCompensation = [&]() -> float {
-            if (m_sslCommand.kick_angle() == 0) {
-                return 0.0f;
-            } else {
-                // if the ball hits the robot the chip distance actually decreases
-                const btVector3 relBallSpeed = relativeBallSpeed(ball) / SIMULATOR_SCALE;
-                return std::max((btScalar)0, relBallSpeed.y())
-                    - qBound((btScalar)0, (btScalar)0.5 * relBallSpeed.y(), (btScalar)0.5 * dirFloor);
-            }
-        };
-        const float speedCompensation = getSpeedCompensation();
+    return t * btVector3(0, dirFloor * power + speedCompensation, dirUp * power);
+}
+
+void SimRobot::begin(SimBall *ball, double time)
+{
+    handleCommandTimeout(time);
 
-        ball->kick(t * btVector3(0, dirFloor * power + speedCompensation, dirUp * power) * (1/time) * SIMULATOR_SCALE * BALL_MASS);
+    // enable dribbler if necessary
+    if (!m_inStandby && m_sslCommand.has_dribbler_speed() && m_sslCommand.dribbler_speed() > 0) {
+        dribble(ball, m_sslCommand.dribbler_speed());
+    } else {
+        stopDribbling();
+    }
+
+    if (handleMoveCommand()) {
+        return;
+    }
+
+    m_body->setDamping(0.7, 0.8);
+
+    btTransform t = m_body->getWorldTransform();
+    t.setOrigin(btVector3(0,0,0));
+
+    updateCharge(time);
+    // check if should kick and can do that
+    if (wantsToKick() && canKickBall(ball)) {
+        stopDribbling();
+        ball->kick(kickVelocity(ball) * (1/time) * SIMULATOR_SCALE * BALL_MASS);
         // discharge
         m_isCharged = false;
         m_shootTime = 0.0;
@@ -469,6 +495,127 @@ void SimRobot::begin(SimBall *ball, double time)
     }
 }
 
+void SimRobot::setSimplifiedPhysics(bool enable)
+{
+    if (enable && !m_simplifiedPhysics) {
+        // the ball is carried directly by the simplified physics
+        stopDribbling();
+    }
+    m_simplifiedPhysics = enable;
+}
+
+void SimRobot::setSimplifiedTransform(const btTransform &transform, const btVector3 &velocity, float omega)
+{
+    setKinematicBodyState(m_body, transform, velocity, btVector3(0, 0, omega));
+    const btVector3 position = transform.getOrigin() / SIMULATOR_SCALE;
+    calculateDribblerMove(position, transform.getRotation(), velocity, omega);
+}
+
+void SimRobot::setSimplifiedState(const btVector3 &position, const btVector3 &velocity)
+{
+    setSimplifiedTransform(btTransform(m_body->getWorldTransform().getRotation(), position), velocity,
+                           m_body->getAngularVelocity().z());
+}
+
+void SimRobot::setVelocity(const btVector3 &linear, const btVector3 &angular)
+{
+    m_body->setLinearVelocity(linear);
+    m_body->setAngularVelocity(angular);
+    // the dribbler moves with the point of the body it is attached to
+    const btVector3 lever = m_dribblerBody->getWorldTransform().getOrigin() - m_body->getWorldTransform().getOrigin();
+    m_dribblerBody->setLinearVelocity(linear + angular.cross(lever));
+    m_dribblerBody->setAngularVelocity(angular);
+}
+
+bool SimRobot::ballAtDribbler(const SimBall *ball) const
+{
+    const btVector3 local = m_body->getWorldTransform().inverse() * ball->fullPosition() / SIMULATOR_SCALE;
+    const float frontDistance = local.y() - m_specs.shoot_radius();
+    return frontDistance >= -0.005f && frontDistance <= BALL_RADIUS + 0.01f
+            && std::abs(local.x()) <= m_specs.dribbler_width() / 2.0f;
+}
+
+void SimRobot::stepSimplified(SimBall *ball, float timeStep)
+{
+    handleCommandTimeout(timeStep);
+
+    btTransform transform = m_body->getWorldTransform();
+    btVector3 velocity = m_body->getLinearVelocity();
+    float omega = m_body->getAngularVelocity().z();
+
+    if (handleMoveCommand()) {
+        // moving by force applies an impulse and sets a damping, a teleport sets the transform directly
+        transform = m_body->getWorldTransform();
+        velocity = m_body->getLinearVelocity() * std::pow(1 - m_body->getLinearDamping(), timeStep);
+        omega = m_body->getAngularVelocity().z();
+        velocity.setZ(0);
+        transform.getOrigin() += velocity * timeStep;
+        setSimplifiedTransform(transform, velocity, omega);
+        return;
+    }
+
+    btTransform t = transform;
+    t.setOrigin(btVector3(0,0,0));
+
+    updateCharge(timeStep);
+    if (wantsToKick() && canKickBall(ball)) {
+        ball->setSimplifiedState(ball->fullPosition(), ball->speed() + kickVelocity(ball) * SIMULATOR_SCALE);
+        // discharge
+        m_isCharged = false;
+        m_shootTime = 0.0;
+    }
+
+    // the robot directly follows the commanded velocity as far as its acceleration allows
+    btVector3 v_d_local(0, 0, 0);
+    float omega_d = 0;
+    if (!m_inStandby && m_sslCommand.has_move_command() && m_sslCommand.move_command().has_local_velocity()) {
+        const auto &localVelocity = m_sslCommand.move_command().local_velocity();
+        v_d_local = btVector3(boundSpeed(-localVelocity.left()), boundSpeed(localVelocity.forward()), 0);
+        omega_d = boundSpeed(localVelocity.angular());
+    }
+
+    const btVector3 v_local = t.inverse() * velocity / SIMULATOR_SCALE;
+    const float v_f = v_local.y();
+    const float v_s = v_local.x();
+
+    const float a_f = (v_d_local.y() - v_f) / timeStep;
+    const float a_s = (v_d_local.x() - v_s) / timeStep;
+    const float a_phi = (omega_d - omega) / timeStep;
+
+    float a_phi_bound, a_s_bound, a_f_bound;
+    if (!m_specs.has_simulation_limits()) {
+        a_f_bound = bound(a_f, v_f, m_specs.strategy().a_speedup_f_max(), m_specs.strategy().a_brake_f_max());
+        a_s_bound = bound(a_s, v_s, m_specs.strategy().a_speedup_s_max(), m_specs.strategy().a_brake_s_max());
+        a_phi_bound = bound(a_phi, omega, m_specs.strategy().a_speedup_phi_max(), m_specs.strategy().a_brake_phi_max());
+    } else {
+        const Eigen::Vector3f limited = limitAcceleration(a_f, a_s, a_phi, v_f, v_s, omega);
+        a_s_bound = limited[0];
+        a_f_bound = limited[1];
+        a_phi_bound = limited[2];
+    }
+
+    const btVector3 newLocalVelocity(v_s + a_s_bound * timeStep, v_f + a_f_bound * timeStep, 0);
+    const float newOmega = omega + a_phi_bound * timeStep;
+    const btVector3 newVelocity = t * newLocalVelocity * SIMULATOR_SCALE;
+
+    // integrate using the mean velocity of the time step
+    transform.getOrigin() += (velocity + newVelocity) * (0.5f * timeStep);
+    transform.getOrigin().setZ(m_specs.height() / 2.0f * SIMULATOR_SCALE);
+    const btQuaternion rotation = btQuaternion(btVector3(0, 0, 1), (omega + newOmega) * 0.5f * timeStep) * transform.getRotation();
+    transform.setRotation(rotation.normalized());
+    setSimplifiedTransform(transform, newVelocity, newOmega);
+
+    // carry the ball in front of the dribbler
+    const bool dribbling = !m_inStandby && m_sslCommand.has_dribbler_speed() && m_sslCommand.dribbler_speed() > 0;
+    if (dribbling && ball->fullPosition().z() < 0.05f * SIMULATOR_SCALE && ballAtDribbler(ball)) {
+        const btVector3 offset = btVector3(0, m_specs.shoot_radius() + BALL_RADIUS, BALL_RADIUS - m_specs.height() / 2.0f) * SIMULATOR_SCALE;
+        const btVector3 ballPosition = transform * offset;
+        const btVector3 lever = ballPosition - transform.getOrigin();
+        const btVector3 ballVelocity = newVelocity + btVector3(-newOmega * lever.y(), newOmega * lever.x(), 0);
+        ball->setSimplifiedState(ballPosition, ballVelocity);
+    }
+}
+
 void SimRobot::generateVelocityCoupling()
 {
     // TODO: configurable wheel angles
@@ -570,6 +717,11 @@ bool SimRobot::canKickBall(SimBall *ball) const
         return true;
     }
 
+    // there are no contact points without the full physics
+    if (m_simplifiedPhysics) {
+        return ballAtDribbler(ball);
+    }
+
     // check for collision between ball and dribbler
     int numManifolds = m_world->getDispatcher()->getNumManifolds();
     for (int i = 0; i < numManifolds; ++i) {
@@ -673,6 +825,13 @@ void SimRobot::update(world::SimRobot* robot, SimBall *ball) const
     robot->set_r_z(angular.z());
 
     bool ballTouchesRobot = false;
+    if (m_simplifiedPhysics) {
+        const btVector3 distance = (ball->fullPosition() - transform.getOrigin()) / SIMULATOR_SCALE;
+        const bool touchesBody = btVector3(distance.x(), distance.y(), 0).length() <= m_specs.radius() + BALL_RADIUS + 0.005f;
+        robot->set_touches_ball(ball->fullPosition().z() < m_specs.height() * SIMULATOR_SCALE
+                                && (touchesBody || ballAtDribbler(ball)));
+        return;
+    }
     int numManifolds = m_world->getDispatcher()->getNumManifolds();
     for (int i = 0; i < numManifolds; ++i) {
         btPersistentManifold *contactManifold = m_world->getDispatcher()->getManifoldByIndexInternal(i);
@@ -700,6 +859,55 @@ void SimRobot::restoreState(const world::SimRobot &robot)
     m_body->setAngularVelocity(angular);
 }
 
+void SimRobot::saveSnapshot(Snapshot *snapshot) const
+{
+    snapshot->body.save(m_body);
+    snapshot->dribbler.save(m_dribblerBody);
+    snapshot->move = m_move;
+    snapshot->command = m_sslCommand;
+    snapshot->charge = m_charge;
+    snapshot->isCharged = m_isCharged;
+    snapshot->inStandby = m_inStandby;
+    snapshot->shootTime = m_shootTime;
+    snapshot->commandTime = m_commandTime;
+    snapshot->errorSumVS = error_sum_v_s;
+    snapshot->errorSumVF = error_sum_v_f;
+    snapshot->errorSumOmega = error_sum_omega;
+    snapshot->lastSendTime = m_lastSendTime;
+    snapshot->holdsBall = bool(m_holdBallConstraint);
+    if (m_holdBallConstraint) {
+        snapshot->holdBallPivot = m_holdBallConstraint->getPivotInA();
+        snapshot->notTipOverFrameA = m_notTipOverConstraint->getFrameOffsetA();
+        snapshot->notTipOverFrameB = m_notTipOverConstraint->getFrameOffsetB();
+    }
+}
+
+void SimRobot::restoreSnapshot(const Snapshot &snapshot, SimBall *ball)
+{
+    // the dribbler motor is set again from the radio command at the start of every tick
+    stopDribbling();
+
+    snapshot.body.restore(m_body);
+    snapshot.dribbler.restore(m_dribblerBody);
+    m_move = snapshot.move;
+    m_sslCommand = snapshot.command;
+    m_charge = snapshot.charge;
+    m_isCharged = snapshot.isCharged;
+    m_inStandby = snapshot.inStandby;
+    m_shootTime = snapshot.shootTime;
+    m_commandTime = snapshot.commandTime;
+    error_sum_v_s = snapshot.errorSumVS;
+    error_sum_v_f = snapshot.errorSumVF;
+    error_sum_omega = snapshot.errorSumOmega;
+    m_lastSendTime = snapshot.lastSendTime;
+
+    if (snapshot.holdsBall) {
+        holdBall(ball, snapshot.holdBallPivot, snapshot.notTipOverFrameB);
+        // the fixed frame was derived from the robot transform at the time the ball was grabbed
+        m_notTipOverConstraint->setFrames(snapshot.notTipOverFrameA, snapshot.notTipOverFrameB);
+    }
+}
+
 void SimRobot::move(const sslsim::TeleportRobot &robot)
 {
     m_move = robot;
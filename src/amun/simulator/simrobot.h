@@ -27,6 +27,7 @@
 #include <Eigen/Dense>
 #include <Eigen/QR>
 #include <btBulletDynamicsCommon.h>
+#include "bodysnapshot.h"
 
 class RNG;
 class SSL_DetectionRobot;
@@ -48,20 +49,55 @@ public:
     SimRobot(const SimRobot&) = delete;
     SimRobot& operator=(const SimRobot&) = delete;
 
+    struct Snapshot
+    {
+        BodySnapshot body;
+        BodySnapshot dribbler;
+        sslsim::TeleportRobot move;
+        sslsim::RobotCommand command;
+        bool charge;
+        bool isCharged;
+        bool inStandby;
+        double shootTime;
+        double commandTime;
+        float errorSumVS;
+        float errorSumVF;
+        float errorSumOmega;
+        qint64 lastSendTime;
+        // only valid if holdsBall is set
+        bool holdsBall;
+        btVector3 holdBallPivot;
+        btTransform notTipOverFrameA;
+        btTransform notTipOverFrameB;
+    };
+
 signals:
     void sendSSLSimError(const SSLSimError& error, ErrorSource s);
 
 public:
     void begin(SimBall *ball, double time);
+    // replaces begin and the physics step when using the simplified physics
+    void stepSimplified(SimBall *ball, float timeStep);
+    void setSimplifiedPhysics(bool enable);
     bool canKickBall(SimBall *ball) const;
     void tryKick(SimBall *ball, float power, double time);
     robot::RadioResponse setCommand(const sslsim::RobotCommand &command, SimBall *ball, bool charge, float rxLoss, float txLoss);
     void update(SSL_DetectionRobot *robot, float stddev_p, float stddev_phi, qint64 time, btVector3 positionOffset);
     void update(world::SimRobot *robot, SimBall *ball) const;
     void restoreState(const world::SimRobot &robot);
+    void saveSnapshot(Snapshot *snapshot) const;
+    // the ball is required to restore the perfect dribbling constraint
+    void restoreSnapshot(const Snapshot &snapshot, SimBall *ball);
     void move(const sslsim::TeleportRobot &robot);
     bool isFlipped();
     btVector3 position() const;
+    const btTransform &transform() const { return m_body->getWorldTransform(); }
+    btVector3 velocity() const { return m_body->getLinearVelocity(); }
+    btVector3 angularVelocity() const { return m_body->getAngularVelocity(); }
+    // keeps the orientation, used to resolve collisions of the simplified physics
+    void setSimplifiedState(const btVector3 &position, const btVector3 &velocity);
+    // sets the velocity of the body and the attached dribbler, in simulator coordinates
+    void setVelocity(const btVector3 &linear, const btVector3 &angular);
     btVector3 dribblerCorner(bool left) const;
     qint64 getLastSendTime() const { return m_lastSendTime; }
     void setDribbleMode(bool perfectDribbler);
@@ -76,7 +112,15 @@ private:
     // returns {a_s, a_f, a_phi} bounded
     Eigen::Vector3f limitAcceleration(float a_f, float a_s, float a_phi, float v_f, float v_s, float omega) const;
     void dribble(SimBall *ball, float speed);
+    void holdBall(SimBall *ball, const btVector3 &pivot, const btTransform &robotTransform);
     bool handleMoveCommand();
+    void handleCommandTimeout(double time);
+    void updateCharge(double time);
+    bool wantsToKick() const;
+    // velocity change of the ball in m/s, in world coordinates
+    btVector3 kickVelocity(SimBall *ball) const;
+    bool ballAtDribbler(const SimBall *ball) const;
+    void setSimplifiedTransform(const btTransform &transform, const btVector3 &velocity, float omega);
     void reportAccelerationLimits() const;
     void generateVelocityCoupling();
 
@@ -112,6 +156,7 @@ private:
     float error_sum_omega;
 
     bool m_perfectDribbler = false;
+    bool m_simplifiedPhysics = false;
 
     qint64 m_lastSendTime = 0;
 
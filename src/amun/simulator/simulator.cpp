@@ -27,9 +27,13 @@
 #include "simball.h"
 #include "simfield.h"
 #include "simrobot.h"
+#include "simplifiedphysics.h"
 #include "erroraggregator.h"
+#include <google/protobuf/util/message_differencer.h>
 #include <QTimer>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <QtDebug>
 #include <QVector>
 #include <cstdint>
@@ -63,6 +67,62 @@ using namespace camun::simulator;
  * => f_b = 1; f_f = 0.35; f_r = 0.22
  */
 
+// accumulated time in ns spent in the individual steps of the simulator
+struct SimulatorTimings
+{
+    bool enabled = false;
+    qint64 radioCommands = 0;
+    qint64 tick = 0;
+    qint64 broadphase = 0;
+    qint64 narrowphase = 0;
+    qint64 solver = 0;
+    qint64 physics = 0;
+    qint64 vision = 0;
+    qint64 visionDetections = 0;
+    qint64 errorAggregation = 0;
+    qint64 status = 0;
+    int physicsSubsteps = 0;
+};
+
+using ScopedSimulatorTiming = ScopedTiming<SimulatorTimings>;
+
+// exposes the remainder of the fixed timestep accumulation, which is part of a snapshot,
+// and measures the collision detection and the constraint solver separately
+class SimulatorWorld : public btDiscreteDynamicsWorld
+{
+public:
+    SimulatorWorld(btDispatcher *dispatcher, btBroadphaseInterface *pairCache, btConstraintSolver *constraintSolver,
+                   btCollisionConfiguration *collisionConfiguration, SimulatorTimings *timings) :
+        btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration),
+        m_timings(timings) {}
+    btScalar localTime() const { return m_localTime; }
+    void setLocalTime(btScalar time) { m_localTime = time; }
+
+    void performDiscreteCollisionDetection() override
+    {
+        // same as btCollisionWorld::performDiscreteCollisionDetection
+        {
+            ScopedSimulatorTiming timing(m_timings, &SimulatorTimings::broadphase);
+            updateAabbs();
+            m_broadphasePairCache->calculateOverlappingPairs(m_dispatcher1);
+        }
+        ScopedSimulatorTiming timing(m_timings, &SimulatorTimings::narrowphase);
+        if (btDispatcher *dispatcher = getDispatcher()) {
+            dispatcher->dispatchAllCollisionPairs(m_broadphasePairCache->getOverlappingPairCache(), getDispatchInfo(), m_dispatcher1);
+        }
+    }
+
+protected:
+    void solveConstraints(btContactSolverInfo &solverInfo) override
+    {
+        ScopedSimulatorTiming timing(m_timings, &SimulatorTimings::solver);
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+    }
+
+private:
+    SimulatorTimings *m_timings;
+};
+
 struct camun::simulator::SimulatorData
 {
     RNG rng;
@@ -70,7 +130,7 @@ struct camun::simulator::SimulatorData
     btCollisionDispatcher *dispatcher;
     btBroadphaseInterface *overlappingPairCache;
     btSequentialImpulseConstraintSolver *solver;
-    btDiscreteDynamicsWorld *dynamicsWorld;
+    SimulatorWorld *dynamicsWorld;
     world::Geometry geometry;
     QVector<SSL_GeometryCameraCalibration> reportedCameraSetup;
     QVector<btVector3> cameraPositions;
@@ -97,6 +157,36 @@ struct camun::simulator::SimulatorData
     bool dribblePerfect;
     float missingRobotDetections;
     uint64_t commandDelay;
+    bool simplifiedPhysics;
+    SimplifiedPhysics *simplified;
+    SimulatorTimings timings;
+};
+
+struct camun::simulator::SimulatorSnapshot
+{
+    struct Robot
+    {
+        robot::Specs specs;
+        unsigned int generation;
+        SimRobot::Snapshot state;
+    };
+    typedef QMap<unsigned int, Robot> RobotMap;
+
+    qint64 time;
+    qint64 lastSentStatusTime;
+    qint64 lastBallSendTime;
+    bool charge;
+    btScalar localTime;
+    RNG rng;
+    std::mt19937 shuffleRng;
+    std::map<qint64, unsigned> lastFrameNumber;
+    QQueue<std::tuple<SSLSimRobotControl, qint64, bool>> radioCommands;
+    QQueue<std::tuple<SimulatorVisionFramePtr, qint64>> visionPackets;
+    QMap<uint32_t, robot::Specs> specsBlue;
+    QMap<uint32_t, robot::Specs> specsYellow;
+    RobotMap robotsBlue;
+    RobotMap robotsYellow;
+    SimBall::Snapshot ball;
 };
 
 static void simulatorTickCallback(btDynamicsWorld *world, btScalar timeStep)
@@ -131,25 +221,24 @@ Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool
         connect(m_trigger, SIGNAL(timeout()), SLOT(process()));
     }
 
+    // releases the delayed vision packets, always runs until the oldest pending packet is due
+    m_visionTimer = new QTimer(this);
+    m_visionTimer->setTimerType(Qt::PreciseTimer);
+    m_visionTimer->setSingleShot(true);
+    connect(m_visionTimer, &QTimer::timeout, this, &Simulator::sendDueVisionPackets);
+
     // setup bullet
     m_data = new SimulatorData;
     m_data->collision = new btDefaultCollisionConfiguration();
     m_data->dispatcher = new btCollisionDispatcher(m_data->collision);
     m_data->overlappingPairCache = new btDbvtBroadphase();
     m_data->solver = new btSequentialImpulseConstraintSolver;
-    m_data->dynamicsWorld = new btDiscreteDynamicsWorld(m_data->dispatcher, m_data->overlappingPairCache, m_data->solver, m_data->collision);
+    m_data->dynamicsWorld = new SimulatorWorld(m_data->dispatcher, m_data->overlappingPairCache, m_data->solver, m_data->collision, &m_data->timings);
     m_data->dynamicsWorld->setGravity(btVector3(0.0f, 0.0f, -9.81f * SIMULATOR_SCALE));
     m_data->dynamicsWorld->setInternalTickCallback(simulatorTickCallback, this, true);
 
     m_data->geometry.CopyFrom(setup.geometry());
-    for (const auto& camera : setup.camera_setup()) {
-        m_data->reportedCameraSetup.append(camera);
-        Vector visionPosition(camera.derived_camera_world_tx(), camera.derived_camera_world_ty());
-        btVector3 truePosition;
-        coordinates::fromVision(visionPosition, truePosition);
-        truePosition.setZ(camera.derived_camera_world_tz() / 1000.0f);
-        m_data->cameraPositions.append(truePosition);
-    }
+    setCameraSetup(setup.camera_setup());
 
     // add field and ball
     m_data->field = new SimField(m_data->dynamicsWorld, m_data->geometry);
@@ -172,6 +261,8 @@ Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool
     m_data->dribblePerfect = false;
     m_data->missingRobotDetections = 0;
     m_data->commandDelay = 0;
+    m_data->simplifiedPhysics = false;
+    m_data->simplified = new SimplifiedPhysics(m_data->geometry);
 
     // no robots after initialisation
 
@@ -194,6 +285,7 @@ Simulator::~Simulator()
     deleteAll(m_data->robotsYellow);
     delete m_data->ball;
     delete m_data->field;
+    delete m_data->simplified;
     delete m_data->dynamicsWorld;
     delete m_data->solver;
     delete m_data->overlappingPairCache;
@@ -202,6 +294,40 @@ Simulator::~Simulator()
     delete m_data;
 }
 
+void Simulator::setCameraSetup(const google::protobuf::RepeatedPtrField<SSL_GeometryCameraCalibration> &cameras)
+{
+    m_data->reportedCameraSetup.clear();
+    m_data->cameraPositions.clear();
+    for (const auto& camera : cameras) {
+        m_data->reportedCameraSetup.append(camera);
+        Vector visionPosition(camera.derived_camera_world_tx(), camera.derived_camera_world_ty());
+        btVector3 truePosition;
+        coordinates::fromVision(visionPosition, truePosition);
+        truePosition.setZ(camera.derived_camera_world_tz() / 1000.0f);
+        m_data->cameraPositions.append(truePosition);
+    }
+}
+
+void Simulator::setSetup(const amun::SimulatorSetup &setup)
+{
+    // only rebuild the field if the geometry changed, ball and robots are kept in either case
+    if (!google::protobuf::util::MessageDifferencer::Equals(m_data->geometry, setup.geometry())) {
+        m_data->geometry.CopyFrom(setup.geometry());
+        delete m_data->field;
+        m_data->field = new SimField(m_data->dynamicsWorld, m_data->geometry);
+        delete m_data->simplified;
+        m_data->simplified = new SimplifiedPhysics(m_data->geometry);
+    }
+
+    bool camerasChanged = setup.camera_setup_size() != m_data->reportedCameraSetup.size();
+    for (int i = 0; !camerasChanged && i < setup.camera_setup_size(); i++) {
+        camerasChanged = !google::protobuf::util::MessageDifferencer::Equals(setup.camera_setup(i), m_data->reportedCameraSetup[i]);
+    }
+    if (camerasChanged) {
+        setCameraSetup(setup.camera_setup());
+    }
+}
+
 void Simulator::process()
 {
     Q_ASSERT(m_time != 0);
@@ -211,11 +337,14 @@ void Simulator::process()
 
     // first: send vision packets in partial mode
     if (m_isPartial) {
-        while(m_visionPackets.size() > 0 && std::get<2>(m_visionPackets.head()) >= current_time) {
+        while(m_visionPackets.size() > 0 && std::get<1>(m_visionPackets.head()) >= current_time) {
             sendVisionPacket();
         }
     }
 
+    SimulatorTimings *timings = &m_data->timings;
+    ScopedSimulatorTiming radioTiming(timings, &SimulatorTimings::radioCommands);
+
     // collect responses from robots
     QList<robot::RadioResponse> responses;
 
@@ -262,38 +391,35 @@ void Simulator::process()
     // radio responses are sent when a robot gets his command
     // thus send the responses immediatelly
     emit sendRadioResponses(responses);
-    sendSSLSimErrorInternal(ErrorSource::BLUE);
-    sendSSLSimErrorInternal(ErrorSource::YELLOW);
-    sendSSLSimErrorInternal(ErrorSource::CONFIG);
+    radioTiming.finish();
+    {
+        ScopedSimulatorTiming timing(timings, &SimulatorTimings::errorAggregation);
+        sendSSLSimErrorInternal(ErrorSource::BLUE);
+        sendSSLSimErrorInternal(ErrorSource::YELLOW);
+        sendSSLSimErrorInternal(ErrorSource::CONFIG);
+    }
 
     // simulate to current strategy time
     double timeDelta = (current_time - m_time) * 1E-9;
-    m_data->dynamicsWorld->stepSimulation(timeDelta, 10, SUB_TIMESTEP);
+    {
+        ScopedSimulatorTiming timing(timings, &SimulatorTimings::physics);
+        if (m_data->simplifiedPhysics) {
+            stepSimplifiedPhysics(timeDelta);
+        } else {
+            m_data->dynamicsWorld->stepSimulation(timeDelta, 10, SUB_TIMESTEP);
+        }
+    }
     m_time = current_time;
 
     // only send a vision packet every third frame = 15 ms - epsilon (=half frame)
     // gives a vision frequency of 66.67Hz
     if (m_lastSentStatusTime + 12500000 <= m_time) {
-        auto data = createVisionPacket();
-
-
-
-        if (m_isPartial) {
-            std::get<2>(data) = m_time + m_visionDelay;
-            m_visionPackets.enqueue(data);
-        } else {
-            m_visionPackets.enqueue(data);
-            // timeout is in milliseconds
-            int timeout = m_visionDelay * 1E-6 / m_timeScaling;
-
-            // send after timeout, default timer mode, may jitter a bit
-            QTimer *timer = new QTimer();
-            timer->setTimerType(Qt::PreciseTimer);
-            timer->setSingleShot(true);
-            connect(timer, SIGNAL(timeout()), SLOT(sendVisionPacket()));
-            timer->start(timeout);
-            m_visionTimers.enqueue(timer);
+        const qint64 encodeStart = Timer::systemTime();
+        {
+            ScopedSimulatorTiming timing(timings, &SimulatorTimings::vision);
+            queueVisionPacket(VisionPacket(createVisionPacket(), m_time + m_visionDelay));
         }
+        m_visionEncodeTime += Timer::systemTime() - encodeStart;
 
         m_lastSentStatusTime = m_time;
     }
@@ -301,6 +427,37 @@ void Simulator::process()
     // send timing information
     Status status(new amun::Status);
     status->mutable_timing()->set_simulator((Timer::systemTime() - start_time) * 1E-9f);
+    if (m_visionJitterCount > 0) {
+        status->mutable_timing()->set_simulator_vision_jitter(m_visionJitterSum * 1E-9f / m_visionJitterCount);
+        status->mutable_timing()->set_simulator_vision_jitter_max(m_visionJitterMax * 1E-9f);
+        m_visionJitterSum = 0;
+        m_visionJitterMax = 0;
+        m_visionJitterCount = 0;
+    }
+    if (m_visionEncodeTime > 0) {
+        status->mutable_timing()->set_simulator_vision_encode(m_visionEncodeTime * 1E-9f);
+        m_visionEncodeTime = 0;
+    }
+    if (m_reconfigureTime > 0) {
+        status->mutable_timing()->set_simulator_reconfigure(m_reconfigureTime * 1E-9f);
+        m_reconfigureTime = 0;
+    }
+    if (timings->enabled) {
+        amun::SimulatorTiming *steps = status->mutable_timing()->mutable_simulator_steps();
+        steps->set_radio_commands(timings->radioCommands * 1E-9f);
+        steps->set_tick(timings->tick * 1E-9f);
+        steps->set_broadphase(timings->broadphase * 1E-9f);
+        steps->set_narrowphase(timings->narrowphase * 1E-9f);
+        steps->set_solver(timings->solver * 1E-9f);
+        steps->set_physics(timings->physics * 1E-9f);
+        steps->set_vision(timings->vision * 1E-9f);
+        steps->set_vision_detections(timings->visionDetections * 1E-9f);
+        steps->set_error_aggregation(timings->errorAggregation * 1E-9f);
+        steps->set_status(timings->status * 1E-9f);
+        steps->set_physics_substeps(timings->physicsSubsteps);
+        *timings = SimulatorTimings { true };
+    }
+    ScopedSimulatorTiming timing(timings, &SimulatorTimings::status);
     emit sendStatus(status);
 }
 
@@ -311,10 +468,11 @@ void Simulator::sendSSLSimErrorInternal(ErrorSource source)
     emit sendSSLSimError(errors, source);
 }
 
-static void createRobot(Simulator::RobotMap &list, float x, float y, uint32_t id, const ErrorAggregator* agg, SimulatorData* data, const QMap<uint32_t, robot::Specs>& teamSpecs)
+static void createRobot(Simulator::RobotMap &list, float x, float y, uint32_t id, const ErrorAggregator* agg, SimulatorData* data, const QMap<uint32_t, robot::Specs>& teamSpecs, float dir = 0.f)
 {
-    SimRobot *robot = new SimRobot(&data->rng, teamSpecs[id], data->dynamicsWorld, btVector3(x, y, 0), 0.f);
+    SimRobot *robot = new SimRobot(&data->rng, teamSpecs[id], data->dynamicsWorld, btVector3(x, y, 0), dir);
     robot->setDribbleMode(data->dribblePerfect);
+    robot->setSimplifiedPhysics(data->simplifiedPhysics);
     robot->connect(robot, &SimRobot::sendSSLSimError, agg, &ErrorAggregator::aggregate);
     list[id] = {robot, teamSpecs[id].generation()};
 
@@ -341,6 +499,11 @@ void Simulator::resetFlipped(Simulator::RobotMap &robots, float side)
 
 void Simulator::handleSimulatorTick(double timeStep)
 {
+    ScopedSimulatorTiming timing(&m_data->timings, &SimulatorTimings::tick);
+    if (m_data->timings.enabled) {
+        m_data->timings.physicsSubsteps++;
+    }
+
     // has to be done according to bullet wiki
     m_data->dynamicsWorld->clearForces();
 
@@ -366,6 +529,44 @@ void Simulator::handleSimulatorTick(double timeStep)
     m_data->dynamicsWorld->applyGravity();
 }
 
+void Simulator::stepSimplifiedPhysics(double timeDelta)
+{
+    // use the same fixed time steps as bullet, the remainder is kept for the next call
+    SimulatorWorld *world = m_data->dynamicsWorld;
+    btScalar localTime = world->localTime() + timeDelta;
+    int numSteps = 0;
+    if (localTime >= SUB_TIMESTEP) {
+        numSteps = int(localTime / SUB_TIMESTEP);
+        localTime -= numSteps * SUB_TIMESTEP;
+    }
+    world->setLocalTime(localTime);
+
+    if (m_data->ball->isInvalid()) {
+        delete m_data->ball;
+        m_data->ball = new SimBall(&m_data->rng, m_data->dynamicsWorld);
+        connect(m_data->ball, &SimBall::sendSSLSimError, m_aggregator, &ErrorAggregator::aggregate);
+    }
+
+    QList<SimRobot*> robots;
+    for (const auto& pair : m_data->robotsBlue) {
+        robots.append(pair.first);
+    }
+    for (const auto& pair : m_data->robotsYellow) {
+        robots.append(pair.first);
+    }
+    for (int i = 0; i < std::min(numSteps, 10); i++) {
+        m_data->simplified->step(m_data->ball, robots, SUB_TIMESTEP);
+    }
+    if (m_data->timings.enabled) {
+        m_data->timings.physicsSubsteps += std::min(numSteps, 10);
+    }
+
+    // the bounding boxes are still required for the ray tests of the ball visibility
+    if (numSteps > 0) {
+        world->updateAabbs();
+    }
+}
+
 static bool checkCameraID(const int cameraId, const btVector3 &p, const QVector<btVector3> &cameraPositions, const float overlap)
 {
     float minDistance = std::numeric_limits<float>::max();
@@ -403,20 +604,46 @@ static btVector3 positionOffsetForCamera(float offsetStrength, btVector3 cameraP
     return btVector3(cameraPos.x(), cameraPos.y(), 0).normalized() * offsetStrength;
 }
 
-std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket()
+std::shared_ptr<SimulatorVisionFrame> Simulator::acquireVisionFrame()
+{
+    // the pool only holds a handful of frames, as they are released after the vision delay
+    for (const auto &frame : m_visionFramePool) {
+        if (frame.use_count() == 1) {
+            // synchronize with the release of the last reference by the receiver thread
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return frame;
+        }
+    }
+    m_visionFramePool.push_back(std::make_shared<SimulatorVisionFrame>());
+    return m_visionFramePool.back();
+}
+
+SimulatorVisionFramePtr Simulator::createVisionPacket()
 {
     const std::size_t numCameras = m_data->reportedCameraSetup.size();
-    world::SimulatorState simState;
+    // clearing keeps the allocated submessages, thus a reused frame is already sized
+    std::shared_ptr<SimulatorVisionFrame> frame = acquireVisionFrame();
+    world::SimulatorState &simState = frame->simulatorState;
+    simState.Clear();
     simState.set_time(m_time);
 
-    std::vector<SSL_DetectionFrame> detections(numCameras);
+    // add a wrapper packet for all detections (also for empty ones).
+    // The reason is that other teams might rely on the fact that these detections are in regular intervals.
+    std::vector<SSL_WrapperPacket> &packets = frame->packets;
+    packets.resize(std::max<std::size_t>(numCameras, 1));
+    std::vector<SSL_DetectionFrame*> detections(numCameras);
+    for (std::size_t i = 0; i < packets.size(); i++) {
+        packets[i].Clear();
+    }
     for (std::size_t i = 0;i<numCameras;i++) {
-        initializeDetection(&detections[i], i);
+        detections[i] = packets[i].mutable_detection();
+        initializeDetection(detections[i], i);
     }
 
     auto* ball = simState.mutable_ball();
     m_data->ball->writeBallState(ball);
 
+    ScopedSimulatorTiming detectionTiming(&m_data->timings, &SimulatorTimings::visionDetections);
     const btVector3 ballPosition = m_data->ball->position() / SIMULATOR_SCALE;
     if (m_time - m_lastBallSendTime >= m_minBallDetectionTime) {
         m_lastBallSendTime = m_time;
@@ -434,10 +661,10 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
 
             // get ball position
             const btVector3 positionOffset = positionOffsetForCamera(m_data->objectPositionOffset, m_data->cameraPositions[cameraId]);
-            bool visible = m_data->ball->update(detections[cameraId].add_balls(), m_data->stddevBall, m_data->stddevBallArea, m_data->cameraPositions[cameraId],
+            bool visible = m_data->ball->update(detections[cameraId]->add_balls(), m_data->stddevBall, m_data->stddevBallArea, m_data->cameraPositions[cameraId],
                     m_data->enableInvisibleBall, m_data->ballVisibilityThreshold, positionOffset);
             if (!visible) {
-                detections[cameraId].clear_balls();
+                detections[cameraId]->clear_balls();
             }
         }
     }
@@ -468,9 +695,9 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
 
                     const btVector3 positionOffset = positionOffsetForCamera(m_data->objectPositionOffset, m_data->cameraPositions[cameraId]);
                     if (teamIsBlue) {
-                        robot->update(detections[cameraId].add_robots_blue(), m_data->stddevRobot, m_data->stddevRobotPhi, m_time, positionOffset);
+                        robot->update(detections[cameraId]->add_robots_blue(), m_data->stddevRobot, m_data->stddevRobotPhi, m_time, positionOffset);
                     } else {
-                        robot->update(detections[cameraId].add_robots_yellow(), m_data->stddevRobot, m_data->stddevRobotPhi, m_time, positionOffset);
+                        robot->update(detections[cameraId]->add_robots_yellow(), m_data->stddevRobot, m_data->stddevRobotPhi, m_time, positionOffset);
                     }
 
                     // once in a while, add a ball mis-detection at a corner of the dribbler
@@ -478,9 +705,9 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
                     float detectionProb = timeDiff * m_data->ballDetectionsAtDribbler;
                     if (m_data->ballDetectionsAtDribbler > 0 && m_data->rng.uniformFloat(0, 1) < detectionProb) {
                         // always on the right side of the dribbler for now
-                        if (!m_data->ball->addDetection(detections[cameraId].add_balls(), robot->dribblerCorner(false) / SIMULATOR_SCALE,
+                        if (!m_data->ball->addDetection(detections[cameraId]->add_balls(), robot->dribblerCorner(false) / SIMULATOR_SCALE,
                                                         m_data->stddevRobot, 0, m_data->cameraPositions[cameraId], false, 0, positionOffset)) {
-                            detections[cameraId].mutable_balls()->DeleteSubrange(detections[cameraId].balls_size()-1, 1);
+                            detections[cameraId]->mutable_balls()->DeleteSubrange(detections[cameraId]->balls_size()-1, 1);
                         }
                     }
                 }
@@ -488,27 +715,15 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
         }
     }
 
-    std::vector<SSL_WrapperPacket> packets;
-    packets.reserve(numCameras);
-
-    // add a wrapper packet for all detections (also for empty ones).
-    // The reason is that other teams might rely on the fact that these detections are in regular intervals.
-    for (auto &frame : detections) {
-
+    for (SSL_DetectionFrame *detection : detections) {
         // if multiple balls are reported, shuffle them randomly (the tracking might have systematic errors depending on the ball order)
-        if (frame.balls_size() > 1) {
-            std::shuffle(frame.mutable_balls()->begin(), frame.mutable_balls()->end(), rand_shuffle_src);
+        if (detection->balls_size() > 1) {
+            std::shuffle(detection->mutable_balls()->begin(), detection->mutable_balls()->end(), rand_shuffle_src);
         }
-
-        SSL_WrapperPacket packet;
-        packet.mutable_detection()->CopyFrom(frame);
-        packets.push_back(packet);
     }
+    detectionTiming.finish();
 
     // add field geometry
-    if (packets.size() == 0) {
-        packets.push_back(SSL_WrapperPacket());
-    }
     SSL_GeometryData *geometry = packets[0].mutable_geometry();
     SSL_GeometryFieldSize *field = geometry->mutable_field();
     convertToSSlGeometry(m_data->geometry, field);
@@ -524,53 +739,99 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
         calib->set_derived_camera_world_tz(calib->derived_camera_world_tz() + positionErrorVisionScale.z());
     }
 
-    // add ball model to geometry data
-    geometry->mutable_models()->mutable_straight_two_phase()->set_acc_roll(-0.35);
-    geometry->mutable_models()->mutable_straight_two_phase()->set_acc_slide(-3.9);
-    geometry->mutable_models()->mutable_straight_two_phase()->set_k_switch(0.69);
-    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_z(0.566);
-    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_xy_first_hop(0.715);
+    // add ball model to geometry data, bullet always simulates the default model
+    const world::BallModel ballModel = SimBall::ballModel(m_data->simplifiedPhysics ? m_data->geometry : world::Geometry());
+    geometry->mutable_models()->mutable_straight_two_phase()->set_acc_roll(-ballModel.slow_deceleration());
+    geometry->mutable_models()->mutable_straight_two_phase()->set_acc_slide(-ballModel.fast_deceleration());
+    geometry->mutable_models()->mutable_straight_two_phase()->set_k_switch(ballModel.switch_ratio());
+    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_z(ballModel.z_damping());
+    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_xy_first_hop(ballModel.xy_damping());
     geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_xy_other_hops(1);
 
-    // serialize "vision packet"
-    QList<QByteArray> data;
-    for (std::size_t i = 0; i < packets.size(); ++i) {
-        QByteArray d;
-        d.resize(packets[i].ByteSize());
-        if (packets[i].SerializeToArray(d.data(), d.size())) {
-            data.push_back(d);
-        } else {
-            data.push_back(QByteArray());
-        }
+    return frame;
+}
+
+void Simulator::queueVisionPacket(const VisionPacket &packet)
+{
+    // the vision delay can change at any time, keep the queue sorted by the send time.
+    // Usually the packet is just appended
+    const qint64 sendTime = std::get<1>(packet);
+    auto it = std::upper_bound(m_visionPackets.begin(), m_visionPackets.end(), sendTime,
+                               [](qint64 time, const VisionPacket &p) { return time < std::get<1>(p); });
+    m_visionPackets.insert(it, packet);
+    scheduleVisionTimer();
+}
+
+void Simulator::scheduleVisionTimer()
+{
+    if (m_isPartial || m_visionPackets.isEmpty() || m_timeScaling <= 0) {
+        m_visionTimer->stop();
+        return;
     }
+    const qint64 remaining = std::get<1>(m_visionPackets.head()) - m_timer->currentTime();
+    // timeout is in milliseconds, round up as a packet is never sent early
+    const qint64 timeout = std::ceil(remaining * 1E-6 / m_timeScaling);
+    m_visionTimer->start(std::max(qint64(0), timeout));
+}
 
-    QByteArray d;
-    d.resize(simState.ByteSize());
-    if (!simState.SerializeToArray(d.data(), d.size())) {
-        d = {};
+void Simulator::sendDueVisionPackets()
+{
+    const qint64 now = m_timer->currentTime();
+    while (!m_visionPackets.isEmpty() && std::get<1>(m_visionPackets.head()) <= now) {
+        sendVisionPacket();
     }
-    return {data,d, 0};
+    scheduleVisionTimer();
 }
 
 void Simulator::sendVisionPacket()
 {
     auto currentVisionPackets = m_visionPackets.dequeue();
-    for (const QByteArray &data : std::get<0>(currentVisionPackets)) {
-        emit gotPacket(data, m_timer->currentTime(), "simulator"); // send "vision packet" and assume instant receiving
+    const qint64 jitter = std::abs(m_timer->currentTime() - std::get<1>(currentVisionPackets));
+    m_visionJitterSum += jitter;
+    m_visionJitterMax = std::max(m_visionJitterMax, jitter);
+    m_visionJitterCount++;
+
+    const SimulatorVisionFramePtr &frame = std::get<0>(currentVisionPackets);
+    if (m_visionFrameOutput) {
+        // the receiver reads the frame directly, nothing to serialize
+        emit gotVisionFrame(frame, m_timer->currentTime());
+        return;
+    }
+
+    const qint64 encodeStart = Timer::systemTime();
+    serializeVisionFrame(*frame);
+    m_visionEncodeTime += Timer::systemTime() - encodeStart;
+
+    for (int i = 0; i < int(frame->packets.size()); ++i) {
+        emit gotPacket(m_visionBuffers[i], m_timer->currentTime(), "simulator"); // send "vision packet" and assume instant receiving
         // the receive time may be a bit jittered just like a real transmission
 
     }
-    emit sendRealData(std::get<1>(currentVisionPackets));
-    if (!m_isPartial) {
-        QTimer *timer = m_visionTimers.dequeue();
-        timer->deleteLater();
+    emit sendRealData(m_simulatorStateBuffer);
+}
+
+template<typename Message>
+static void serializeInto(const Message &message, QByteArray &buffer)
+{
+    // resize keeps the capacity of the buffer, it only allocates if the data is still shared with a receiver
+    buffer.resize(message.ByteSize());
+    message.SerializeWithCachedSizesToArray(reinterpret_cast<google::protobuf::uint8*>(buffer.data()));
+}
+
+void Simulator::serializeVisionFrame(const SimulatorVisionFrame &frame)
+{
+    if (m_visionBuffers.size() < int(frame.packets.size())) {
+        m_visionBuffers.resize(frame.packets.size());
+    }
+    for (std::size_t i = 0; i < frame.packets.size(); ++i) {
+        serializeInto(frame.packets[i], m_visionBuffers[i]);
     }
+    serializeInto(frame.simulatorState, m_simulatorStateBuffer);
 }
 
 void Simulator::resetVisionPackets()
 {
-    qDeleteAll(m_visionTimers);
-    m_visionTimers.clear();
+    m_visionTimer->stop();
     m_visionPackets.clear();
 }
 
@@ -582,37 +843,73 @@ void Simulator::handleRadioCommands(const SSLSimRobotControl &commands, bool isB
 
 void Simulator::setTeam(Simulator::RobotMap &list, float side, const robot::Team &team, QMap<uint32_t, robot::Specs>& teamSpecs)
 {
-    // remove old team
-    deleteAll(list);
+    // robots with unchanged specs are kept as they are, the others are rebuilt at their current pose
+    RobotMap oldRobots = list;
     list.clear();
 
-    // changing a team is also triggering a tracking reset
-    // thus the old robots will disappear immediatelly
-    // however if the delayed vision packets arrive the old robots will be tracked again
-    // thus after removing a robot from a team it can take 1 simulated second for the robot to disappear
-    // to prevent this remove outdated vision packets
-    resetVisionPackets();
-
-    // align robots on a line
-    const float x = m_data->geometry.field_width() / 2 - 0.2;
-    float y = m_data->geometry.field_height() / 2 - 0.2;
-
-
+    QList<uint32_t> newRobots;
     for (int i = 0; i < team.robot_size(); i++) {
         const robot::Specs& specs = team.robot(i);
         const auto id = specs.id();
 
         // (color, robot id) must be unique
-        if (list.contains(id)) {
+        if (list.contains(id) || newRobots.contains(id)) {
             std::cerr << "Error: Two ids for the same color, aborting!" << std::endl;
             continue;
         }
         teamSpecs[id].CopyFrom(specs);
 
+        auto old = oldRobots.find(id);
+        if (old == oldRobots.end()) {
+            // placed once the positions of all kept robots are known
+            newRobots.append(id);
+        } else if (google::protobuf::util::MessageDifferencer::Equals(old.value().first->specs(), specs)) {
+            list[id] = old.value();
+            oldRobots.erase(old);
+        } else {
+            SimRobot *oldRobot = old.value().first;
+            const btVector3 position = oldRobot->position() / SIMULATOR_SCALE;
+            const btVector3 linearVelocity = oldRobot->velocity();
+            const btVector3 angularVelocity = oldRobot->angularVelocity();
+            btScalar yaw, pitch, roll;
+            oldRobot->transform().getBasis().getEulerZYX(yaw, pitch, roll);
+            delete oldRobot;
+            oldRobots.erase(old);
+            createRobot(list, position.x(), position.y(), id, m_aggregator, m_data, teamSpecs, yaw + M_PI_2);
+            list[id].first->setVelocity(linearVelocity, angularVelocity);
+        }
+    }
 
-
+    // align new robots on a line, skipping the places which are occupied by a kept robot
+    const float x = m_data->geometry.field_width() / 2 - 0.2;
+    float y = m_data->geometry.field_height() / 2 - 0.2;
+    const float SLOT_DISTANCE = 0.3f;
+    auto isOccupied = [&list, x, side](float y) {
+        const btVector3 slot(x, side * y, 0);
+        for (const auto &robot : list) {
+            if ((robot.first->position() / SIMULATOR_SCALE - slot).length() < SLOT_DISTANCE) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (uint32_t id : newRobots) {
+        while (isOccupied(y)) {
+            y -= SLOT_DISTANCE;
+        }
         createRobot(list, x, side * y, id, m_aggregator, m_data, teamSpecs);
-        y -= 0.3;
+        y -= SLOT_DISTANCE;
+    }
+
+    if (!oldRobots.isEmpty()) {
+        deleteAll(oldRobots);
+
+        // changing a team is also triggering a tracking reset
+        // thus the old robots will disappear immediatelly
+        // however if the delayed vision packets arrive the old robots will be tracked again
+        // thus after removing a robot from a team it can take 1 simulated second for the robot to disappear
+        // to prevent this remove outdated vision packets
+        resetVisionPackets();
     }
 }
 
@@ -726,10 +1023,17 @@ void Simulator::setFlipped(bool flipped)
 
 void Simulator::handleCommand(const Command &command)
 {
-    bool teamOrPerfectDribbleChanged = false;
+    bool teamOrRobotModeChanged = false;
+    const qint64 reconfigureStart = Timer::systemTime();
+    bool reconfigured = false;
 
     if (command->has_simulator()) {
         const amun::CommandSimulator &sim = command->simulator();
+        if (sim.has_simulator_setup()) {
+            setSetup(sim.simulator_setup());
+            reconfigured = true;
+        }
+
         if (sim.has_enable()) {
             m_enabled = sim.enable();
             m_time = m_timer->currentTime();
@@ -805,12 +1109,17 @@ void Simulator::handleCommand(const Command &command)
 
             if (realism.has_simulate_dribbling()) {
                 m_data->dribblePerfect = !realism.simulate_dribbling();
-                teamOrPerfectDribbleChanged = true;
+                teamOrRobotModeChanged = true;
             }
 
             if (realism.has_command_delay()) {
                 m_data->commandDelay = realism.command_delay();
             }
+
+            if (realism.has_simplified_physics()) {
+                m_data->simplifiedPhysics = realism.simplified_physics();
+                teamOrRobotModeChanged = true;
+            }
         }
 
         if (sim.has_ssl_control()) {
@@ -823,6 +1132,10 @@ void Simulator::handleCommand(const Command &command)
             }
         }
 
+        if (sim.has_measure_step_timing()) {
+            m_data->timings = SimulatorTimings { sim.measure_step_timing() };
+        }
+
         if (sim.has_vision_worst_case()) {
             if (sim.vision_worst_case().has_min_ball_detection_time()) {
                 m_minBallDetectionTime = sim.vision_worst_case().min_ball_detection_time() * 1E9;
@@ -856,20 +1169,27 @@ void Simulator::handleCommand(const Command &command)
     }
 
     if (command->has_set_team_blue()) {
-        teamOrPerfectDribbleChanged = true;
+        teamOrRobotModeChanged = true;
+        reconfigured = true;
         setTeam(m_data->robotsBlue, 1.0f, command->set_team_blue(), m_data->specsBlue);
     }
 
     if (command->has_set_team_yellow()) {
-        teamOrPerfectDribbleChanged = true;
+        teamOrRobotModeChanged = true;
+        reconfigured = true;
         setTeam(m_data->robotsYellow, -1.0f, command->set_team_yellow(), m_data->specsYellow);
     }
 
-    if (teamOrPerfectDribbleChanged) {
+    if (reconfigured) {
+        m_reconfigureTime += Timer::systemTime() - reconfigureStart;
+    }
+
+    if (teamOrRobotModeChanged) {
         for (const auto& robotList : {m_data->robotsBlue, m_data->robotsYellow}) {
             for (const auto& it : robotList) {
                 SimRobot *robot = it.first;
                 robot->setDribbleMode(m_data->dribblePerfect);
+                robot->setSimplifiedPhysics(m_data->simplifiedPhysics);
             }
         }
     }
@@ -877,6 +1197,8 @@ void Simulator::handleCommand(const Command &command)
 
 void Simulator::setScaling(double scaling)
 {
+    // needed if scaling is set before simulator was enabled
+    m_timeScaling = scaling;
     if (scaling <= 0 || !m_enabled) {
         m_trigger->stop();
         // clear pending vision packets
@@ -886,20 +1208,116 @@ void Simulator::setScaling(double scaling)
         const int t = 5 / scaling;
         m_trigger->start(qMax(1, t));
 
-        // The vision packet timings are wrong after a scaling change
-        // In addition if the new scaling is larger than the old one,
-        // this would cause the timers started after the scaling change
-        // to trigger before the old timers, what causes the deletion of
-        // the old timers before they are fired.
-        resetVisionPackets();
+        // the send times of the pending vision packets are in simulated time,
+        // thus only the timeout of the vision timer has to be updated
+        scheduleVisionTimer();
     }
-    // needed if scaling is set before simulator was enabled
-    m_timeScaling = scaling;
 }
 
 void Simulator::seedPRGN(uint32_t seed)
 {
     m_data->rng.seed(seed);
+    rand_shuffle_src.seed(seed);
+}
+
+static void saveRobots(const Simulator::RobotMap &robots, SimulatorSnapshot::RobotMap &snapshot)
+{
+    for (auto it = robots.begin(); it != robots.end(); ++it) {
+        SimulatorSnapshot::Robot &robot = snapshot[it.key()];
+        robot.specs.CopyFrom(it.value().first->specs());
+        robot.generation = it.value().second;
+        it.value().first->saveSnapshot(&robot.state);
+    }
+}
+
+std::shared_ptr<const SimulatorSnapshot> Simulator::checkpoint() const
+{
+    auto snapshot = std::make_shared<SimulatorSnapshot>();
+    snapshot->time = m_time;
+    snapshot->lastSentStatusTime = m_lastSentStatusTime;
+    snapshot->lastBallSendTime = m_lastBallSendTime;
+    snapshot->charge = m_charge;
+    snapshot->localTime = m_data->dynamicsWorld->localTime();
+    snapshot->rng = m_data->rng;
+    snapshot->shuffleRng = rand_shuffle_src;
+    snapshot->lastFrameNumber = m_lastFrameNumber;
+    // the commands and packets are immutable once queued, thus copying only shares them
+    snapshot->radioCommands = m_radioCommands;
+    snapshot->visionPackets = m_visionPackets;
+    snapshot->specsBlue = m_data->specsBlue;
+    snapshot->specsYellow = m_data->specsYellow;
+    saveRobots(m_data->robotsBlue, snapshot->robotsBlue);
+    saveRobots(m_data->robotsYellow, snapshot->robotsYellow);
+    m_data->ball->saveSnapshot(&snapshot->ball);
+    return snapshot;
+}
+
+static bool robotsMatch(const Simulator::RobotMap &robots, const SimulatorSnapshot::RobotMap &snapshot)
+{
+    if (robots.size() != snapshot.size()) {
+        return false;
+    }
+    for (auto it = robots.begin(); it != robots.end(); ++it) {
+        auto snapshotIt = snapshot.find(it.key());
+        if (snapshotIt == snapshot.end() || snapshotIt->generation != it.value().second
+                || snapshotIt->specs.SerializeAsString() != it.value().first->specs().SerializeAsString()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void restoreRobotSnapshots(Simulator::RobotMap &robots, const SimulatorSnapshot::RobotMap &snapshot, SimulatorData *data, const ErrorAggregator *agg)
+{
+    // only recreate the robots if the team has changed since the checkpoint
+    if (!robotsMatch(robots, snapshot)) {
+        deleteAll(robots);
+        robots.clear();
+        for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+            SimRobot *robot = new SimRobot(&data->rng, it->specs, data->dynamicsWorld, btVector3(0, 0, 0), 0.0f);
+            robot->setDribbleMode(data->dribblePerfect);
+            robot->setSimplifiedPhysics(data->simplifiedPhysics);
+            robot->connect(robot, &SimRobot::sendSSLSimError, agg, &ErrorAggregator::aggregate);
+            robots[it.key()] = {robot, it->generation};
+        }
+    }
+    for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+        robots[it.key()].first->restoreSnapshot(it->state, data->ball);
+    }
+}
+
+void Simulator::restore(const SimulatorSnapshot &snapshot)
+{
+    m_time = snapshot.time;
+    m_lastSentStatusTime = snapshot.lastSentStatusTime;
+    m_lastBallSendTime = snapshot.lastBallSendTime;
+    m_charge = snapshot.charge;
+    m_data->rng = snapshot.rng;
+    rand_shuffle_src = snapshot.shuffleRng;
+    m_lastFrameNumber = snapshot.lastFrameNumber;
+    m_radioCommands = snapshot.radioCommands;
+
+    // the send times are simulation times, in realtime mode the vision timer is rescheduled for them
+    resetVisionPackets();
+    m_visionPackets = snapshot.visionPackets;
+    scheduleVisionTimer();
+
+    m_data->specsBlue = snapshot.specsBlue;
+    m_data->specsYellow = snapshot.specsYellow;
+    m_data->ball->restoreSnapshot(snapshot.ball);
+    restoreRobotSnapshots(m_data->robotsBlue, snapshot.robotsBlue, m_data, m_aggregator);
+    restoreRobotSnapshots(m_data->robotsYellow, snapshot.robotsYellow, m_data, m_aggregator);
+
+    // drop the cached contacts, they belong to the previous positions. Consequently every
+    // restore of a snapshot continues identically, but may differ slightly from the original run
+    btCollisionObjectArray &objects = m_data->dynamicsWorld->getCollisionObjectArray();
+    btOverlappingPairCache *pairCache = m_data->overlappingPairCache->getOverlappingPairCache();
+    for (int i = 0; i < objects.size(); i++) {
+        pairCache->cleanProxyFromPairs(objects[i]->getBroadphaseHandle(), m_data->dispatcher);
+        m_data->dynamicsWorld->updateSingleAabb(objects[i]);
+    }
+    m_data->solver->reset();
+    m_data->dynamicsWorld->setLocalTime(snapshot.localTime);
 }
 
 static bool overlapCheck(const btVector3& p0, const float& r0, const btVector3& p1, const float& r1)
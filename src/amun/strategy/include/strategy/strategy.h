@@ -48,6 +48,7 @@ namespace v8 {
 class InspectorHandler;
 class CompilerRegistry;
 class ProtobufFileSaver;
+class ProfileSamples;
 
 class Strategy : public QObject
 {
@@ -82,6 +83,7 @@ public slots:
 
 private slots:
     void process();
+    void performIdleTasks();
     void reload();
     void sendCommand(const Command &command);
     void loadStateChanged(amun::StatusStrategy::STATE state);
@@ -99,6 +101,9 @@ private:
     void createDummyTeam();
     bool updateTeam(const robot::Team &team, StrategyType teamType, bool isReplayTeam);
     world::State assembleWorldState();
+    void startContinuousProfiling(int samplingInterval);
+    void collectProfileSamples(bool stop);
+    void stopContinuousProfiling(const QString &filename);
 
 private:
     StrategyPrivate * const m_p;
@@ -121,6 +126,7 @@ private:
     std::optional<SSL_Referee::Stage> m_lastReceivedStage;
 
     QTimer *m_idleTimer;
+    QTimer *m_idleTaskTimer;
     QTimer *m_reloadTimer;
     bool m_autoReload;
     bool m_strategyFailed;
@@ -132,6 +138,8 @@ private:
     robot::Specs m_anyRobotSpec;
 
     CompilerRegistry* m_compilerRegistry;
+    // only set while continuous profiling is active
+    std::unique_ptr<ProfileSamples> m_profileSamples;
 
     std::shared_ptr<StrategyGameControllerMediator> m_gameControllerConnection;
 
@@ -25,6 +25,7 @@
 #include <QString>
 #include <QStringList>
 #include <Eigen/Dense>
+#include <memory>
 #include "strategy/script/abstractstrategyscript.h"
 #include "strategy/script/strategytype.h"
 
@@ -32,6 +33,7 @@ class DebugHelper;
 class FileWatcher;
 class Lua;
 class ScriptState;
+struct LuaFFIState;
 
 Lua *getStrategyThread(lua_State *state);
 
@@ -51,6 +53,7 @@ public:
     void watch(const QString &filename);
     QString debuggerRead();
     bool debuggerWrite(const QString& line);
+    LuaFFIState *ffiState();
 protected:
     void loadScript(const QString &filename, const QString &entryPoint) override;
     bool process(double &pathPlanning) override;
@@ -69,6 +72,7 @@ private slots:
 private:
     lua_State *m_state;
     FileWatcher *m_watcher;
+    std::unique_ptr<LuaFFIState> m_ffiState;
 
     qint64 m_startTime;
 
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LUA_FFI_H
+#define LUA_FFI_H
+
+#include <cstdint>
+
+namespace amun { class GameState; }
+namespace robot { class Command; }
+namespace world { class State; }
+
+#define LUA_FFI_MAX_ROBOTS 32
+#define LUA_FFI_MAX_RAW_BALLS 16
+#define LUA_FFI_MAX_YELLOW_CARDS 8
+#define LUA_FFI_MAX_SPLINES 16
+
+// Plain structs shared with LuaJIT, the same text is passed to ffi.cdef to guarantee an identical layout.
+// All positions and speeds are in global coordinates, unset optional values are NaN.
+// The time values are in nanoseconds, just like the protobuf messages
+#define LUA_FFI_DECLARATIONS \
+typedef struct { double time; float p_x, p_y; } amun_ffi_ball_position; \
+typedef struct { \
+    float p_x, p_y, p_z, v_x, v_y, v_z; \
+    float touchdown_x, touchdown_y, max_speed; \
+    bool is_bouncing; \
+    int32_t raw_count; \
+    amun_ffi_ball_position raw[LUA_FFI_MAX_RAW_BALLS]; \
+} amun_ffi_ball; \
+typedef struct { uint32_t id; float p_x, p_y, phi, v_x, v_y, omega; } amun_ffi_robot; \
+typedef struct { \
+    double time; \
+    bool is_simulated, has_vision_data, has_ball; \
+    amun_ffi_ball ball; \
+    int32_t yellow_count, blue_count; \
+    amun_ffi_robot yellow[LUA_FFI_MAX_ROBOTS]; \
+    amun_ffi_robot blue[LUA_FFI_MAX_ROBOTS]; \
+} amun_ffi_world_state; \
+typedef struct { \
+    uint32_t goalie, red_cards, yellow_card_count; \
+    uint32_t yellow_card_times[LUA_FFI_MAX_YELLOW_CARDS]; \
+} amun_ffi_team_info; \
+typedef struct { \
+    int32_t state, stage; \
+    bool has_designated_position; \
+    float designated_x, designated_y; \
+    amun_ffi_team_info yellow, blue; \
+} amun_ffi_game_state; \
+typedef struct { float t_start, t_end; float x[4], y[4], phi[4]; } amun_ffi_spline; \
+typedef struct { \
+    uint32_t generation, id; \
+    int32_t spline_count; \
+    amun_ffi_spline spline[LUA_FFI_MAX_SPLINES]; \
+    float v_f, v_s, omega; \
+    int32_t kick_style; \
+    float kick_power, dribbler; \
+    bool force_kick, standby; \
+} amun_ffi_command; \
+typedef struct { \
+    int32_t count; \
+    amun_ffi_command command[LUA_FFI_MAX_ROBOTS]; \
+} amun_ffi_commands;
+
+extern "C" {
+LUA_FFI_DECLARATIONS
+}
+
+struct LuaFFIState
+{
+    amun_ffi_world_state worldState;
+    amun_ffi_game_state gameState;
+    amun_ffi_commands commands;
+};
+
+const char *ffiDeclarations();
+void ffiFillWorldState(amun_ffi_world_state &out, const world::State &state);
+void ffiFillGameState(amun_ffi_game_state &out, const amun::GameState &state);
+// a spline_count of -1 means that no controller input is set
+void ffiToCommand(const amun_ffi_command &in, robot::Command &command);
+
+#endif // LUA_FFI_H
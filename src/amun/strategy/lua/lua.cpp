@@ -23,6 +23,7 @@
 #include "lua_path.h"
 #include "lua_protobuf.h"
 #include "lua_eigen.h"
+#include "lua_ffi.h"
 #include "core/timer.h"
 #include "strategy/script/debughelper.h"
 #include "strategy/script/filewatcher.h"
@@ -445,6 +446,15 @@ bool Lua::debuggerWrite(const QString &line)
     return true;
 }
 
+LuaFFIState *Lua::ffiState()
+{
+    // the structs are only allocated if the strategy uses them, the address must stay valid for the lifetime of the lua state
+    if (!m_ffiState) {
+        m_ffiState.reset(new LuaFFIState());
+    }
+    return m_ffiState.get();
+}
+
 void Lua::loadLibs()
 {
     loadLib("", luaopen_base);
@@ -20,10 +20,12 @@
 
 #include "lua.h"
 #include "lua_amun.h"
+#include "lua_ffi.h"
 #include "lua_protobuf.h"
 #include "protobuf/ssl_game_controller_team.pb.h"
 #include "protobuf/ssl_game_controller_auto_ref.pb.h"
 #include <QtEndian>
+#include <google/protobuf/descriptor.h>
 #include "strategy/script/scriptstate.h"
 
 static int amunGetGeometry(lua_State *state)
@@ -407,6 +409,93 @@ static int amunGetPerformanceMode(lua_State *state)
     return 1;
 }
 
+static void pushEnumNames(lua_State *state, const google::protobuf::EnumDescriptor *descriptor)
+{
+    lua_createtable(state, 0, descriptor->value_count());
+    for (int i = 0; i < descriptor->value_count(); i++) {
+        const google::protobuf::EnumValueDescriptor *value = descriptor->value(i);
+        lua_pushstring(state, value->name().c_str());
+        lua_rawseti(state, -2, value->number());
+    }
+}
+
+static int amunGetFFIInterface(lua_State *state)
+{
+    Lua *thread = getStrategyThread(state);
+    LuaFFIState *ffiState = thread->ffiState();
+
+    lua_createtable(state, 0, 8);
+    lua_pushstring(state, ffiDeclarations());
+    lua_setfield(state, -2, "declarations");
+    lua_pushinteger(state, LUA_FFI_MAX_ROBOTS);
+    lua_setfield(state, -2, "maxRobots");
+    lua_pushinteger(state, LUA_FFI_MAX_SPLINES);
+    lua_setfield(state, -2, "maxSplines");
+    // pointers to the native structs, to be cast with ffi.cast
+    lua_pushlightuserdata(state, &ffiState->worldState);
+    lua_setfield(state, -2, "worldState");
+    lua_pushlightuserdata(state, &ffiState->gameState);
+    lua_setfield(state, -2, "gameState");
+    lua_pushlightuserdata(state, &ffiState->commands);
+    lua_setfield(state, -2, "commands");
+    // the game state only contains the enum values
+    pushEnumNames(state, amun::GameState::State_descriptor());
+    lua_setfield(state, -2, "gameStateNames");
+    pushEnumNames(state, SSL_Referee::Stage_descriptor());
+    lua_setfield(state, -2, "gameStageNames");
+    return 1;
+}
+
+static int amunUpdateFFIState(lua_State *state)
+{
+    Lua *thread = getStrategyThread(state);
+    LuaFFIState *ffiState = thread->ffiState();
+    const world::State &worldState = thread->worldState();
+    ffiFillWorldState(ffiState->worldState, worldState);
+    ffiFillGameState(ffiState->gameState, thread->refereeState());
+
+    // the remaining parts of the world state are rarely set and too irregular for a struct
+    if (worldState.radio_response_size() == 0 && !worldState.has_mixed_team_info() && !worldState.has_tracking_aoi()) {
+        lua_pushnil(state);
+        return 1;
+    }
+    world::State extra;
+    extra.set_time(worldState.time());
+    extra.mutable_radio_response()->CopyFrom(worldState.radio_response());
+    if (worldState.has_mixed_team_info()) {
+        extra.mutable_mixed_team_info()->CopyFrom(worldState.mixed_team_info());
+    }
+    if (worldState.has_tracking_aoi()) {
+        extra.mutable_tracking_aoi()->CopyFrom(worldState.tracking_aoi());
+    }
+    protobufPushMessage(state, extra);
+    return 1;
+}
+
+static int amunSetFFICommands(lua_State *state)
+{
+    Lua *thread = getStrategyThread(state);
+    const amun_ffi_commands &commands = thread->ffiState()->commands;
+    if (commands.count < 0 || commands.count > LUA_FFI_MAX_ROBOTS) {
+        luaL_error(state, "Invalid command count %d", commands.count);
+        return 0;
+    }
+
+    QList<RobotCommandInfo> commandInfos;
+    commandInfos.reserve(commands.count);
+    for (int i = 0; i < commands.count; i++) {
+        const amun_ffi_command &command = commands.command[i];
+        RobotCommandInfo commandInfo;
+        commandInfo.command = RobotCommand(new robot::Command);
+        commandInfo.generation = command.generation;
+        commandInfo.robotId = command.id;
+        ffiToCommand(command, *commandInfo.command);
+        commandInfos.append(commandInfo);
+    }
+    thread->setCommands(commandInfos);
+    return 0;
+}
+
 static int amunGetTestStatus(lua_State *state)
 {
     // NOTE: the world state in this status packet is not the same as the one returned by amunGetWorldState
@@ -431,8 +520,11 @@ static const luaL_Reg amunMethods[] = {
     {"getCurrentTime",      amunGetCurrentTime},
     {"getPerformanceMode",  amunGetPerformanceMode},
     {"isFlipped",           amunIsFlipped},
+    {"getFFIInterface",     amunGetFFIInterface},
+    {"updateFFIState",      amunUpdateFFIState},
     // control + visualization
     {"setCommand",          amunSetCommand},
+    {"setFFICommands",      amunSetFFICommands},
     {"log",                 amunLog},
     {"addVisualization",    amunAddVisualization},
     {"addVisualizationCircle", amunAddVisualizationCircle},
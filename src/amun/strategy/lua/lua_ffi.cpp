@@ -0,0 +1,146 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "lua_ffi.h"
+#include "protobuf/gamestate.pb.h"
+#include "protobuf/robot.pb.h"
+#include "protobuf/world.pb.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#define LUA_FFI_STRINGIFY(...) #__VA_ARGS__
+#define LUA_FFI_EXPAND_STRINGIFY(...) LUA_FFI_STRINGIFY(__VA_ARGS__)
+
+const char *ffiDeclarations()
+{
+    return LUA_FFI_EXPAND_STRINGIFY(LUA_FFI_DECLARATIONS);
+}
+
+static const float NOT_SET = std::numeric_limits<float>::quiet_NaN();
+
+static void fillRobots(amun_ffi_robot *out, int32_t &count, const google::protobuf::RepeatedPtrField<world::Robot> &robots)
+{
+    count = std::min(robots.size(), LUA_FFI_MAX_ROBOTS);
+    for (int i = 0; i < count; i++) {
+        const world::Robot &robot = robots.Get(i);
+        out[i] = { robot.id(), robot.p_x(), robot.p_y(), robot.phi(), robot.v_x(), robot.v_y(), robot.omega() };
+    }
+}
+
+static void fillBall(amun_ffi_ball &out, const world::Ball &ball)
+{
+    out.p_x = ball.p_x();
+    out.p_y = ball.p_y();
+    out.p_z = ball.has_p_z() ? ball.p_z() : NOT_SET;
+    out.v_x = ball.v_x();
+    out.v_y = ball.v_y();
+    out.v_z = ball.has_v_z() ? ball.v_z() : NOT_SET;
+    const bool hasTouchdown = ball.has_touchdown_x() && ball.has_touchdown_y();
+    out.touchdown_x = hasTouchdown ? ball.touchdown_x() : NOT_SET;
+    out.touchdown_y = hasTouchdown ? ball.touchdown_y() : NOT_SET;
+    out.max_speed = ball.has_max_speed() ? ball.max_speed() : NOT_SET;
+    out.is_bouncing = ball.is_bouncing();
+
+    out.raw_count = std::min(ball.raw_size(), LUA_FFI_MAX_RAW_BALLS);
+    for (int i = 0; i < out.raw_count; i++) {
+        const world::BallPosition &raw = ball.raw(i);
+        out.raw[i] = { double(raw.time()), raw.p_x(), raw.p_y() };
+    }
+}
+
+void ffiFillWorldState(amun_ffi_world_state &out, const world::State &state)
+{
+    out.time = state.time();
+    out.is_simulated = state.is_simulated();
+    // only a missing vision frame is reported explicitly
+    out.has_vision_data = !state.has_has_vision_data() || state.has_vision_data();
+    out.has_ball = state.has_ball();
+    if (state.has_ball()) {
+        fillBall(out.ball, state.ball());
+    }
+    fillRobots(out.yellow, out.yellow_count, state.yellow());
+    fillRobots(out.blue, out.blue_count, state.blue());
+}
+
+static void fillTeamInfo(amun_ffi_team_info &out, const SSL_Referee::TeamInfo &info)
+{
+    out.goalie = info.goalie();
+    out.red_cards = info.red_cards();
+    out.yellow_card_count = std::min(info.yellow_card_times_size(), LUA_FFI_MAX_YELLOW_CARDS);
+    for (uint32_t i = 0; i < out.yellow_card_count; i++) {
+        out.yellow_card_times[i] = info.yellow_card_times(i);
+    }
+}
+
+void ffiFillGameState(amun_ffi_game_state &out, const amun::GameState &state)
+{
+    out.state = state.state();
+    out.stage = state.stage();
+    out.has_designated_position = state.has_designated_position()
+            && state.designated_position().has_x() && state.designated_position().has_y();
+    out.designated_x = out.has_designated_position ? state.designated_position().x() : NOT_SET;
+    out.designated_y = out.has_designated_position ? state.designated_position().y() : NOT_SET;
+    fillTeamInfo(out.yellow, state.yellow());
+    fillTeamInfo(out.blue, state.blue());
+}
+
+static void setPolynomial(robot::Polynomial *polynomial, const float *a)
+{
+    polynomial->set_a0(a[0]);
+    polynomial->set_a1(a[1]);
+    polynomial->set_a2(a[2]);
+    polynomial->set_a3(a[3]);
+}
+
+void ffiToCommand(const amun_ffi_command &in, robot::Command &command)
+{
+    if (in.spline_count >= 0) {
+        robot::ControllerInput *input = command.mutable_controller();
+        const int splineCount = std::min(in.spline_count, LUA_FFI_MAX_SPLINES);
+        for (int i = 0; i < splineCount; i++) {
+            const amun_ffi_spline &s = in.spline[i];
+            robot::Spline *spline = input->add_spline();
+            spline->set_t_start(s.t_start);
+            spline->set_t_end(s.t_end);
+            setPolynomial(spline->mutable_x(), s.x);
+            setPolynomial(spline->mutable_y(), s.y);
+            setPolynomial(spline->mutable_phi(), s.phi);
+        }
+    }
+    if (!std::isnan(in.v_f)) {
+        command.set_v_f(in.v_f);
+    }
+    if (!std::isnan(in.v_s)) {
+        command.set_v_s(in.v_s);
+    }
+    if (!std::isnan(in.omega)) {
+        command.set_omega(in.omega);
+    }
+    if (robot::Command::KickStyle_IsValid(in.kick_style)) {
+        command.set_kick_style(robot::Command::KickStyle(in.kick_style));
+    }
+    if (in.kick_power > 0) {
+        command.set_kick_power(in.kick_power);
+    }
+    command.set_dribbler(in.dribbler);
+    command.set_force_kick(in.force_kick);
+    command.set_standby(in.standby);
+}
@@ -132,6 +132,9 @@ private:
         void deserialize(const pathfinding::StandardSamplerPrecomputationSegment &segment);
     };
 
+    // the precomputation file is only read once per process
+    static const std::vector<PrecomputationSegment> &sharedPrecomputation();
+
     std::vector<PrecomputationSegment> m_precomputation;
 };
 
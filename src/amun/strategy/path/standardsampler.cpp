@@ -121,19 +121,9 @@ void LiveStandardSampler::computeSamples(const TrajectoryInput &input, const Sta
 }
 
 PrecomputedStandardSampler::PrecomputedStandardSampler(RNG *rng, const WorldInformation &world, PathDebug &debug) :
-    StandardSampler(rng, world, debug)
+    StandardSampler(rng, world, debug),
+    m_precomputation(sharedPrecomputation())
 {
-    // load precomputed points
-    ProtobufFileReader reader;
-    reader.open(QString(ERFORCE_DATADIR) + "precomputation/standardsampler.prec", "KHONSU PRECOMPUTATION");
-    pathfinding::StandardSamplerPrecomputation precomp;
-    reader.readNext(precomp);
-    for (const auto &a : precomp.segments()) {
-        PrecomputationSegment segment;
-        segment.deserialize(a);
-        m_precomputation.push_back(segment);
-    }
-
     // check validity
     assert (m_precomputation.size() > 0);
     for (const auto &segment : m_precomputation) {
@@ -142,6 +132,27 @@ PrecomputedStandardSampler::PrecomputedStandardSampler(RNG *rng, const WorldInfo
     }
 }
 
+const std::vector<PrecomputedStandardSampler::PrecomputationSegment> &PrecomputedStandardSampler::sharedPrecomputation()
+{
+    // every path planner has its own sampler, avoid parsing the file for each one
+    // the initialization of static locals is thread safe
+    static const std::vector<PrecomputationSegment> precomputation = []() {
+        std::vector<PrecomputationSegment> segments;
+        // load precomputed points
+        ProtobufFileReader reader;
+        reader.open(QString(ERFORCE_DATADIR) + "precomputation/standardsampler.prec", "KHONSU PRECOMPUTATION");
+        pathfinding::StandardSamplerPrecomputation precomp;
+        reader.readNext(precomp);
+        for (const auto &a : precomp.segments()) {
+            PrecomputationSegment segment;
+            segment.deserialize(a);
+            segments.push_back(segment);
+        }
+        return segments;
+    }();
+    return precomputation;
+}
+
 int PrecomputedStandardSampler::numSamples() const
 {
     return m_precomputation.size() * m_precomputation[0].samples.size();
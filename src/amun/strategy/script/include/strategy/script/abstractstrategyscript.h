@@ -42,6 +42,7 @@ class DebugHelper;
 class Timer;
 
 class CompilerRegistry;
+class ProfileSamples;
 class ScriptState;
 
 class AbstractStrategyScript : public QObject
@@ -63,10 +64,18 @@ public:
     virtual bool triggerDebugger();
     virtual void startProfiling() {}
     virtual void endProfiling(const std::string &filename) {}
+    // samples until takeProfileSamples is called with stop set, interval in microseconds
+    virtual void startContinuousProfiling(int samplingInterval) { (void) samplingInterval; }
+    virtual void takeProfileSamples(ProfileSamples &samples, bool stop) { (void) samples; (void) stop; }
     virtual bool canReloadInPlace() const { return false; }
     virtual bool canHandleDynamic(const QString &filename) const = 0;
     // may not be called before calling loadScript at least once
     virtual void compileIfNecessary() {}
+    // called after the results of process were published, the script may use the time
+    // until deadline for housekeeping. The deadline is given in seconds of the v8 platform clock
+    virtual void performIdleTasks(double deadline) { (void) deadline; }
+    // returns the heap statistics since the last call or false if the script provides none
+    virtual bool takeHeapTiming(amun::StrategyHeapTiming &timing) { (void) timing; return false; }
 
     const ScriptState& state() const { return m_scriptState; };
     ScriptState& state() { return m_scriptState; };
@@ -22,12 +22,17 @@
 
 #include <functional>
 #include <memory>
+#include <QByteArray>
+#include <QHash>
 #include <QObject>
+#include <QString>
 
 class QFileInfo;
-class QString;
 class QThread;
 
+// maps the absolute paths of compile result files to their content
+using CompileResultFiles = QHash<QString, QByteArray>;
+
 class Compiler : public QObject
 {
     Q_OBJECT
@@ -36,9 +41,10 @@ public:
     virtual ~Compiler() = default;
 
     virtual QFileInfo mapToResult(const QFileInfo& src) = 0;
-    virtual bool requestPause() = 0;
-    virtual void resume() = 0;
     virtual bool isResultAvailable() = 0;
+    // result files written by this compiler, the returned map is never modified.
+    // Files that are not contained have to be read from disk
+    virtual std::shared_ptr<const CompileResultFiles> resultFiles() = 0;
 public slots:
     virtual void init() = 0;
     virtual void compile() = 0;
@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef PROFILESAMPLES_H
+#define PROFILESAMPLES_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Profiler samples aggregated by call stack
+ *
+ * Samples of several profiles, e.g. of strategy instances replaced by a reload, can be added
+ * to the same instance. The result is either written as collapsed stacks, as used by flamegraph.pl
+ * and most diff tools, or as a speedscope profile.
+ */
+class ProfileSamples
+{
+public:
+    // interval between two samples in microseconds
+    explicit ProfileSamples(int samplingInterval) : m_samplingInterval(samplingInterval) {}
+
+    int samplingInterval() const { return m_samplingInterval; }
+    bool isEmpty() const { return m_stacks.isEmpty(); }
+    // the frames are ordered from the root to the leaf
+    void add(const QStringList &stack, qint64 count);
+
+    QByteArray toCollapsedStacks() const;
+    QByteArray toSpeedscope(const QString &name) const;
+    // writes a speedscope profile if the filename ends with .json, collapsed stacks otherwise
+    bool save(const QString &filename, const QString &name) const;
+
+private:
+    int m_samplingInterval;
+    QHash<QStringList, qint64> m_stacks;
+};
+
+#endif // PROFILESAMPLES_H
@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "profilesamples.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <algorithm>
+
+void ProfileSamples::add(const QStringList &stack, qint64 count)
+{
+    if (count > 0 && !stack.isEmpty()) {
+        m_stacks[stack] += count;
+    }
+}
+
+QByteArray ProfileSamples::toCollapsedStacks() const
+{
+    QHash<QString, qint64> collapsed;
+    for (auto it = m_stacks.begin(); it != m_stacks.end(); ++it) {
+        QStringList frames;
+        for (QString frame : it.key()) {
+            // the separators of the format must not appear in the frame names
+            frames.append(frame.replace(';', ',').replace('\n', ' '));
+        }
+        collapsed[frames.join(';')] += it.value();
+    }
+    QStringList keys = collapsed.keys();
+    std::sort(keys.begin(), keys.end());
+
+    QByteArray result;
+    for (const QString &key : keys) {
+        result += key.toUtf8() + ' ' + QByteArray::number(collapsed[key]) + '\n';
+    }
+    return result;
+}
+
+QByteArray ProfileSamples::toSpeedscope(const QString &name) const
+{
+    QJsonArray frames;
+    QHash<QString, int> frameIndices;
+    QJsonArray samples;
+    QJsonArray weights;
+    qint64 total = 0;
+
+    // a stable order makes the output of two profiles easy to diff
+    QList<QStringList> stacks = m_stacks.keys();
+    std::sort(stacks.begin(), stacks.end(), [](const QStringList &a, const QStringList &b) {
+        return a.join(';') < b.join(';');
+    });
+    for (const QStringList &stack : stacks) {
+        QJsonArray sample;
+        for (const QString &frame : stack) {
+            auto index = frameIndices.find(frame);
+            if (index == frameIndices.end()) {
+                index = frameIndices.insert(frame, frames.size());
+                frames.append(QJsonObject{{"name", frame}});
+            }
+            sample.append(index.value());
+        }
+        const qint64 weight = m_stacks[stack] * m_samplingInterval;
+        samples.append(sample);
+        weights.append(double(weight));
+        total += weight;
+    }
+
+    QJsonObject profile;
+    profile["type"] = "sampled";
+    profile["name"] = name;
+    profile["unit"] = "microseconds";
+    profile["startValue"] = 0;
+    profile["endValue"] = double(total);
+    profile["samples"] = samples;
+    profile["weights"] = weights;
+
+    QJsonObject file;
+    file["$schema"] = "https://www.speedscope.app/file-format-schema.json";
+    file["shared"] = QJsonObject{{"frames", frames}};
+    file["profiles"] = QJsonArray{profile};
+    file["name"] = name;
+    file["exporter"] = "Ra";
+    return QJsonDocument(file).toJson(QJsonDocument::Compact);
+}
+
+bool ProfileSamples::save(const QString &filename, const QString &name) const
+{
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    const QByteArray content = filename.endsWith(".json") ? toSpeedscope(name) : toCollapsedStacks();
+    return file.write(content) == content.size() && file.commit();
+}
@@ -23,6 +23,7 @@
 #include "strategy.h"
 #include "strategy/script/debughelper.h"
 #include "strategy/script/compilerregistry.h"
+#include "strategy/script/profilesamples.h"
 #include "core/timer.h"
 #include "config/config.h"
 #include "protobuf/geometry.h"
@@ -40,6 +41,7 @@
 #include <QtGlobal>
 
 #ifdef V8_FOUND
+#include "strategy/typescript/isolatepool.h"
 #include "strategy/typescript/typescript.h"
 #include <v8.h>
 #include <libplatform/libplatform.h>
@@ -56,12 +58,19 @@ public:
     QHostAddress mixedTeamHost;
     quint16 mixedTeamPort;
     QByteArray mixedTeamData;
+#ifdef V8_FOUND
+    // must outlive the strategy instance
+    IsolatePool isolatePool;
+#endif
 };
 
 #ifdef V8_FOUND
 // default initialization
 std::unique_ptr<v8::Platform> Strategy::static_platform;
 
+// time in seconds a strategy may spend on garbage collection after each run
+static const double IDLE_TASK_BUDGET = 0.002;
+
 void Strategy::initV8() {
     if (static_platform) {
         return;
@@ -117,6 +126,12 @@ Strategy::Strategy(const Timer *timer, StrategyType type, DebugHelper *helper, C
     m_idleTimer->setInterval(0);
     connect(m_idleTimer, SIGNAL(timeout()), SLOT(process()));
 
+    // runs the idle tasks of the strategy once the event queue is empty
+    m_idleTaskTimer = new QTimer(this);
+    m_idleTaskTimer->setSingleShot(true);
+    m_idleTaskTimer->setInterval(0);
+    connect(m_idleTaskTimer, SIGNAL(timeout()), SLOT(performIdleTasks()));
+
     // delay automatic reload for 100 ms
     m_reloadTimer = new QTimer(this);
     m_reloadTimer->setSingleShot(true);
@@ -132,6 +147,7 @@ Strategy::Strategy(const Timer *timer, StrategyType type, DebugHelper *helper, C
 
 Strategy::~Strategy()
 {
+    stopContinuousProfiling(QString());
     delete m_strategy;
     delete m_p;
 }
@@ -380,6 +396,16 @@ void Strategy::handleCommand(const Command &command)
         if (cmd->has_finish_and_save_profile() && m_strategy) {
             m_strategy->endProfiling(cmd->finish_and_save_profile());
         }
+
+        if (cmd->has_continuous_profile()) {
+            const amun::CommandStrategyContinuousProfile &profile = cmd->continuous_profile();
+            if (profile.has_stop_and_save()) {
+                stopContinuousProfiling(QString::fromStdString(profile.stop_and_save()));
+            }
+            if (profile.has_start_interval()) {
+                startContinuousProfiling(profile.start_interval());
+            }
+        }
     }
 
     if (command->has_mixed_team_destination()) {
@@ -449,25 +475,39 @@ world::State Strategy::assembleWorldState()
 
 void Strategy::tryProcess()
 {
+    // the status is processed right now, a pending run from the event loop would only repeat it
+    m_idleTimer->stop();
     if (!m_scriptState.currentStatus.isNull() && m_scriptState.currentStatus->game_state().IsInitialized()
             && m_scriptState.currentStatus->world_state().IsInitialized()) {
         process();
     }
 }
 
-static void addTimingInfos(Status& s, double pathPlanning, double totalTime, StrategyType type) {
+static void addTimingInfos(Status& s, double pathPlanning, double totalTime, StrategyType type,
+                           AbstractStrategyScript *script = nullptr) {
     // publish timings and debug output
     amun::Timing *timing = s->mutable_timing();
+    amun::StrategyHeapTiming heap;
+    bool hasHeap = script && script->takeHeapTiming(heap);
     if (type == StrategyType::BLUE) {
         timing->set_blue_total(totalTime);
         timing->set_blue_path(pathPlanning);
+        if (hasHeap) {
+            timing->mutable_blue_heap()->CopyFrom(heap);
+        }
         s->set_blue_running(true);
     } else if (type == StrategyType::YELLOW) {
         timing->set_yellow_total(totalTime);
         timing->set_yellow_path(pathPlanning);
+        if (hasHeap) {
+            timing->mutable_yellow_heap()->CopyFrom(heap);
+        }
         s->set_yellow_running(true);
     } else if (type == StrategyType::AUTOREF) {
         timing->set_autoref_total(totalTime);
+        if (hasHeap) {
+            timing->mutable_autoref_heap()->CopyFrom(heap);
+        }
         s->set_autoref_running(true);
     }
 }
@@ -533,7 +573,7 @@ void Strategy::process()
 
         // publish timings and debug output
         Status status = takeStrategyDebugStatus();
-        addTimingInfos(status, pathPlanning, totalTime, m_type);
+        addTimingInfos(status, pathPlanning, totalTime, m_type, m_strategy);
         status->mutable_execution_state()->CopyFrom(worldState);
         status->mutable_execution_state()->clear_vision_frames();
         status->mutable_execution_game_state()->CopyFrom(m_scriptState.currentStatus->execution_game_state().IsInitialized()
@@ -541,12 +581,26 @@ void Strategy::process()
                                                             : m_scriptState.currentStatus->game_state());
         status->mutable_execution_user_input()->CopyFrom(userInput);
         emit sendStatus(status);
+
+        // the results are already published, collect garbage once nothing else is queued
+        m_idleTaskTimer->start();
     } else {
         double totalTime = (Timer::systemTime() - startTime) * 1E-9;
         fail(m_strategy->errorMsg(), userInput, pathPlanning, totalTime);
     }
 }
 
+void Strategy::performIdleTasks()
+{
+    // a new status is waiting, the next run has priority over garbage collection
+    if (!m_strategy || m_strategyFailed || m_idleTimer->isActive()) {
+        return;
+    }
+#ifdef V8_FOUND
+    m_strategy->performIdleTasks(static_platform->MonotonicallyIncreasingTime() + IDLE_TASK_BUDGET);
+#endif
+}
+
 void Strategy::setFlipped(bool flipped)
 {
     m_scriptState.isFlipped = flipped;
@@ -628,6 +682,7 @@ void Strategy::loadScript(const QString &filename, const QString &entryPoint, bo
     bool createNewStrategy = !m_strategy || !m_strategy->canReloadInPlace() || !m_strategy->canHandleDynamic(filename);
     if (createNewStrategy) {
         // use a fresh strategy instance when strategy is started
+        collectProfileSamples(true);
         delete m_strategy;
         m_strategy = nullptr;
 
@@ -638,7 +693,7 @@ void Strategy::loadScript(const QString &filename, const QString &entryPoint, bo
             takeStrategyDebugStatus();
 #ifdef V8_FOUND
         } else if (Typescript::canHandle(filename)) {
-            Typescript *t = new Typescript(m_timer, m_type, m_scriptState, m_compilerRegistry);
+            Typescript *t = new Typescript(m_timer, m_type, m_scriptState, m_compilerRegistry, &m_p->isolatePool);
             m_strategy = t;
             // insert m_debugStatus into m_strategy
             // this has to happen before newDebuggagleStrategy is called
@@ -649,6 +704,9 @@ void Strategy::loadScript(const QString &filename, const QString &entryPoint, bo
             return;
         }
         connect(m_strategy, &AbstractStrategyScript::recordGitDiff, this, &Strategy::requestGitRecording);
+        if (m_profileSamples) {
+            m_strategy->startContinuousProfiling(m_profileSamples->samplingInterval());
+        }
     }
 
     if (m_scriptState.isDebugEnabled && m_scriptState.debugHelper) {
@@ -671,6 +729,50 @@ void Strategy::loadScript(const QString &filename, const QString &entryPoint, bo
     m_strategy->loadScript(filename, entryPoint, m_geometry, m_team, loadUnderlying);
 }
 
+void Strategy::startContinuousProfiling(int samplingInterval)
+{
+    // a running profile keeps its samples
+    if (m_profileSamples || samplingInterval <= 0) {
+        return;
+    }
+    m_profileSamples.reset(new ProfileSamples(samplingInterval));
+    if (m_strategy) {
+        m_strategy->startContinuousProfiling(samplingInterval);
+    }
+}
+
+// must be called with stop set before the current script is destroyed
+void Strategy::collectProfileSamples(bool stop)
+{
+    if (m_profileSamples && m_strategy) {
+        m_strategy->takeProfileSamples(*m_profileSamples, stop);
+    }
+}
+
+void Strategy::stopContinuousProfiling(const QString &filename)
+{
+    if (!m_profileSamples) {
+        return;
+    }
+    collectProfileSamples(true);
+    std::unique_ptr<ProfileSamples> samples = std::move(m_profileSamples);
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    Status status(new amun::Status);
+    auto *debug = status->add_debug();
+    debug->set_source(debugSource());
+    amun::StatusLog *log = debug->add_log();
+    log->set_timestamp(m_timer->currentTime());
+    if (samples->save(filename, m_filename)) {
+        log->set_text(QString("Saved profile to %1").arg(filename).toStdString());
+    } else {
+        log->set_text(QString("<font color=\"red\">Could not save profile to %1</font>").arg(filename).toStdString());
+    }
+    emit sendStatus(status);
+}
+
 void Strategy::close()
 {
     m_reloadTimer->stop();
@@ -678,6 +780,7 @@ void Strategy::close()
         emit sendHalt(m_type == StrategyType::BLUE);
     }
 
+    collectProfileSamples(true);
     delete m_strategy;
     m_strategy = nullptr;
 
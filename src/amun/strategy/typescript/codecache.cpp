@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "codecache.h"
+#include "v8utility.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QSaveFile>
+
+using namespace v8;
+
+const char *CodeCache::DIRECTORY_NAME = "codecache";
+
+CodeCache::CodeCache(const QDir &baseDir) :
+    m_directory(baseDir.filePath(DIRECTORY_NAME))
+{ }
+
+QString CodeCache::cacheFile(const QByteArray &content) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(content);
+    hash.addData(V8::GetVersion());
+    return m_directory.filePath(hash.result().toHex() + ".bin");
+}
+
+MaybeLocal<Script> CodeCache::compile(Local<Context> context, const QByteArray &content, ScriptOrigin *origin, bool &cacheUsed)
+{
+    Isolate *isolate = context->GetIsolate();
+    Local<String> sourceString = v8helper::v8string(isolate, content);
+
+    QFile file(cacheFile(content));
+    QByteArray data;
+    if (file.open(QIODevice::ReadOnly)) {
+        data = file.readAll();
+    }
+
+    cacheUsed = false;
+    if (data.isEmpty()) {
+        m_misses++;
+        ScriptCompiler::Source source(sourceString, *origin);
+        return ScriptCompiler::Compile(context, &source);
+    }
+
+    // the source takes ownership of the cached data object, but not of the buffer
+    auto *cachedData = new ScriptCompiler::CachedData(reinterpret_cast<const uint8_t*>(data.constData()), data.size());
+    ScriptCompiler::Source source(sourceString, *origin, cachedData);
+    MaybeLocal<Script> script = ScriptCompiler::Compile(context, &source, ScriptCompiler::kConsumeCodeCache);
+    // v8 rejects the data if it was created by a different build or with different flags
+    cacheUsed = !source.GetCachedData()->rejected;
+    if (cacheUsed) {
+        m_hits++;
+    } else {
+        m_misses++;
+    }
+    return script;
+}
+
+void CodeCache::store(Local<Script> script, const QByteArray &content)
+{
+    std::unique_ptr<ScriptCompiler::CachedData> cachedData(ScriptCompiler::CreateCodeCache(script->GetUnboundScript()));
+    if (!cachedData || !m_directory.mkpath(".")) {
+        return;
+    }
+    // several strategies or processes may write the same file, only the complete file is ever visible
+    QSaveFile file(cacheFile(content));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(cachedData->data), cachedData->length);
+    file.commit();
+}
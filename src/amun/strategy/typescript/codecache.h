@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef CODECACHE_H
+#define CODECACHE_H
+
+#include <QByteArray>
+#include <QDir>
+#include <QString>
+#include <v8.h>
+
+/*!
+ * \brief Persists the compiled code of scripts between loads
+ *
+ * The cache files are stored in the codecache subfolder of the given directory
+ * and are named after a hash of the script source and the v8 version, thus
+ * changed scripts never use outdated code. For strategies this is built/codecache
+ * next to the compile result, which the compiler clears with its first result
+ * in a process.
+ */
+class CodeCache
+{
+public:
+    static const char *DIRECTORY_NAME;
+
+    explicit CodeCache(const QDir &baseDir);
+
+    // compiles the script, using the cached code if available. Outputs if the cache was used
+    v8::MaybeLocal<v8::Script> compile(v8::Local<v8::Context> context, const QByteArray &content,
+                                       v8::ScriptOrigin *origin, bool &cacheUsed);
+    // stores the code of the script, call after running the script to also include lazily compiled functions
+    void store(v8::Local<v8::Script> script, const QByteArray &content);
+
+    int hits() const { return m_hits; }
+    int misses() const { return m_misses; }
+
+private:
+    QString cacheFile(const QByteArray &content) const;
+
+private:
+    QDir m_directory;
+    int m_hits = 0;
+    int m_misses = 0;
+};
+
+#endif // CODECACHE_H
@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef ISOLATEPOOL_H
+#define ISOLATEPOOL_H
+
+#include <QMutex>
+#include <QThreadPool>
+#include <v8.h>
+#include <memory>
+#include <vector>
+
+/*!
+ * \brief Keeps prepared v8 isolates for new strategy instances
+ *
+ * Creating an isolate and disposing the isolate of the previous strategy instance
+ * would otherwise both happen while a strategy is loaded. The pool creates
+ * the isolates and disposes the released ones on a background thread.
+ * Isolates are never reused, a released isolate still holds the heap of its strategy.
+ * Isolates are only prepared after the first one was requested.
+ */
+class IsolatePool
+{
+public:
+    struct PooledIsolate
+    {
+        v8::Isolate *isolate = nullptr;
+        // the isolate does not take ownership of its allocator, it must outlive the isolate
+        std::unique_ptr<v8::ArrayBuffer::Allocator> allocator;
+    };
+
+public:
+    explicit IsolatePool(std::size_t size = 1);
+    ~IsolatePool();
+    IsolatePool(const IsolatePool&) = delete;
+    IsolatePool& operator=(const IsolatePool&) = delete;
+
+    // must be called on the thread that uses the isolate
+    PooledIsolate acquire();
+    // the isolate must not be entered anymore
+    void release(PooledIsolate isolate);
+
+private:
+    class PrepareTask;
+    class DisposeTask;
+
+    static PooledIsolate createIsolate();
+    static void disposeIsolate(PooledIsolate &isolate);
+    void addPrepared(PooledIsolate isolate);
+
+private:
+    const std::size_t m_size;
+    // a single thread, only Isolate::New and Dispose run on it
+    QThreadPool m_worker;
+    QMutex m_mutex;
+    // guarded by m_mutex
+    std::vector<PooledIsolate> m_prepared;
+    std::size_t m_preparing = 0;
+};
+
+#endif // ISOLATEPOOL_H
@@ -34,6 +34,7 @@
 #include "strategy/script/compiler.h"
 
 class CheckForScriptTimeout;
+class CodeCache;
 class QThread;
 class InspectorHolder;
 class AbstractInspectorHandler;
@@ -42,12 +43,13 @@ class CompilerRegistry;
 struct lua_State;
 class ScriptState;
 class InspectorServer;
+class IsolatePool;
 
 class Typescript : public AbstractStrategyScript
 {
     Q_OBJECT
 public:
-    Typescript(const Timer *timer, StrategyType type, ScriptState& scriptState, CompilerRegistry* registry);
+    Typescript(const Timer *timer, StrategyType type, ScriptState& scriptState, CompilerRegistry* registry, IsolatePool *isolatePool);
 
     static bool canHandle(const QString &filename);
     ~Typescript() override;
@@ -55,9 +57,13 @@ public:
 
     void startProfiling() override;
     void endProfiling(const std::string &filename) override;
+    void startContinuousProfiling(int samplingInterval) override;
+    void takeProfileSamples(ProfileSamples &samples, bool stop) override;
     bool canReloadInPlace() const override { return  true; }
     bool canHandleDynamic(const QString &filename) const override { return Typescript::canHandle(filename); }
     void compileIfNecessary() override;
+    void performIdleTasks(double deadline) override;
+    bool takeHeapTiming(amun::StrategyHeapTiming &timing) override;
 
     // functions used for debugging v8
     void disableTimeoutOnce(); // disables script timeout for the currently running strategy frame
@@ -79,12 +85,19 @@ protected:
 
 private:
     static void performRequire(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void gcPrologue(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags, void *data);
+    static void gcEpilogue(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags, void *data);
     static void defineModule(const v8::FunctionCallbackInfo<v8::Value> &args);
     void registerDefineFunction(v8::Local<v8::ObjectTemplate> global);
     bool loadModule(QString name);
+    QByteArray readModule(const QString &filename) const;
+    v8::MaybeLocal<v8::Script> compileScript(v8::Local<v8::Context> context, const QByteArray &content,
+                                             const QString &filename, bool &cacheUsed);
     v8::ScriptOrigin *scriptOriginFromFileName(QString name);
     static void saveNode(QTextStream &file, const v8::CpuProfileNode *node, QString functionStack);
     void clearRequireCache();
+    void prepareGlobalScope();
+    void preloadModules(v8::Local<v8::Context> context);
     void createGlobalScope();
 
     // returns true if a script timeout occured
@@ -106,6 +119,7 @@ private slots:
     void handleVisualization(const amun::Visualization &vis);
 
 private:
+    IsolatePool *m_isolatePool;
     v8::Isolate* m_isolate;
     // The isolate does not take ownership of the allocator.
     // Hence it needs to be stored and deleted manually.
@@ -116,6 +130,11 @@ private:
     // allocator after initialization.
     std::unique_ptr<v8::ArrayBuffer::Allocator> m_arrayAllocator;
     v8::Persistent<v8::Context> m_context;
+    // created in idle time for the next reload
+    v8::Persistent<v8::Context> m_preparedContext;
+    // modules already loaded into the prepared context and the compile result they were read from
+    QMap<QString, v8::Global<v8::Value>*> m_preparedModules;
+    std::shared_ptr<const CompileResultFiles> m_preparedCompileResult;
     v8::Persistent<v8::Function> m_function;
     double m_totalPathTime;
 
@@ -126,9 +145,11 @@ private:
     int m_executionCounter;
 
     v8::CpuProfiler *m_profiler;
+    v8::CpuProfiler *m_continuousProfiler;
     CheckForScriptTimeout *m_checkForScriptTimeout;
     QThread *m_timeoutCheckerThread;
     QList<v8::ScriptOrigin*> m_scriptOrigins;
+    std::unique_ptr<CodeCache> m_codeCache;
     std::unique_ptr<InspectorHolder> m_inspectorHolder;
     std::unique_ptr<InternalDebugger> m_internalDebugger;
 
@@ -136,10 +157,18 @@ private:
 
     lua_State* m_luaState;
     std::shared_ptr<CompilerThreadWrapper> m_compiler;
+    std::shared_ptr<const CompileResultFiles> m_compileResult;
 
     QString m_requestedEntrypoint;
 
     std::unique_ptr<InspectorServer> m_inspectorServer;
+
+    // garbage collection statistics since the last call to takeHeapTiming
+    qint64 m_gcStartTime = 0;
+    int m_gcCount = 0;
+    qint64 m_gcPauseTime = 0;
+    qint64 m_idleGcTime = 0;
+    bool m_isIdle = false;
 };
 
 #endif // TYPESCRIPT_H
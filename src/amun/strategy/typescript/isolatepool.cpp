@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "isolatepool.h"
+#include <QMutexLocker>
+#include <QRunnable>
+
+using namespace v8;
+
+// same as the default of v8's --stack-size flag
+static const uintptr_t STACK_SIZE = 984 * 1024;
+
+class IsolatePool::PrepareTask : public QRunnable
+{
+public:
+    explicit PrepareTask(IsolatePool *pool) : m_pool(pool) { }
+    void run() override { m_pool->addPrepared(createIsolate()); }
+
+private:
+    IsolatePool *m_pool;
+};
+
+class IsolatePool::DisposeTask : public QRunnable
+{
+public:
+    explicit DisposeTask(PooledIsolate isolate) : m_isolate(std::move(isolate)) { }
+    void run() override { disposeIsolate(m_isolate); }
+
+private:
+    PooledIsolate m_isolate;
+};
+
+IsolatePool::IsolatePool(std::size_t size) :
+    m_size(size)
+{
+    m_worker.setMaxThreadCount(1);
+}
+
+IsolatePool::~IsolatePool()
+{
+    m_worker.waitForDone();
+    for (PooledIsolate &isolate : m_prepared) {
+        disposeIsolate(isolate);
+    }
+}
+
+IsolatePool::PooledIsolate IsolatePool::createIsolate()
+{
+    PooledIsolate result;
+    Isolate::CreateParams createParams;
+    result.allocator.reset(ArrayBuffer::Allocator::NewDefaultAllocator());
+    createParams.array_buffer_allocator = result.allocator.get();
+    result.isolate = Isolate::New(createParams);
+    return result;
+}
+
+void IsolatePool::disposeIsolate(PooledIsolate &isolate)
+{
+    isolate.isolate->Dispose();
+    isolate.isolate = nullptr;
+    isolate.allocator.reset();
+}
+
+void IsolatePool::addPrepared(PooledIsolate isolate)
+{
+    QMutexLocker locker(&m_mutex);
+    m_prepared.push_back(std::move(isolate));
+    m_preparing--;
+}
+
+IsolatePool::PooledIsolate IsolatePool::acquire()
+{
+    PooledIsolate result;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_prepared.empty()) {
+            result = std::move(m_prepared.back());
+            m_prepared.pop_back();
+        }
+        while (m_prepared.size() + m_preparing < m_size) {
+            m_preparing++;
+            m_worker.start(new PrepareTask(this));
+        }
+    }
+    // do not wait for an isolate that is still being prepared
+    if (!result.isolate) {
+        result = createIsolate();
+    }
+    // an isolate uses the stack limit of the thread that created it, which is the worker thread
+    // for prepared isolates. Computed like the default limit for the thread that will enter the isolate.
+    int stackPosition = 0;
+    result.isolate->SetStackLimit(reinterpret_cast<uintptr_t>(&stackPosition) - STACK_SIZE);
+    return result;
+}
+
+void IsolatePool::release(PooledIsolate isolate)
+{
+    m_worker.start(new DisposeTask(std::move(isolate)));
+}
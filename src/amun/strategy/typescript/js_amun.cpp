@@ -109,6 +109,100 @@ static void amunGetWorldState(const FunctionCallbackInfo<Value>& args)
     args.GetReturnValue().Set(result);
 }
 
+// flat layout of the world state written by getWorldStateBuffered, must match base/worldbuffer.ts
+// optional values that are not set are NaN, optional flags are -1
+enum WorldBufferHeader { WORLD_REQUIRED_LENGTH, WORLD_TIME_SECONDS, WORLD_TIME_NANOSECONDS, WORLD_SOURCE, WORLD_IS_SIMULATED,
+                         WORLD_HAS_VISION_DATA, WORLD_YELLOW_COUNT, WORLD_BLUE_COUNT, WORLD_HAS_BALL, WORLD_BALL };
+enum WorldBufferBall { BALL_P_X, BALL_P_Y, BALL_P_Z, BALL_V_X, BALL_V_Y, BALL_V_Z, BALL_TOUCHDOWN_X, BALL_TOUCHDOWN_Y,
+                       BALL_IS_BOUNCING, BALL_MAX_SPEED, BALL_RAW_COUNT, BALL_SIZE };
+enum WorldBufferRobot { ROBOT_ID, ROBOT_P_X, ROBOT_P_Y, ROBOT_PHI, ROBOT_V_X, ROBOT_V_Y, ROBOT_OMEGA, ROBOT_RAW_COUNT, ROBOT_SIZE };
+static const size_t WORLD_HEADER_SIZE = WORLD_BALL + BALL_SIZE;
+
+static double optionalFlag(bool hasValue, bool value)
+{
+    return hasValue ? (value ? 1 : 0) : -1;
+}
+
+static void writeRobots(double *data, const google::protobuf::RepeatedPtrField<world::Robot> &robots)
+{
+    for (const world::Robot &robot : robots) {
+        data[ROBOT_ID] = robot.id();
+        data[ROBOT_P_X] = robot.p_x();
+        data[ROBOT_P_Y] = robot.p_y();
+        data[ROBOT_PHI] = robot.phi();
+        data[ROBOT_V_X] = robot.v_x();
+        data[ROBOT_V_Y] = robot.v_y();
+        data[ROBOT_OMEGA] = robot.omega();
+        data[ROBOT_RAW_COUNT] = robot.raw_size();
+        data += ROBOT_SIZE;
+    }
+}
+
+// fills the given Float64Array with the ball and robots without creating javascript objects for them
+// returns the remaining fields the strategy needs or undefined if the buffer is too small,
+// the required length is written to its first entry in that case
+static void amunGetWorldStateBuffered(const FunctionCallbackInfo<Value>& args)
+{
+    Isolate* isolate = args.GetIsolate();
+    Typescript *t = static_cast<Typescript*>(Local<External>::Cast(args.Data())->Value());
+    if (!checkNumberOfArguments(isolate, 1, args.Length())) {
+        return;
+    }
+    if (!args[0]->IsFloat64Array()) {
+        throwError(isolate, "Argument is not a Float64Array");
+        return;
+    }
+    Local<Float64Array> array = Local<Float64Array>::Cast(args[0]);
+    if (array->Length() < WORLD_HEADER_SIZE) {
+        throwError(isolate, "World state buffer is too small");
+        return;
+    }
+    double *data = reinterpret_cast<double*>(static_cast<char*>(array->Buffer()->GetBackingStore()->Data()) + array->ByteOffset());
+
+    const world::State &state = t->worldState();
+    const size_t requiredLength = WORLD_HEADER_SIZE + ROBOT_SIZE * size_t(state.yellow_size() + state.blue_size());
+    data[WORLD_REQUIRED_LENGTH] = requiredLength;
+    if (array->Length() < requiredLength) {
+        args.GetReturnValue().SetUndefined();
+        return;
+    }
+
+    data[WORLD_TIME_SECONDS] = state.time() / 1000000000;
+    data[WORLD_TIME_NANOSECONDS] = state.time() % 1000000000;
+    data[WORLD_SOURCE] = state.has_world_source() ? state.world_source() : 0;
+    data[WORLD_IS_SIMULATED] = optionalFlag(state.has_is_simulated(), state.is_simulated());
+    data[WORLD_HAS_VISION_DATA] = optionalFlag(state.has_has_vision_data(), state.has_vision_data());
+    data[WORLD_YELLOW_COUNT] = state.yellow_size();
+    data[WORLD_BLUE_COUNT] = state.blue_size();
+    data[WORLD_HAS_BALL] = state.has_ball() ? 1 : 0;
+
+    const world::Ball &ball = state.ball();
+    double *ballData = data + WORLD_BALL;
+    ballData[BALL_P_X] = ball.p_x();
+    ballData[BALL_P_Y] = ball.p_y();
+    ballData[BALL_P_Z] = ball.has_p_z() ? ball.p_z() : NAN;
+    ballData[BALL_V_X] = ball.v_x();
+    ballData[BALL_V_Y] = ball.v_y();
+    ballData[BALL_V_Z] = ball.has_v_z() ? ball.v_z() : NAN;
+    ballData[BALL_TOUCHDOWN_X] = ball.has_touchdown_x() ? ball.touchdown_x() : NAN;
+    ballData[BALL_TOUCHDOWN_Y] = ball.has_touchdown_y() ? ball.touchdown_y() : NAN;
+    ballData[BALL_IS_BOUNCING] = optionalFlag(ball.has_is_bouncing(), ball.is_bouncing());
+    ballData[BALL_MAX_SPEED] = ball.has_max_speed() ? ball.max_speed() : NAN;
+    ballData[BALL_RAW_COUNT] = ball.raw_size();
+
+    writeRobots(data + WORLD_HEADER_SIZE, state.yellow());
+    writeRobots(data + WORLD_HEADER_SIZE + ROBOT_SIZE * state.yellow_size(), state.blue());
+
+    // the radio responses and the tracking aoi are rare and small, just convert them
+    world::State remaining;
+    remaining.set_time(state.time());
+    remaining.mutable_radio_response()->CopyFrom(state.radio_response());
+    if (state.has_tracking_aoi()) {
+        remaining.mutable_tracking_aoi()->CopyFrom(state.tracking_aoi());
+    }
+    args.GetReturnValue().Set(protobufToJs(isolate, remaining));
+}
+
 static void amunGetGameState(const FunctionCallbackInfo<Value>& args)
 {
     Isolate* isolate = args.GetIsolate();
@@ -434,6 +528,143 @@ static void amunAddPolygonSimple(const FunctionCallbackInfo<Value>& args)
     }
 }
 
+static bool toFloatVector(Isolate *isolate, Local<Value> value, std::vector<float> &result)
+{
+    if (!value->IsFloat32Array()) {
+        throwError(isolate, "Argument is not a Float32Array");
+        return false;
+    }
+    Local<Float32Array> array = Local<Float32Array>::Cast(value);
+    result.resize(array->Length());
+    static_assert (sizeof(float) == 4, "batches only work for 32 bit floating point numbers");
+    array->CopyContents(result.data(), result.size() * 4);
+    return true;
+}
+
+static bool toStringVector(Isolate *isolate, Local<Value> value, std::vector<std::string> &result)
+{
+    if (!value->IsArray()) {
+        throwError(isolate, "Argument is not an array");
+        return false;
+    }
+    Local<Context> context = isolate->GetCurrentContext();
+    Local<Array> array = Local<Array>::Cast(value);
+    result.clear();
+    result.reserve(array->Length());
+    for (unsigned int i = 0;i<array->Length();i++) {
+        result.emplace_back(*String::Utf8Value(isolate, array->Get(context, i).ToLocalChecked()));
+    }
+    return true;
+}
+
+// layout of a style in the style table of addVisualizations
+enum BatchStyle { STYLE_RED, STYLE_GREEN, STYLE_BLUE, STYLE_ALPHA, STYLE_LINE_WIDTH, STYLE_FILLED, STYLE_BACKGROUND, STYLE_SIZE };
+enum BatchPrimitive { PRIMITIVE_CIRCLE = 0, PRIMITIVE_PATH = 1, PRIMITIVE_POLYGON = 2 };
+
+// converts a number from the primitive list to an index, which must be smaller than limit
+static bool toBatchIndex(float value, size_t limit, size_t &result)
+{
+    // also rejects NaN
+    if (!(value >= 0 && value < float(limit))) {
+        return false;
+    }
+    result = size_t(value);
+    return result < limit;
+}
+
+// arguments: names (one per style), style table (STYLE_SIZE values per style), primitives
+// each primitive starts with its type and style index, followed by x, y and radius for circles
+// or by the number of points and their consecutive x and y coordinates for paths and polygons
+static void amunAddVisualizations(const FunctionCallbackInfo<Value>& args)
+{
+    Isolate* isolate = args.GetIsolate();
+    Typescript *t = static_cast<Typescript*>(Local<External>::Cast(args.Data())->Value());
+
+    std::vector<std::string> names;
+    std::vector<float> styles, data;
+    if (!checkNumberOfArguments(isolate, 3, args.Length()) || !toStringVector(isolate, args[0], names)
+            || !toFloatVector(isolate, args[1], styles) || !toFloatVector(isolate, args[2], data)) {
+        return;
+    }
+    if (styles.size() != names.size() * STYLE_SIZE) {
+        throwError(isolate, "Style table does not match the names");
+        return;
+    }
+
+    size_t pos = 0;
+    while (pos < data.size()) {
+        if (pos + 2 > data.size()) {
+            throwError(isolate, "Incomplete primitive");
+            return;
+        }
+        size_t type, styleIndex;
+        if (!toBatchIndex(data[pos], PRIMITIVE_POLYGON + 1, type)) {
+            throwError(isolate, "Unknown primitive type");
+            return;
+        }
+        if (!toBatchIndex(data[pos + 1], names.size(), styleIndex)) {
+            throwError(isolate, "Invalid style index");
+            return;
+        }
+        pos += 2;
+        const float *style = styles.data() + styleIndex * STYLE_SIZE;
+
+        auto vis = t->addVisualization();
+        vis->set_name(names[styleIndex]);
+        vis->set_width(style[STYLE_LINE_WIDTH]);
+        if (style[STYLE_BACKGROUND] != 0) {
+            vis->set_background(true);
+        }
+        auto color = vis->mutable_pen()->mutable_color();
+        color->set_red(style[STYLE_RED]);
+        color->set_green(style[STYLE_GREEN]);
+        color->set_blue(style[STYLE_BLUE]);
+        color->set_alpha(style[STYLE_ALPHA]);
+        if (style[STYLE_FILLED] != 0 && type != PRIMITIVE_PATH) {
+            auto brush = vis->mutable_brush();
+            brush->set_red(style[STYLE_RED]);
+            brush->set_green(style[STYLE_GREEN]);
+            brush->set_blue(style[STYLE_BLUE]);
+            brush->set_alpha(style[STYLE_ALPHA]);
+        }
+
+        if (type == PRIMITIVE_CIRCLE) {
+            if (pos + 3 > data.size()) {
+                throwError(isolate, "Incomplete circle");
+                return;
+            }
+            auto circle = vis->mutable_circle();
+            circle->set_p_x(data[pos]);
+            circle->set_p_y(data[pos + 1]);
+            circle->set_radius(data[pos + 2]);
+            pos += 3;
+        } else if (type == PRIMITIVE_PATH || type == PRIMITIVE_POLYGON) {
+            if (pos + 1 > data.size()) {
+                throwError(isolate, "Incomplete point list");
+                return;
+            }
+            // compared against the remaining values to avoid an overflow of the required size
+            size_t pointCount;
+            if (!toBatchIndex(data[pos], (data.size() - pos - 1) / 2 + 1, pointCount)) {
+                throwError(isolate, "Incomplete point list");
+                return;
+            }
+            pos++;
+            auto points = type == PRIMITIVE_PATH ? vis->mutable_path()->mutable_point() : vis->mutable_polygon()->mutable_point();
+            points->Reserve(pointCount);
+            for (size_t i = 0;i<pointCount;i++) {
+                auto point = points->Add();
+                point->set_x(data[pos + 2 * i]);
+                point->set_y(data[pos + 2 * i + 1]);
+            }
+            pos += 2 * pointCount;
+        } else {
+            throwError(isolate, "Unknown primitive type");
+            return;
+        }
+    }
+}
+
 static void amunAddDebug(const FunctionCallbackInfo<Value>& args)
 {
     Isolate* isolate = args.GetIsolate();
@@ -471,6 +702,28 @@ static void amunAddPlot(const FunctionCallbackInfo<Value>& args)
     value->set_value(float(number));
 }
 
+static void amunAddPlots(const FunctionCallbackInfo<Value>& args)
+{
+    Isolate* isolate = args.GetIsolate();
+    Typescript *t = static_cast<Typescript*>(Local<External>::Cast(args.Data())->Value());
+
+    std::vector<std::string> names;
+    std::vector<float> values;
+    if (!checkNumberOfArguments(isolate, 2, args.Length()) || !toStringVector(isolate, args[0], names)
+            || !toFloatVector(isolate, args[1], values)) {
+        return;
+    }
+    if (names.size() != values.size()) {
+        throwError(isolate, "Every plot needs a name and a value");
+        return;
+    }
+    for (size_t i = 0;i<names.size();i++) {
+        amun::PlotValue *value = t->addPlot();
+        value->set_name(names[i]);
+        value->set_value(values[i]);
+    }
+}
+
 static void amunSendCommand(const FunctionCallbackInfo<Value>& args)
 {
     Isolate* isolate = args.GetIsolate();
@@ -774,6 +1027,7 @@ void registerAmunJsCallbacks(Isolate *isolate, Local<Object> global, Typescript
         { "isReplay",           amunIsReplay},
         { "getSelectedOptions", amunGetSelectedOptions},
         { "getWorldState",      amunGetWorldState},
+        { "getWorldStateBuffered", amunGetWorldStateBuffered},
         { "getGameState",       amunGetGameState},
         { "getUserInput",       amunGetUserInput},
         { "log",                amunLog},
@@ -781,8 +1035,10 @@ void registerAmunJsCallbacks(Isolate *isolate, Local<Object> global, Typescript
         { "addCircleSimple",    amunAddCircleSimple},
         { "addPathSimple",      amunAddPathSimple},
         { "addPolygonSimple",   amunAddPolygonSimple},
+        { "addVisualizations",  amunAddVisualizations},
         { "addDebug",           amunAddDebug},
         { "addPlot",            amunAddPlot},
+        { "addPlots",           amunAddPlots},
         { "getPerformanceMode", amunGetPerformanceMode},
         { "setCommand",         amunSetCommand},
         { "setCommands",        amunSetCommands},
@@ -814,6 +1070,8 @@ void registerAmunJsCallbacks(Isolate *isolate, Local<Object> global, Typescript
     Local<String> optionDefaultSupport = v8string(isolate, "SUPPORTS_OPTION_DEFAULT");
     amunObject->Set(context, optionDefaultSupport, Boolean::New(isolate, true)).Check();
     amunObject->Set(context, v8string(isolate, "SUPPORTS_EFFICIENT_PATHVIS"), Boolean::New(isolate, true)).Check();
+    amunObject->Set(context, v8string(isolate, "SUPPORTS_BATCH_VISUALIZATION"), Boolean::New(isolate, true)).Check();
+    amunObject->Set(context, v8string(isolate, "SUPPORTS_WORLD_STATE_BUFFER"), Boolean::New(isolate, true)).Check();
 
     Local<String> amunStr = v8string(isolate, "amun");
     global->Set(context, amunStr, amunObject).Check();
@@ -20,6 +20,7 @@
 
 #include "tsc_internal.h"
 
+#include "codecache.h"
 #include "node/buffer.h"
 #include "node/fs.h"
 #include "node/objectcontainer.h"
@@ -35,6 +36,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QIODevice>
+#include <QStandardPaths>
 #include <QString>
 #include <string>
 #include <utility>
@@ -43,11 +45,19 @@
 using namespace v8;
 using namespace v8helper;
 
+// use this to silence a warn_unused_result warning
+template <typename T> inline void USE(T&&) {}
+
 InternalTypescriptCompiler::InternalTypescriptCompiler(const QFileInfo &tsconfig) :
     TypescriptCompiler(tsconfig),
     m_isolate(nullptr),
     m_compilerPath(QFileInfo(QString(ERFORCE_LIBDIR) + "tsc/built/local/tsc.js").canonicalFilePath())
 {
+    // shared by all applications, the compiler bundle is the same for all of them
+    QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (!cacheLocation.isEmpty()) {
+        m_codeCache.reset(new CodeCache(QDir(cacheLocation + "/ER-Force")));
+    }
 }
 
 InternalTypescriptCompiler::~InternalTypescriptCompiler()
@@ -56,6 +66,8 @@ InternalTypescriptCompiler::~InternalTypescriptCompiler()
         // don't use an Isolate::Scope since we need to Exit before Dispose
         m_isolate->Enter();
         m_requireNamespace.reset();
+        m_compileFunction.Reset();
+        m_uncachedCompilerScript.Reset();
         m_context.Reset();
         // This is needed for a full gc as the isolate is beeing disposed.
         // The JS memory is reclaimed easily, but its c++ callbacks are never called.
@@ -117,11 +129,11 @@ void InternalTypescriptCompiler::initializeEnvironment()
     Local<Object> process = Object::New(m_isolate);
     Local<Value> thisValue(External::New(m_isolate, this));
     {
+        // evaluating the compiler only prints its version, compilations are run by INCREMENTAL_COMPILE_FUNCTION
         Local<Array> argv = createStringArray(m_isolate, {
             QCoreApplication::applicationFilePath(),
             m_compilerPath,
-            "--pretty", "false", "--incremental", "true",
-            "--outDir", "built/built-tmp/"
+            "--version"
         });
         addObjectField(m_isolate, process, "argv", argv);
     }
@@ -156,6 +168,9 @@ void InternalTypescriptCompiler::initializeEnvironment()
 
         Local<String> filename = v8string(m_isolate, m_compilerPath);
         addObjectField(m_isolate, global, "__filename", filename);
+
+        Local<Function> emitFile = Function::New(context, &emitFileCallback, thisValue).ToLocalChecked();
+        addObjectField(m_isolate, global, "emitFile", emitFile);
     }
     addObjectField(m_isolate, global, "process", process);
 }
@@ -236,6 +251,18 @@ void InternalTypescriptCompiler::exitCompilation(const FunctionCallbackInfo<Valu
 
 }
 
+void InternalTypescriptCompiler::emitFileCallback(const FunctionCallbackInfo<Value>& args)
+{
+    auto tsc = static_cast<InternalTypescriptCompiler*>(Local<External>::Cast(args.Data())->Value());
+    if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsString()) {
+        throwError(args.GetIsolate(), "emitFile needs a file name and its content");
+        return;
+    }
+    QString fileName(*String::Utf8Value(args.GetIsolate(), args[0]));
+    QByteArray content(*String::Utf8Value(args.GetIsolate(), args[1]));
+    tsc->addResultFile(fileName, content);
+}
+
 void InternalTypescriptCompiler::stdoutCallback(const FunctionCallbackInfo<Value>& args)
 {
     auto tsc = static_cast<InternalTypescriptCompiler*>(Local<External>::Cast(args.Data())->Value());
@@ -251,6 +278,108 @@ void InternalTypescriptCompiler::stdoutCallback(const FunctionCallbackInfo<Value
     }
 }
 
+// Evaluates to a function that runs one compilation. The builder program and the parsed
+// source files are kept between calls, thus only changed files are parsed, checked and emitted.
+// Emitted files are passed to emitFile instead of being written to disk.
+static const char *INCREMENTAL_COMPILE_FUNCTION = R"JS(
+(function () {
+    var sys = ts.sys;
+    var reportDiagnostic = ts.createDiagnosticReporter(sys, false);
+    var configHost = {
+        useCaseSensitiveFileNames: sys.useCaseSensitiveFileNames,
+        readDirectory: function (path, extensions, excludes, includes, depth) { return sys.readDirectory(path, extensions, excludes, includes, depth); },
+        fileExists: function (path) { return sys.fileExists(path); },
+        readFile: function (path) { return sys.readFile(path); },
+        getCurrentDirectory: function () { return sys.getCurrentDirectory(); },
+        onUnRecoverableConfigFileDiagnostic: reportDiagnostic
+    };
+    var sourceFiles = new Map();
+    var program;
+
+    function isReusable(sourceFile, text, options) {
+        if (!sourceFile || sourceFile.text !== text) {
+            return false;
+        }
+        if (typeof options !== "object") {
+            return sourceFile.languageVersion === options;
+        }
+        return sourceFile.languageVersion === options.languageVersion && sourceFile.impliedNodeFormat === options.impliedNodeFormat;
+    }
+
+    return function (configFileName, outDir) {
+        var config = ts.getParsedCommandLineOfConfigFile(configFileName, { outDir: outDir, incremental: true }, configHost);
+        if (!config) {
+            return ts.ExitStatus.InvalidProject_OutputsSkipped;
+        }
+        var host = ts.createIncrementalCompilerHost(config.options, sys);
+        var getSourceFile = host.getSourceFile;
+        host.getSourceFile = function (fileName, options, onError, shouldCreateNewSourceFile) {
+            var cached = sourceFiles.get(fileName);
+            if (!shouldCreateNewSourceFile && isReusable(cached, sys.readFile(fileName), options)) {
+                return cached;
+            }
+            var sourceFile = getSourceFile(fileName, options, onError, shouldCreateNewSourceFile);
+            if (sourceFile) {
+                sourceFiles.set(fileName, sourceFile);
+            }
+            return sourceFile;
+        };
+        program = ts.createEmitAndSemanticDiagnosticsBuilderProgram(config.fileNames, config.options, host,
+            program || ts.readBuilderProgram(config.options, host), ts.getConfigFileParsingDiagnostics(config), config.projectReferences);
+        return ts.emitFilesAndReportErrorsAndGetExitStatus(program, reportDiagnostic, function (s) { sys.write(s + sys.newLine); },
+            undefined, function (fileName, text) { emitFile(fileName, text); });
+    };
+})()
+)JS";
+
+bool InternalTypescriptCompiler::loadCompiler(Local<Context> context, QString &errorMsg)
+{
+    TryCatch tryCatch(m_isolate);
+
+    QFile compilerFile(m_compilerPath);
+    if (!compilerFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        errorMsg = "Could not open compiler";
+        return false;
+    }
+    QByteArray compilerBytes = compilerFile.readAll();
+
+    bool cacheUsed = true;
+    MaybeLocal<Script> maybeScript;
+    if (m_codeCache) {
+        ScriptOrigin origin(m_isolate, v8string(m_isolate, m_compilerPath));
+        maybeScript = m_codeCache->compile(context, compilerBytes, &origin, cacheUsed);
+    } else {
+        maybeScript = Script::Compile(context, v8string(m_isolate, compilerBytes));
+    }
+    Local<Script> script;
+    if (!maybeScript.ToLocal(&script)) {
+        errorMsg = *String::Utf8Value(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
+        return false;
+    }
+    // defines the global ts namespace, the command line only prints the version
+    USE(script->Run(context));
+    m_stdout.clear();
+    if (tryCatch.HasCaught()) {
+        errorMsg = *String::Utf8Value(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
+        return false;
+    }
+    if (!cacheUsed) {
+        // the cache is stored after the first compilation to include the lazily compiled functions
+        m_uncachedCompilerScript.Reset(m_isolate, script);
+        m_uncachedCompilerSource = compilerBytes;
+    }
+
+    Local<Script> compileScript;
+    Local<Value> compileFunction;
+    if (!Script::Compile(context, v8string(m_isolate, INCREMENTAL_COMPILE_FUNCTION)).ToLocal(&compileScript)
+            || !compileScript->Run(context).ToLocal(&compileFunction) || !compileFunction->IsFunction()) {
+        errorMsg = "Could not set up incremental compilation";
+        return false;
+    }
+    m_compileFunction.Reset(m_isolate, Local<Function>::Cast(compileFunction));
+    return true;
+}
+
 std::pair<InternalTypescriptCompiler::CompileResult, QString> InternalTypescriptCompiler::performCompilation()
 {
     if (!m_isolate) {
@@ -262,24 +391,24 @@ std::pair<InternalTypescriptCompiler::CompileResult, QString> InternalTypescript
     Local<Context> context = m_context.Get(m_isolate);
     Context::Scope contextScope(context);
 
-    QFile compilerFile(m_compilerPath);
-    if (!compilerFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return { CompileResult::Error, "Could not open compiler" };
+    if (m_compileFunction.IsEmpty()) {
+        QString errorMsg;
+        if (!loadCompiler(context, errorMsg)) {
+            return { CompileResult::Error, errorMsg };
+        }
     }
-    QByteArray compilerBytes = compilerFile.readAll();
-
 
-    Local<String> source = v8string(m_isolate, compilerBytes);
-    Local<Script> script;
     TryCatch tryCatch(m_isolate);
-    if (!Script::Compile(context, source).ToLocal(&script)) {
-        String::Utf8Value errorMsg(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
-        return { CompileResult::Error, *errorMsg };
-    }
+    Local<Function> compileFunction = m_compileFunction.Get(m_isolate);
+    Local<Value> arguments[] = {
+        v8string(m_isolate, m_tsconfig.absoluteFilePath()),
+        v8string(m_isolate, outputDirectory())
+    };
     Local<Value> exitCodeValue;
     running = true;
-    bool exitcodeValid = script->Run(context).ToLocal(&exitCodeValue);
+    bool exitcodeValid = compileFunction->Call(context, context->Global(), 2, arguments).ToLocal(&exitCodeValue);
     if (running) {
+        running = false;
         handleExitcode(
             exitcodeValid,
             exitcodeValid
@@ -289,6 +418,11 @@ std::pair<InternalTypescriptCompiler::CompileResult, QString> InternalTypescript
     } else {
         m_isolate->CancelTerminateExecution();
     }
+    if (!m_uncachedCompilerScript.IsEmpty()) {
+        m_codeCache->store(m_uncachedCompilerScript.Get(m_isolate), m_uncachedCompilerSource);
+        m_uncachedCompilerScript.Reset();
+        m_uncachedCompilerSource.clear();
+    }
     if (tryCatch.HasTerminated() || tryCatch.HasCaught()) {
         String::Utf8Value errorMsg(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
         return { CompileResult::Error, *errorMsg };
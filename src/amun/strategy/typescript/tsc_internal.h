@@ -37,6 +37,7 @@ namespace Node
 }
 
 class QString;
+class CodeCache;
 
 class InternalTypescriptCompiler : public TypescriptCompiler
 {
@@ -51,6 +52,10 @@ private:
     static void processCwdCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void exitCompilation(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void stdoutCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void emitFileCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // evaluates the compiler bundle and prepares the incremental compile function
+    bool loadCompiler(v8::Local<v8::Context> context, QString &errorMsg);
 
     // WARNING: this function is NOT re-entrant
     std::pair<CompileResult, QString> performCompilation() override;
@@ -61,6 +66,11 @@ private:
     // Hence it needs to be stored and deleted manually.
     std::unique_ptr<v8::ArrayBuffer::Allocator> m_arrayAllocator;
     v8::Global<v8::Context> m_context;
+    v8::Global<v8::Function> m_compileFunction;
+    // set until the code cache of the compiler bundle is written
+    v8::Global<v8::Script> m_uncachedCompilerScript;
+    QByteArray m_uncachedCompilerSource;
+    std::unique_ptr<CodeCache> m_codeCache;
 
     std::unique_ptr<Node::ObjectContainer> m_requireNamespace;
     bool running = false;
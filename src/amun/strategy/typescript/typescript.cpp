@@ -20,6 +20,7 @@
 
 #include "typescript.h"
 
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QDebug>
 #include <QThread>
@@ -33,11 +34,15 @@
 #include "js_amun.h"
 #include "js_path.h"
 #include "checkforscripttimeout.h"
+#include "codecache.h"
+#include "core/timer.h"
 #include "inspectorholder.h"
 #include "internaldebugger.h"
 #include "inspectorserver.h"
+#include "isolatepool.h"
 #include "tsc_internal.h"
 #include "strategy/script/compilerregistry.h"
+#include "strategy/script/profilesamples.h"
 #include "strategy/script/scriptstate.h"
 #include "v8utility.h"
 
@@ -47,20 +52,23 @@ using namespace v8helper;
 // use this to silence a warn_unused_result warning
 template <typename T> inline void USE(T&&) {}
 
-Typescript::Typescript(const Timer *timer, StrategyType type, ScriptState& scriptState, CompilerRegistry* registry) :
+Typescript::Typescript(const Timer *timer, StrategyType type, ScriptState& scriptState, CompilerRegistry* registry, IsolatePool *isolatePool) :
     AbstractStrategyScript (timer, type, scriptState, registry),
+    m_isolatePool(isolatePool),
     m_requireCache({{}}),
     m_executionCounter(0),
     m_profiler (nullptr),
+    m_continuousProfiler(nullptr),
     m_scriptIdCounter(0),
     m_luaState(nullptr)
 {
-    Isolate::CreateParams create_params;
-    m_arrayAllocator.reset(ArrayBuffer::Allocator::NewDefaultAllocator());
-    create_params.array_buffer_allocator = m_arrayAllocator.get();
-    m_isolate = Isolate::New(create_params);
+    IsolatePool::PooledIsolate pooled = m_isolatePool->acquire();
+    m_isolate = pooled.isolate;
+    m_arrayAllocator = std::move(pooled.allocator);
     m_isolate->SetRAILMode(PERFORMANCE_LOAD);
     m_isolate->Enter();
+    m_isolate->AddGCPrologueCallback(gcPrologue, this);
+    m_isolate->AddGCEpilogueCallback(gcEpilogue, this);
 
     // creates its own QThread and moves to it
     m_checkForScriptTimeout = new CheckForScriptTimeout(m_isolate, m_timeoutCounter);
@@ -101,12 +109,24 @@ Typescript::~Typescript()
         m_profiler->Dispose();
         m_profiler = nullptr;
     }
+    if (m_continuousProfiler != nullptr) {
+        m_continuousProfiler->Dispose();
+        m_continuousProfiler = nullptr;
+    }
     clearRequireCache();
+    qDeleteAll(m_preparedModules);
     m_function.Reset();
     m_requireTemplate.Reset();
     m_context.Reset();
+    m_preparedContext.Reset();
+    m_isolate->RemoveGCPrologueCallback(gcPrologue, this);
+    m_isolate->RemoveGCEpilogueCallback(gcEpilogue, this);
     m_isolate->Exit();
-    m_isolate->Dispose();
+    // disposing the isolate of a large strategy takes some time, the pool does that in the background
+    IsolatePool::PooledIsolate pooled;
+    pooled.isolate = m_isolate;
+    pooled.allocator = std::move(m_arrayAllocator);
+    m_isolatePool->release(std::move(pooled));
     if (m_luaState) {
         lua_close(m_luaState);
     }
@@ -128,8 +148,14 @@ static void scriptTimeoutCallback(v8::Isolate*, void* data) {
     static_cast<InspectorHolder*>(data)->breakProgram("Script timeout");
 }
 
-void Typescript::createGlobalScope()
+// modules that only depend on the protobuf definitions of amun, they are loaded into the prepared context
+static const QStringList PRELOADED_MODULES = {"base/protobuf"};
+
+void Typescript::prepareGlobalScope()
 {
+    if (!m_preparedContext.IsEmpty()) {
+        return;
+    }
     HandleScope handleScope(m_isolate);
     Local<ObjectTemplate> globalTemplate = ObjectTemplate::New(m_isolate);
     registerDefineFunction(globalTemplate);
@@ -141,7 +167,63 @@ void Typescript::createGlobalScope()
     // create an empty global variable used for debugging
     Local<String> objectName = v8string(m_isolate, "___globalpleasedontuseinregularcode");
     global->Set(context, objectName, Object::New(m_isolate)).Check();
-    m_context.Reset(m_isolate, context);
+    m_preparedContext.Reset(m_isolate, context);
+    preloadModules(context);
+}
+
+void Typescript::preloadModules(Local<Context> context)
+{
+    // the modules are only known once a strategy was compiled
+    if (!m_compileResult) {
+        return;
+    }
+
+    // load into a separate require cache, the current one still belongs to the running strategy
+    QList<QMap<QString, Global<Value>*>> requireCache = {{}};
+    std::swap(requireCache, m_requireCache);
+    const QString moduleBefore = m_currentExecutingModule;
+    TryCatch tryCatch(m_isolate);
+    bool success = true;
+    for (const QString &name : PRELOADED_MODULES) {
+        if (!loadModule(name)) {
+            success = false;
+            break;
+        }
+    }
+    m_currentExecutingModule = moduleBefore;
+    std::swap(requireCache, m_requireCache);
+
+    if (!success || tryCatch.HasCaught() || tryCatch.HasTerminated()) {
+        // the modules are loaded again by the strategy, which then reports the error
+        qDeleteAll(requireCache.front());
+        return;
+    }
+    m_preparedModules = requireCache.front();
+    m_preparedCompileResult = m_compileResult;
+}
+
+void Typescript::createGlobalScope()
+{
+    // the context is usually already prepared during the idle time after the last load
+    prepareGlobalScope();
+    const bool disposesContext = !m_context.IsEmpty();
+    m_context.Reset(m_isolate, m_preparedContext);
+    m_preparedContext.Reset();
+    if (disposesContext) {
+        // the old context is collected by the following idle garbage collections
+        m_isolate->ContextDisposedNotification();
+    }
+
+    // a new compile result may contain different modules
+    if (m_preparedCompileResult == m_compileResult) {
+        for (auto it = m_preparedModules.begin(); it != m_preparedModules.end(); ++it) {
+            m_requireCache.back()[it.key()] = it.value();
+        }
+    } else {
+        qDeleteAll(m_preparedModules);
+    }
+    m_preparedModules.clear();
+    m_preparedCompileResult.reset();
 
     m_inspectorHolder.reset();
     m_inspectorHolder.reset(new InspectorHolder(m_isolate, m_context));
@@ -433,21 +515,21 @@ bool Typescript::setupCompiler(const QString &filename, bool compileBlocking)
 
 bool Typescript::loadTypescript(const QString &filename, const QString &entryPoint)
 {
-    if (!m_compiler->comp()->requestPause()) {
-        m_errorMsg = "<font color=\"red\">Could not pause compiler</font>";
-        return false;
-    }
+    // all modules, including the ones required later on, are taken from the same compile result
+    m_compileResult = m_compiler->comp()->resultFiles();
 
     bool success = false;
     if (m_compiler->comp()->isResultAvailable()) {
         QFileInfo jsFile = m_compiler->comp()->mapToResult(QFileInfo(filename));
 
+        // loading favors throughput, while running the strategy short pauses are more important
+        m_isolate->SetRAILMode(PERFORMANCE_LOAD);
         success = loadJavascript(jsFile.absoluteFilePath(), entryPoint);
+        m_isolate->SetRAILMode(PERFORMANCE_ANIMATION);
         emit changeLoadState(success ? amun::StatusStrategy::RUNNING : amun::StatusStrategy::FAILED);
     } else {
         m_errorMsg = "<font color=\"red\">No compile result available</font>";
     }
-    m_compiler->comp()->resume();
     return success;
 }
 
@@ -461,9 +543,20 @@ static QByteArray readFileContent(const QString &filename)
     return in.readAll().toUtf8();
 }
 
+QByteArray Typescript::readModule(const QString &filename) const
+{
+    if (m_compileResult) {
+        auto it = m_compileResult->find(QDir::cleanPath(filename));
+        if (it != m_compileResult->end()) {
+            return it.value();
+        }
+    }
+    return readFileContent(filename);
+}
+
 bool Typescript::loadJavascript(const QString &filename, const QString &entryPoint)
 {
-    QByteArray contentBytes = readFileContent(filename);
+    QByteArray contentBytes = readModule(filename);
     if (contentBytes.isNull()) {
         m_errorMsg = "<font color=\"red\">Could not open file " + filename + "</font>";
         return false;
@@ -478,16 +571,20 @@ bool Typescript::loadJavascript(const QString &filename, const QString &entryPoi
     m_entryPoints.clear();
     createGlobalScope();
 
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    std::unique_ptr<QDir> baseDir = getTsconfigDir(filename);
+    m_codeCache.reset(baseDir ? new CodeCache(QDir(baseDir->filePath("built"))) : nullptr);
+
     HandleScope handleScope(m_isolate);
     Local<Context> context = Local<Context>::New(m_isolate, m_context);
     Context::Scope contextScope(context);
 
-    Local<String> source = v8string(m_isolate, contentBytes);
-
     // Compile the source code.
     Local<Script> script;
     TryCatch tryCatch(m_isolate);
-    if (!Script::Compile(context, source, scriptOriginFromFileName(filename)).ToLocal(&script)) {
+    bool cacheUsed;
+    if (!compileScript(context, contentBytes, filename, cacheUsed).ToLocal(&script)) {
         String::Utf8Value error(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
         m_errorMsg = "<font color=\"red\">" + QString(*error) + "</font>";
         return false;
@@ -502,6 +599,15 @@ bool Typescript::loadJavascript(const QString &filename, const QString &entryPoi
         }
         return false;
     }
+    if (!cacheUsed && m_codeCache) {
+        m_codeCache->store(script, contentBytes);
+    }
+    if (m_codeCache) {
+        // all modules are loaded by running the init script
+        log(QString("Loaded strategy in %1 ms, %2 of %3 modules from the code cache")
+            .arg(loadTimer.nsecsElapsed() / 1000000.0, 0, 'f', 1)
+            .arg(m_codeCache->hits()).arg(m_codeCache->hits() + m_codeCache->misses()));
+    }
     Local<Object> initExport = Local<Value>::New(m_isolate, *m_requireCache.back()[m_filename])->ToObject(context).ToLocalChecked();
     Local<String> scriptInfoString = v8string(m_isolate, "scriptInfo");
     if (!initExport->Has(context, scriptInfoString).ToChecked()) {
@@ -697,6 +803,15 @@ ScriptOrigin *Typescript::scriptOriginFromFileName(QString name)
     return origin;
 }
 
+MaybeLocal<Script> Typescript::compileScript(Local<Context> context, const QByteArray &content, const QString &filename, bool &cacheUsed)
+{
+    cacheUsed = false;
+    if (!m_codeCache) {
+        return Script::Compile(context, v8string(m_isolate, content), scriptOriginFromFileName(filename));
+    }
+    return m_codeCache->compile(context, content, scriptOriginFromFileName(filename), cacheUsed);
+}
+
 bool Typescript::loadModule(QString name)
 {
     if (!m_requireCache.back().contains(name)) {
@@ -710,19 +825,19 @@ bool Typescript::loadModule(QString name)
         QFileInfo jsFile = m_compiler->comp()->mapToResult(baseDir->absolutePath() + "/" + name + ".ts");
         QString filename = jsFile.absoluteFilePath();
 
-        QByteArray contentBytes = readFileContent(filename);
+        QByteArray contentBytes = readModule(filename);
         if (contentBytes.isNull()) {
             throwError(m_isolate, "Could not import module: " + name);
             return false;
         }
 
-        Local<String> source = v8string(m_isolate, contentBytes);
         Local<Context> context = m_isolate->GetCurrentContext();
 
         // Compile the source code.
         Local<Script> script;
         TryCatch tryCatch(m_isolate);
-        if (!Script::Compile(context, source, scriptOriginFromFileName(filename)).ToLocal(&script)) {
+        bool cacheUsed;
+        if (!compileScript(context, contentBytes, filename, cacheUsed).ToLocal(&script)) {
             tryCatch.ReThrow();
             return false;
         }
@@ -740,6 +855,9 @@ bool Typescript::loadModule(QString name)
             tryCatch.ReThrow();
             return false;
         }
+        if (!cacheUsed && m_codeCache) {
+            m_codeCache->store(script, contentBytes);
+        }
         m_currentExecutingModule = moduleBefore;
     }
     return true;
@@ -846,6 +964,72 @@ void Typescript::endProfiling(const std::string &filename)
     m_profiler = nullptr;
 }
 
+static const char *CONTINUOUS_PROFILE_TITLE = "continuous";
+
+void Typescript::startContinuousProfiling(int samplingInterval)
+{
+    HandleScope handleScope(m_isolate);
+    if (m_continuousProfiler == nullptr) {
+        m_continuousProfiler = CpuProfiler::New(m_isolate);
+    }
+    m_continuousProfiler->SetSamplingInterval(samplingInterval);
+    // without recording every single sample, the profile only grows with the number of distinct call stacks
+    m_continuousProfiler->StartProfiling(v8string(m_isolate, CONTINUOUS_PROFILE_TITLE), false);
+}
+
+static QString profileFrameName(const CpuProfileNode *node)
+{
+    QString name = node->GetFunctionNameStr();
+    if (name.isEmpty()) {
+        name = "(anonymous)";
+    }
+    if (node->GetScriptId() == 0) {
+        // special nodes like (garbage collector) are already marked, the other ones are the amun callbacks
+        return name.startsWith('(') ? name : name + " [native]";
+    }
+    QString resource = node->GetScriptResourceNameStr();
+    // module paths relative to the compile output are stable between strategy versions
+    const int builtIndex = resource.lastIndexOf("/built/");
+    if (builtIndex >= 0) {
+        resource = resource.mid(builtIndex + 7);
+    }
+    return QString("%1 (%2:%3)").arg(name, resource).arg(node->GetLineNumber());
+}
+
+static void addProfileNode(ProfileSamples &samples, const CpuProfileNode *node, QStringList &stack)
+{
+    stack.append(profileFrameName(node));
+    samples.add(stack, node->GetHitCount());
+    for (int i = 0;i<node->GetChildrenCount();i++) {
+        addProfileNode(samples, node->GetChild(i), stack);
+    }
+    stack.removeLast();
+}
+
+void Typescript::takeProfileSamples(ProfileSamples &samples, bool stop)
+{
+    if (m_continuousProfiler == nullptr) {
+        return;
+    }
+    HandleScope handleScope(m_isolate);
+    CpuProfile *profile = m_continuousProfiler->StopProfiling(v8string(m_isolate, CONTINUOUS_PROFILE_TITLE));
+    if (profile != nullptr) {
+        // the root node is not part of the stacks
+        const CpuProfileNode *root = profile->GetTopDownRoot();
+        QStringList stack;
+        for (int i = 0;i<root->GetChildrenCount();i++) {
+            addProfileNode(samples, root->GetChild(i), stack);
+        }
+        profile->Delete();
+    }
+    if (stop) {
+        m_continuousProfiler->Dispose();
+        m_continuousProfiler = nullptr;
+    } else {
+        m_continuousProfiler->StartProfiling(v8string(m_isolate, CONTINUOUS_PROFILE_TITLE), false);
+    }
+}
+
 bool Typescript::process(double &pathPlanning)
 {
     m_executionCounter++;
@@ -871,6 +1055,51 @@ bool Typescript::process(double &pathPlanning)
     return true;
 }
 
+void Typescript::gcPrologue(Isolate *, GCType, GCCallbackFlags, void *data)
+{
+    Typescript *t = static_cast<Typescript*>(data);
+    t->m_gcStartTime = Timer::systemTime();
+}
+
+void Typescript::gcEpilogue(Isolate *, GCType, GCCallbackFlags, void *data)
+{
+    Typescript *t = static_cast<Typescript*>(data);
+    // collections during idle time are measured as a whole
+    if (!t->m_isIdle) {
+        t->m_gcCount++;
+        t->m_gcPauseTime += Timer::systemTime() - t->m_gcStartTime;
+    }
+}
+
+void Typescript::performIdleTasks(double deadline)
+{
+    qint64 startTime = Timer::systemTime();
+    m_isIdle = true;
+    if (m_preparedContext.IsEmpty() && !m_context.IsEmpty()) {
+        // the last load used the spare context, preparing the next one takes the place of this garbage collection
+        prepareGlobalScope();
+    } else {
+        m_isolate->IdleNotificationDeadline(deadline);
+    }
+    m_isIdle = false;
+    m_idleGcTime += Timer::systemTime() - startTime;
+}
+
+bool Typescript::takeHeapTiming(amun::StrategyHeapTiming &timing)
+{
+    HeapStatistics statistics;
+    m_isolate->GetHeapStatistics(&statistics);
+    timing.set_used_heap_size(statistics.used_heap_size());
+    timing.set_total_heap_size(statistics.total_heap_size());
+    timing.set_gc_count(m_gcCount);
+    timing.set_gc_pause(m_gcPauseTime * 1E-9);
+    timing.set_idle_gc(m_idleGcTime * 1E-9);
+    m_gcCount = 0;
+    m_gcPauseTime = 0;
+    m_idleGcTime = 0;
+    return true;
+}
+
 void Typescript::disableTimeoutOnce()
 {
     m_timeoutCounter.store(0);
@@ -22,10 +22,12 @@
 
 #include "strategy/script/filewatcher.h"
 #include "protobuftypings.h"
+#include "codecache.h"
 
 #include <QDateTime>
 #include <QDirIterator>
 #include <QFileInfo>
+#include <QSaveFile>
 #include <QString>
 #include <QtGlobal>
 #include <utility>
@@ -34,7 +36,7 @@
 #include <fstream>
 
 TypescriptCompiler::TypescriptCompiler(const QFileInfo &tsconfig)
-    : m_tsconfig(tsconfig), m_state(State::STANDBY)
+    : m_tsconfig(tsconfig)
 {
     Q_ASSERT(m_tsconfig.isFile());
 }
@@ -72,30 +74,32 @@ QFileInfo TypescriptCompiler::mapToResult(const QFileInfo& src) {
     return result;
 }
 
-bool TypescriptCompiler::requestPause()
+bool TypescriptCompiler::isResultAvailable()
 {
-    QMutexLocker locker(&m_stateLock);
-    bool pausable = m_state != State::RENAMING;
-    if (pausable) {
-        m_state = State::PAUSED;
+    {
+        QMutexLocker locker(&m_resultLock);
+        if (m_resultFiles && !m_resultFiles->isEmpty()) {
+            return true;
+        }
     }
-    return pausable;
+    QFileInfo outputDir(outputDirectory());
+    return outputDir.exists() && outputDir.isDir();
 }
 
-void TypescriptCompiler::resume()
+std::shared_ptr<const CompileResultFiles> TypescriptCompiler::resultFiles()
 {
-    QMutexLocker locker(&m_stateLock);
-    if (m_state == State::PAUSED) {
-        m_state = State::STANDBY;
-        m_pauseWait.wakeAll();
-    }
+    QMutexLocker locker(&m_resultLock);
+    return m_resultFiles;
 }
 
-bool TypescriptCompiler::isResultAvailable()
+QString TypescriptCompiler::outputDirectory() const
 {
-    QMutexLocker locker(&m_stateLock);
-    QFileInfo outputDir(m_tsconfig.dir().filePath("built/built"));
-    return m_state != State::RENAMING && outputDir.exists() && outputDir.isDir();
+    return m_tsconfig.dir().absoluteFilePath("built/built");
+}
+
+void TypescriptCompiler::addResultFile(const QString &path, const QByteArray &content)
+{
+    m_pendingFiles[QDir::cleanPath(QFileInfo(path).absoluteFilePath())] = content;
 }
 
 void TypescriptCompiler::compile()
@@ -107,24 +111,16 @@ void TypescriptCompiler::compile()
     doCompile();
 }
 
-static bool copyDirectory(const QString &source, const QString &destination)
+bool TypescriptCompiler::writeResultFiles(const CompileResultFiles &files)
 {
-    QDir destDir(destination);
-    destDir.removeRecursively();
-    QDir parentDir(QFileInfo(destination).path());
-    if (!parentDir.mkdir(QFileInfo(destination).fileName())) {
-        return false;
-    }
-
-    for (const auto &info :  QDir(source).entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot)) {
-        if (info.isFile()) {
-            if (!QFile::copy(info.absoluteFilePath(), destDir.filePath(info.fileName()))) {
-                return false;
-            }
-        } else if (info.isDir()) {
-            if (!copyDirectory(info.absoluteFilePath(), destDir.filePath(info.fileName()))) {
-                return false;
-            }
+    for (auto it = files.begin(); it != files.end(); ++it) {
+        if (!QFileInfo(it.key()).dir().mkpath(".")) {
+            return false;
+        }
+        // a strategy may read files that are not in its result map at any time, never expose a partial file
+        QSaveFile file(it.key());
+        if (!file.open(QIODevice::WriteOnly) || file.write(it.value()) != it.value().size() || !file.commit()) {
+            return false;
         }
     }
     return true;
@@ -145,33 +141,39 @@ void TypescriptCompiler::doCompile()
     QDateTime lastStrategyModification = lastModifications().first;
 
     emit started();
+    m_pendingFiles.clear();
     std::pair<CompileResult, QString> result = performCompilation();
 
-    QMutexLocker locker(&m_stateLock);
-    while (m_state == State::PAUSED)
-        m_pauseWait.wait(locker.mutex());
-    m_state = State::RENAMING;
-    locker.unlock();
-
-    bool renameSucceeded = false;
-    QDir newResult(m_tsconfig.dir().absoluteFilePath("built/built-tmp"));
-    QDir oldResult(m_tsconfig.dir().absoluteFilePath("built/built"));
-    QDir copyTemp(m_tsconfig.dir().absoluteFilePath("built/built-tmp2"));
-    if (!oldResult.removeRecursively()) {
-        emit error("Could not remove old compile result");
-    } else if (!copyDirectory(newResult.absolutePath(), copyTemp.absolutePath())) {
-        emit error("Could not copy temporary result");
-    } else if (!copyTemp.rename(copyTemp.absolutePath(), oldResult.absolutePath())) {
-        emit error("Could not rename new compile result");
-    } else {
-        renameSucceeded = true;
+    // the compiler only emits changed files, publish them together with the unchanged ones in one step
+    bool firstResult = !resultFiles();
+    if (!m_pendingFiles.isEmpty()) {
+        std::shared_ptr<CompileResultFiles> files = std::make_shared<CompileResultFiles>();
+        {
+            QMutexLocker locker(&m_resultLock);
+            if (m_resultFiles) {
+                *files = *m_resultFiles;
+            }
+        }
+        for (auto it = m_pendingFiles.begin(); it != m_pendingFiles.end(); ++it) {
+            files->insert(it.key(), it.value());
+        }
+        QMutexLocker locker(&m_resultLock);
+        m_resultFiles = files;
     }
 
-    locker.relock();
-    m_state = State::STANDBY;
-    locker.unlock();
-
-    if (!renameSucceeded) return;
+    // the files on disk are only used by strategies loaded before the first compilation in this process,
+    // by source maps and to detect if a compilation is needed
+    if (!writeResultFiles(m_pendingFiles)) {
+        m_pendingFiles.clear();
+        emit error("Could not write compile result");
+        return;
+    }
+    if (firstResult && !m_pendingFiles.isEmpty()) {
+        // cache entries are keyed by the module content, drop the outdated ones once to keep the folder from growing.
+        // Later compilations only change a few modules, the cache of the others should be kept
+        QDir(m_tsconfig.dir().absoluteFilePath("built/" + QString(CodeCache::DIRECTORY_NAME))).removeRecursively();
+    }
+    m_pendingFiles.clear();
 
     switch (result.first) {
     case CompileResult::Success:
@@ -192,12 +194,16 @@ void TypescriptCompiler::doCompile()
     }
 }
 
-static QDateTime getLastModified(const QDir& dir)
+static QDateTime getLastModified(const QDir& dir, const QString &ignoredDir = QString())
 {
     QDirIterator it(dir.absolutePath(), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
     QDateTime lastModified;
+    const QString ignoredPath = ignoredDir.isEmpty() ? QString() : dir.absoluteFilePath(ignoredDir);
     while (it.hasNext()) {
         it.next();
+        if (!ignoredPath.isEmpty() && (it.filePath() == ignoredPath || it.filePath().startsWith(ignoredPath + "/"))) {
+            continue;
+        }
         QDateTime modified = it.fileInfo().lastModified();
         if (lastModified.isNull() || modified > lastModified) {
             lastModified = modified;
@@ -215,7 +221,8 @@ QPair<QDateTime, QDateTime> TypescriptCompiler::lastModifications()
         it.next();
         QFileInfo info = it.fileInfo();
         if (info.fileName() == "built") {
-            lastModifiedResult = getLastModified(QDir(info.absoluteFilePath()));
+            // the code cache is written when loading the strategy, it must not make the result look newer than the sources
+            lastModifiedResult = getLastModified(QDir(info.absoluteFilePath()), CodeCache::DIRECTORY_NAME);
             continue;
         }
 
@@ -232,7 +239,7 @@ QPair<QDateTime, QDateTime> TypescriptCompiler::lastModifications()
 
 bool TypescriptCompiler::isCompilationNeeded()
 {
-    QFileInfo buildDir(m_tsconfig.dir().absolutePath() + "/built/built");
+    QFileInfo buildDir(outputDirectory());
     if (!buildDir.exists()) {
         return true;
     }
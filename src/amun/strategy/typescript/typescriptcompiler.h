@@ -27,7 +27,6 @@
 #include <QDir>
 #include <QMutex>
 #include <QString>
-#include <QWaitCondition>
 #include <memory>
 #include <utility>
 
@@ -40,9 +39,8 @@ public:
     TypescriptCompiler(const QFileInfo &tsconfig);
 
     QFileInfo mapToResult(const QFileInfo& src) override;
-    bool requestPause() override;
-    void resume() override;
     bool isResultAvailable() override;
+    std::shared_ptr<const CompileResultFiles> resultFiles() override;
 
 public slots:
     void init() override;
@@ -56,6 +54,9 @@ protected:
         Success, Warning, Error
     };
     virtual std::pair<CompileResult, QString> performCompilation() = 0;
+    // to be called by performCompilation for every file emitted by the compiler
+    void addResultFile(const QString &path, const QByteArray &content);
+    QString outputDirectory() const;
 
     QFileInfo m_tsconfig;
 
@@ -64,15 +65,13 @@ private:
     // last source and build directory modification
     QPair<QDateTime, QDateTime> lastModifications();
     void doCompile();
+    bool writeResultFiles(const CompileResultFiles &files);
 
     std::unique_ptr<FileWatcher> m_watcher;
 
-    enum class State {
-        PAUSED, STANDBY, RENAMING
-    };
-    State m_state;
-    QMutex m_stateLock;
-    QWaitCondition m_pauseWait;
+    CompileResultFiles m_pendingFiles;
+    std::shared_ptr<const CompileResultFiles> m_resultFiles;
+    QMutex m_resultLock;
 };
 
 #endif // TYPESCRIPTCOMPILER_H
@@ -19,12 +19,16 @@
  ***************************************************************************/
 
 #include "amun/amunclient.h"
+#include "amun/lockstepamun.h"
+#include "strategy/script/compilerregistry.h"
 #include "testtools/connector.h"
 
 #include <clocale>
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QProcessEnvironment>
+#include <QTimer>
+#include <memory>
 
 int main(int argc, char* argv[])
 {
@@ -56,6 +60,11 @@ int main(int argc, char* argv[])
     QCommandLineOption realismConfig("realism", "Simulator realism configuration (short file name without the .txt)", "realism");
     QCommandLineOption silent("silent", "Do not print any messages");
     QCommandLineOption forceStart({"f", "force-start"}, "Force start the game immediately (Kickoff will be used otherwise)");
+    QCommandLineOption frameAlignedTracking("frame-aligned-tracking", "Run tracking as soon as all cameras delivered a frame instead of on a fixed timer");
+    QCommandLineOption reportLatency("report-latency", "Report the latency from vision frame reception to sending radio commands");
+    QCommandLineOption reportSimulatorTiming("report-simulator-timing", "Report the time spent in the individual steps of the simulator");
+    QCommandLineOption lockstep("lockstep", "Run simulator, tracking and strategies in lockstep as fast as possible. Runs with the same seed produce identical results");
+    QCommandLineOption seedOption("seed", "Seed of the simulator when running in lockstep. Defaults to 0", "seed", "0");
     parser.addOption(strategyColorConfig);
     parser.addOption(debugOption);
     parser.addOption(simulatorConfig);
@@ -72,6 +81,11 @@ int main(int argc, char* argv[])
     parser.addOption(realismConfig);
     parser.addOption(silent);
     parser.addOption(forceStart);
+    parser.addOption(frameAlignedTracking);
+    parser.addOption(reportLatency);
+    parser.addOption(reportSimulatorTiming);
+    parser.addOption(lockstep);
+    parser.addOption(seedOption);
 
     // parse command line, handles --version
     parser.process(app);
@@ -96,17 +110,43 @@ int main(int argc, char* argv[])
     bool debug = parser.isSet(debugOption);
     int simulationRunningTime = parser.value(simulationTime).toInt();
     int numRobots = parser.value(numberOfRobots).toInt();
+    bool runLockstep = parser.isSet(lockstep);
+
+    if (runLockstep && (parser.isSet(autorefInitScript) || parser.isSet(simulationSpeed))) {
+        std::cerr <<"Autoref and simulation speed are not available in lockstep mode"<<std::endl;
+        exit(1);
+    }
 
     Connector connector;
 
     // compile the strategy beforehand to avoid using old compiles
     connector.compileStrategy(app, initScript);
 
-    AmunClient amun;
-    amun.start(true);
-
-    connector.connect(&connector, &Connector::sendCommand, &amun, &AmunClient::sendCommand);
-    connector.connect(&amun, &AmunClient::gotStatus, &connector, &Connector::handleStatus);
+    std::unique_ptr<AmunClient> amun;
+    CompilerRegistry compilerRegistry;
+    std::unique_ptr<LockstepAmun> lockstepAmun;
+    if (runLockstep) {
+        bool conversionSucceeded;
+        uint32_t seed = parser.value(seedOption).toUInt(&conversionSucceeded);
+        if (!conversionSucceeded) {
+            std::cerr <<"Seed must be a positive integer!"<<std::endl;
+            exit(1);
+        }
+        amun::SimulatorSetup defaultSetup;
+        simulatorSetupSetDefault(defaultSetup);
+        lockstepAmun.reset(new LockstepAmun(defaultSetup, &compilerRegistry, seed, runBlueStrategy, runYellowStrategy));
+        // the simulator timing is measured with the wall clock
+        lockstepAmun->setDeterministicStatus(!parser.isSet(reportSimulatorTiming));
+
+        connector.connect(&connector, &Connector::sendCommand, lockstepAmun.get(), &LockstepAmun::handleCommand);
+        connector.connect(lockstepAmun.get(), &LockstepAmun::sendStatus, &connector, &Connector::handleStatus);
+    } else {
+        amun.reset(new AmunClient);
+        amun->start(true);
+
+        connector.connect(&connector, &Connector::sendCommand, amun.get(), &AmunClient::sendCommand);
+        connector.connect(amun.get(), &AmunClient::gotStatus, &connector, &Connector::handleStatus);
+    }
 
     if (parser.isSet(recordLog)) {
         bool record = true;
@@ -149,6 +189,9 @@ int main(int argc, char* argv[])
     connector.setReportEvents(parser.isSet(reportEvents));
     connector.setSilent(parser.isSet(silent));
     connector.setForceStartGame(parser.isSet(forceStart));
+    connector.setFrameAlignedTracking(parser.isSet(frameAlignedTracking));
+    connector.setReportLatency(parser.isSet(reportLatency));
+    connector.setReportSimulatorTiming(parser.isSet(reportSimulatorTiming));
 
     if (parser.isSet(backlog)) {
         connector.setBacklogDirectory(parser.value(backlog));
@@ -165,5 +208,27 @@ int main(int argc, char* argv[])
 
     connector.start();
 
+    QTimer lockstepTimer;
+    if (runLockstep) {
+        // run a batch of steps per event loop iteration, to let the backlog writer and exit requests through
+        lockstepTimer.setInterval(0);
+        lockstepTimer.connect(&lockstepTimer, &QTimer::timeout, [&connector, &lockstepAmun] {
+            for (int i = 0; i < 100 && !connector.exitRequested() && !lockstepAmun->isPaused(); i++) {
+                lockstepAmun->step();
+            }
+        });
+        // do not spin while paused, the timer is started again once the simulation is resumed
+        lockstepTimer.connect(lockstepAmun.get(), &LockstepAmun::pausedChanged, &lockstepTimer, [&lockstepTimer](bool paused) {
+            if (paused) {
+                lockstepTimer.stop();
+            } else {
+                lockstepTimer.start();
+            }
+        });
+        if (!lockstepAmun->isPaused()) {
+            lockstepTimer.start();
+        }
+    }
+
     return app.exec();
 }
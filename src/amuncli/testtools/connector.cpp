@@ -42,6 +42,8 @@
 #include <iostream>
 #include <memory>
 #include <array>
+#include <algorithm>
+#include <numeric>
 
 Connector::Connector(QObject *parent) :
     QObject(parent),
@@ -77,6 +79,7 @@ void Connector::compileStrategy(QCoreApplication &app, QString initScript)
 
 void Connector::delayedExit(int exitCode)
 {
+    m_exitRequested = true;
     QTimer::singleShot(0, qApp, [exitCode, this]{performExit(exitCode);});
 }
 
@@ -214,6 +217,14 @@ void Connector::start()
     // set simulation speed
     command->mutable_simulator()->mutable_ssl_control()->set_simulation_speed(m_simulationSpeed / 100.0f);
 
+    if (m_frameAlignedTracking) {
+        command->mutable_tracking()->set_frame_aligned_processing(true);
+    }
+
+    if (m_reportSimulatorTiming) {
+        command->mutable_simulator()->set_measure_step_timing(true);
+    }
+
     if (m_runBlue) {
         addStrategyLoad(command->mutable_strategy_blue(), m_initScript, m_entryPoint);
     }
@@ -293,12 +304,82 @@ void Connector::reportEvents()
     }
 }
 
+void Connector::reportLatency()
+{
+    if (!m_reportLatency) {
+        return;
+    }
+    m_reportLatency = false;
+
+    std::cout <<std::endl<<"Vision to command latency:"<<std::endl;
+    if (m_visionToCommandTimes.empty()) {
+        std::cout <<"No vision frames received"<<std::endl;
+        return;
+    }
+    std::sort(m_visionToCommandTimes.begin(), m_visionToCommandTimes.end());
+    const float sum = std::accumulate(m_visionToCommandTimes.begin(), m_visionToCommandTimes.end(), 0.0f);
+    auto percentile = [this](float p) {
+        return m_visionToCommandTimes[std::size_t(p * (m_visionToCommandTimes.size() - 1))];
+    };
+    std::cout <<"Mode: "<<(m_frameAlignedTracking ? "frame aligned" : "fixed timer")<<std::endl;
+    std::cout <<"Mean: "<<sum / m_visionToCommandTimes.size() * 1000<<" ms"<<std::endl;
+    std::cout <<"Median: "<<percentile(0.5f) * 1000<<" ms"<<std::endl;
+    std::cout <<"95th percentile: "<<percentile(0.95f) * 1000<<" ms"<<std::endl;
+    std::cout <<"Max: "<<m_visionToCommandTimes.back() * 1000<<" ms"<<std::endl;
+}
+
+void Connector::reportSimulatorTiming()
+{
+    if (!m_reportSimulatorTiming) {
+        return;
+    }
+    m_reportSimulatorTiming = false;
+
+    std::cout <<std::endl<<"Simulator timing:"<<std::endl;
+    if (m_simulatorRuns == 0) {
+        std::cout <<"No simulator timing received"<<std::endl;
+        return;
+    }
+    std::cout <<"Total: "<<m_simulatorTime / m_simulatorRuns * 1000<<" ms per step"<<std::endl;
+    const google::protobuf::Descriptor *descriptor = amun::SimulatorTiming::descriptor();
+    for (int i = 0; i < descriptor->field_count(); i++) {
+        const google::protobuf::FieldDescriptor *field = descriptor->field(i);
+        const double mean = m_simulatorStepTimes[i] / m_simulatorRuns;
+        if (field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_FLOAT) {
+            std::cout <<field->name()<<": "<<mean<<" per step"<<std::endl;
+            continue;
+        }
+        std::cout <<field->name()<<": "<<mean * 1000<<" ms per step ("
+                 <<m_simulatorStepTimes[i] / m_simulatorTime * 100<<" %)"<<std::endl;
+    }
+}
+
 void Connector::handleStatus(const Status &status)
 {
     emit backlogStatus(status);
 
     m_logfile.writeStatus(status);
 
+    if (m_reportLatency && status->has_timing() && status->timing().has_vision_to_command()) {
+        m_visionToCommandTimes.push_back(status->timing().vision_to_command());
+    }
+    if (m_reportSimulatorTiming && status->has_timing() && status->timing().has_simulator_steps()) {
+        const amun::SimulatorTiming &steps = status->timing().simulator_steps();
+        const google::protobuf::Descriptor *descriptor = steps.GetDescriptor();
+        const google::protobuf::Reflection *reflection = steps.GetReflection();
+        m_simulatorStepTimes.resize(descriptor->field_count(), 0);
+        for (int i = 0; i < descriptor->field_count(); i++) {
+            const google::protobuf::FieldDescriptor *field = descriptor->field(i);
+            if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_FLOAT) {
+                m_simulatorStepTimes[i] += reflection->GetFloat(steps, field);
+            } else {
+                m_simulatorStepTimes[i] += reflection->GetInt32(steps, field);
+            }
+        }
+        m_simulatorTime += status->timing().simulator();
+        m_simulatorRuns++;
+    }
+
     QSet<amun::DebugSource> expectedSources;
     if (m_runBlue || m_isInCompileMode) {
         expectedSources.insert(amun::StrategyBlue);
@@ -351,6 +432,8 @@ void Connector::handleStatus(const Status &status)
     }
     if (status->time() - m_simulationStartTime >= m_simulationRunningTime) {
         reportEvents();
+        reportLatency();
+        reportSimulatorTiming();
         delayedExit(0);
     }
 
@@ -381,6 +464,8 @@ void Connector::handleStatus(const Status &status)
 
         if (p.second == "STRATEGY_CRASH") {
             reportEvents();
+            reportLatency();
+            reportSimulatorTiming();
             delayedExit(m_exitCode);
         }
     }
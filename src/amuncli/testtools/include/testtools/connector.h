@@ -34,6 +34,7 @@
 #include <string>
 #include <utility>
 #include <map>
+#include <vector>
 #include <QCoreApplication>
 
 class Connector : public QObject
@@ -63,8 +64,13 @@ public:
     void setRealismConfig(const QString &shortFile);
     void setSilent(bool silent) { m_isSilent = silent; }
     void setForceStartGame(bool forceStart) { m_forceStart = forceStart; }
+    void setFrameAlignedTracking(bool frameAligned) { m_frameAlignedTracking = frameAligned; }
+    void setReportLatency(bool report) { m_reportLatency = report; }
+    void setReportSimulatorTiming(bool report) { m_reportSimulatorTiming = report; }
 
     void start();
+    // true as soon as the connector decided to quit the application
+    bool exitRequested() const { return m_exitRequested; }
 
     void compileStrategy(QCoreApplication &app, QString initScript);
 
@@ -85,6 +91,8 @@ private:
     void performExit(int exit);
     void stopAmunAndSaveBacklog(QString directory);
     void reportEvents();
+    void reportLatency();
+    void reportSimulatorTiming();
 
     struct OptionInfo {
         bool value;
@@ -98,12 +106,16 @@ private:
     bool m_runYellow = false;
     bool m_debug = false;
     int m_exitCode = 255;
+    bool m_exitRequested = false;
     std::map<std::string, OptionInfo> m_options;
     bool m_reportEvents = false;
     int m_simulationSpeed = 100;
     bool m_isInCompileMode = false;
     bool m_isSilent = false;
     bool m_forceStart = false;
+    bool m_frameAlignedTracking = false;
+    bool m_reportLatency = false;
+    bool m_reportSimulatorTiming = false;
 
     QString m_simulatorConfigurationFile;
     qint64 m_simulationRunningTime = std::numeric_limits<qint64>::max();
@@ -117,6 +129,11 @@ private:
     bool m_recordLogfile = false;
 
     std::map<gameController::GameEvent::Type, std::size_t> m_eventCounter;
+    std::vector<float> m_visionToCommandTimes;
+    // summed up values of each field of amun::SimulatorTiming
+    std::vector<double> m_simulatorStepTimes;
+    double m_simulatorTime = 0;
+    int m_simulatorRuns = 0;
     gameController::GameEvent m_lastGameEvent;
 
     BacklogWriter m_backlogWriter;
@@ -49,4 +49,29 @@ private:
     qint64 m_offset;
 };
 
+// adds the wall clock time until it is destroyed or finished to the given field of a
+// timing struct, if timing is enabled by its member enabled
+template<typename Timings>
+class ScopedTiming
+{
+public:
+    ScopedTiming(Timings *timings, qint64 Timings::*target) :
+        m_timings(timings), m_target(target), m_start(timings->enabled ? Timer::systemTime() : 0) {}
+    ~ScopedTiming() { finish(); }
+    void finish()
+    {
+        if (m_timings && m_timings->enabled) {
+            m_timings->*m_target += Timer::systemTime() - m_start;
+        }
+        m_timings = nullptr;
+    }
+    ScopedTiming(const ScopedTiming&) = delete;
+    ScopedTiming& operator=(const ScopedTiming&) = delete;
+
+private:
+    Timings *m_timings;
+    qint64 Timings::*m_target;
+    qint64 m_start;
+};
+
 #endif // TIMER_H
@@ -0,0 +1,39 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef VISIONFRAME_H
+#define VISIONFRAME_H
+
+#include "protobuf/ssl_wrapper.pb.h"
+#include "protobuf/world.pb.h"
+#include <memory>
+#include <vector>
+
+// One simulated vision frame, that is a wrapper packet per camera and the true simulator state.
+// Frames are handed out by the simulator from a pool and are reused as soon as no
+// receiver holds a reference anymore, thus they must not be modified after being sent.
+struct SimulatorVisionFrame {
+    std::vector<SSL_WrapperPacket> packets;
+    world::SimulatorState simulatorState;
+};
+
+typedef std::shared_ptr<const SimulatorVisionFrame> SimulatorVisionFramePtr;
+
+#endif // VISIONFRAME_H
@@ -74,6 +74,7 @@ private slots:
     void sendEnableDebug(bool enable);
     void sendTriggerDebug();
     void sendPerformanceDebug(bool enable);
+    void sendContinuousProfiling(bool enable);
     void sendAutomaticEntrypoints();
 
 private:
@@ -100,6 +101,7 @@ private:
     QAction *m_reloadAction;
     QAction *m_debugAction;
     QAction *m_performanceAction;
+    QAction *m_profileAction;
     QAction *m_automaticEntrypointAction;
     bool m_userAutoReload;
     bool m_notification;
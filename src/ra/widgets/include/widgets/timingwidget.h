@@ -22,9 +22,17 @@
 #define TIMINGWIDGET_H
 
 #include "protobuf/status.h"
+#include <QList>
+#include <QPair>
 #include <QStandardItemModel>
 #include <QWidget>
 
+namespace google {
+namespace protobuf {
+class FieldDescriptor;
+}
+}
+
 namespace Ui {
 class TimingWidget;
 }
@@ -57,6 +65,8 @@ private:
     Ui::TimingWidget *ui;
     QStandardItemModel *m_model;
     QMap<int, Value> m_values;
+    // shown timing field for each row, the second entry is set for fields of nested timing messages
+    QList<QPair<const google::protobuf::FieldDescriptor*, const google::protobuf::FieldDescriptor*>> m_fields;
 };
 
 #endif // TIMINGWIDGET_H
@@ -140,6 +140,10 @@ void TeamWidget::init(amun::StatusStrategyWrapper::StrategyType type, bool tourn
     m_performanceAction->setChecked(true);
     connect(m_performanceAction, SIGNAL(toggled(bool)), SLOT(sendPerformanceDebug(bool)));
 
+    m_profileAction = reload_menu->addAction("Continuous profiling");
+    m_profileAction->setCheckable(true);
+    connect(m_profileAction, SIGNAL(toggled(bool)), SLOT(sendContinuousProfiling(bool)));
+
     m_automaticEntrypointAction = reload_menu->addAction("Edit automatic entrypoints");
     connect(m_automaticEntrypointAction, &QAction::triggered, this, &TeamWidget::showAutomaticEntrypointDialog);
 
@@ -179,6 +183,7 @@ void TeamWidget::enableContent(bool enable)
     m_btnEnableDebug->setEnabled(enable && m_type != amun::StatusStrategyWrapper::AUTOREF);
     m_debugAction->setEnabled(enable);
     m_performanceAction->setEnabled(enable);
+    m_profileAction->setEnabled(enable);
     m_contentEnabled = enable;
 
     if (!m_isTournamentMode) {
@@ -550,6 +555,23 @@ void TeamWidget::sendPerformanceDebug(bool enable)
     emit sendCommand(command);
 }
 
+void TeamWidget::sendContinuousProfiling(bool enable)
+{
+    Command command(new amun::Command);
+    amun::CommandStrategy *strategy = commandStrategyFromType(command);
+
+    if (enable) {
+        // samples every millisecond, low enough overhead to keep it running for a whole game
+        strategy->mutable_continuous_profile()->set_start_interval(1000);
+    } else {
+        // the profile is dropped if no file is selected
+        QString filename = QFileDialog::getSaveFileName(this, "Save profile", QString(),
+                "Collapsed stacks (*.folded);;Speedscope (*.json)");
+        strategy->mutable_continuous_profile()->set_stop_and_save(filename.toStdString());
+    }
+    emit sendCommand(command);
+}
+
 void TeamWidget::sendAutomaticEntrypoints()
 {
     if (m_automaticEntrypoints.allNull()) {
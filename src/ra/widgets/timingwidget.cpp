@@ -35,11 +35,27 @@ TimingWidget::TimingWidget(QWidget *parent) :
     ui->treeView->setUniformRowHeights(true); // speedup
     ui->treeView->setModel(m_model);
 
-    // create entries by introspection
+    // create entries by introspection, only times are shown
     const google::protobuf::Descriptor *desc = amun::Timing::descriptor();
     for (int i = 0; i < desc->field_count(); i++) {
         const google::protobuf::FieldDescriptor *field = desc->field(i);
-        QStandardItem *key = new QStandardItem(QString::fromStdString(field->name()));
+        if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_FLOAT) {
+            m_fields.append({field, nullptr});
+        } else if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+            const google::protobuf::Descriptor *subDesc = field->message_type();
+            for (int j = 0; j < subDesc->field_count(); j++) {
+                if (subDesc->field(j)->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_FLOAT) {
+                    m_fields.append({field, subDesc->field(j)});
+                }
+            }
+        }
+    }
+    for (const auto &entry : m_fields) {
+        QString name = QString::fromStdString(entry.first->name());
+        if (entry.second) {
+            name += "." + QString::fromStdString(entry.second->name());
+        }
+        QStandardItem *key = new QStandardItem(name);
         QStandardItem *time = new QStandardItem;
         time->setTextAlignment(Qt::AlignRight);
         QStandardItem *frequency = new QStandardItem;
@@ -78,14 +94,22 @@ void TimingWidget::handleStatus(const Status &status)
     if (status->has_timing()) {
         const amun::Timing &t = status->timing();
         const google::protobuf::Reflection *refl = t.GetReflection();
-        const google::protobuf::Descriptor *desc = amun::Timing::descriptor();
         // extract fields using reflection
-        for (int i = 0; i < desc->field_count(); i++) {
-            const google::protobuf::FieldDescriptor *field = desc->field(i);
-            if (refl->HasField(t, field)) {
+        for (int i = 0; i < m_fields.size(); i++) {
+            const google::protobuf::Message *message = &t;
+            const google::protobuf::FieldDescriptor *field = m_fields[i].first;
+            if (m_fields[i].second) {
+                if (!refl->HasField(t, field)) {
+                    continue;
+                }
+                message = &refl->GetMessage(t, field);
+                field = m_fields[i].second;
+            }
+            const google::protobuf::Reflection *messageRefl = message->GetReflection();
+            if (messageRefl->HasField(*message, field)) {
                 Value &value = m_values[i];
                 value.iterations++;
-                value.time = qMax(value.time, refl->GetFloat(t, field));
+                value.time = qMax(value.time, messageRefl->GetFloat(*message, field));
             }
         }
     }
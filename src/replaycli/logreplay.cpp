@@ -0,0 +1,214 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "logreplay.h"
+#include "replaytestrunner.h"
+#include "core/timer.h"
+#include "seshat/logfilereader.h"
+#include "seshat/visionlogliveconverter.h"
+#include "strategy/strategy.h"
+#include <QList>
+#include <QTimer>
+#include <functional>
+
+std::shared_ptr<StatusSource> openLogFile(const QString &filename, QString &error)
+{
+    QList<std::function<QPair<std::shared_ptr<StatusSource>, QString>(QString)>> openFunctions =
+        {&VisionLogLiveConverter::tryOpen, &LogFileReader::tryOpen};
+    for (const auto &openFunction : openFunctions) {
+        auto openResult = openFunction(filename);
+
+        if (openResult.first != nullptr) {
+            return openResult.first;
+        } else if (!openResult.second.isEmpty()) {
+            // the header matched, but the log file is corrupt
+            error = "Error: " + openResult.second;
+            return nullptr;
+        }
+    }
+    error = "Error: Could not open log file - no matching format found";
+    return nullptr;
+}
+
+// feeds the packet with the given index to the strategy
+static void replayPacket(StatusSource *logfile, Strategy *strategy, bool asBlue, int packet, ReplayProgress &progress)
+{
+    Status status = logfile->readStatus(packet);
+
+    if ((status->has_blue_running() && asBlue) || (status->has_yellow_running() && !asBlue)) {
+        progress.hasExecutionState = true;
+    }
+
+    // give the team information to the strategy
+    if (status->has_team_blue()) {
+        Command command(new amun::Command);
+        robot::Team * teamBlue = command->mutable_set_team_blue();
+        teamBlue->CopyFrom(status->team_blue());
+        strategy->handleCommand(command);
+    }
+    if (status->has_team_yellow()) {
+        Command command(new amun::Command);
+        robot::Team * teamYellow = command->mutable_set_team_yellow();
+        teamYellow->CopyFrom(status->team_yellow());
+        strategy->handleCommand(command);
+    }
+
+    strategy->handleStatus(status);
+
+    if (progress.lastExecutionTime == 0) {
+        progress.lastExecutionTime = status->time();
+    }
+    // every 10 ms
+    if (!progress.hasExecutionState && status->time() - progress.lastExecutionTime > 10000000) {
+        strategy->tryProcess();
+        progress.lastExecutionTime = status->time();
+    }
+}
+
+void replayLog(StatusSource *logfile, Strategy *strategy, bool asBlue,
+               const QString &profileFile, int profileStart, int profileEnd)
+{
+    const int packetCount = logfile->packetCount();
+    if (profileEnd < 0) {
+        profileEnd = packetCount - 1;
+    }
+
+    ReplayProgress progress;
+    for (int i = 0; i<packetCount; i++) {
+        if (!profileFile.isEmpty() && i == profileStart) {
+            Command command(new amun::Command);
+            if (asBlue) {
+                command->mutable_strategy_blue()->set_start_profiling(true);
+            } else {
+                command->mutable_strategy_yellow()->set_start_profiling(true);
+            }
+            strategy->handleCommand(command);
+        }
+
+        replayPacket(logfile, strategy, asBlue, i, progress);
+
+        if (!profileFile.isEmpty() && i == profileEnd) {
+            Command command(new amun::Command);
+            if (asBlue) {
+                command->mutable_strategy_blue()->set_finish_and_save_profile(profileFile.toStdString());
+            } else {
+                command->mutable_strategy_yellow()->set_finish_and_save_profile(profileFile.toStdString());
+            }
+            strategy->handleCommand(command);
+        }
+    }
+}
+
+LogReplay::LogReplay(const LogReplaySetup &setup, CompilerRegistry *registry, const QString &logFile) :
+    m_setup(setup),
+    m_registry(registry)
+{
+    m_result.logFile = logFile;
+    m_result.statistics = TimingStatistics(setup.asBlue, nullptr);
+
+    m_stepTimer = new QTimer(this);
+    m_stepTimer->setInterval(0);
+    connect(m_stepTimer, &QTimer::timeout, this, &LogReplay::step);
+}
+
+// the strategy is destroyed before its timer and game controller connection
+LogReplay::~LogReplay() = default;
+
+void LogReplay::start()
+{
+    m_wallStart = Timer::systemTime();
+
+    QString error;
+    m_logfile = openLogFile(m_result.logFile, error);
+    if (!m_logfile) {
+        m_result.failure = error;
+        finish();
+        return;
+    }
+
+    m_timer.reset(new Timer);
+    m_timer->setTime(m_logfile->readStatus(0)->time(), 1.0);
+    m_gameControllerConnection = std::make_shared<StrategyGameControllerMediator>(false);
+    m_strategy.reset(new Strategy(m_timer.get(), m_setup.asBlue ? StrategyType::BLUE : StrategyType::YELLOW, nullptr,
+                                  m_registry, m_gameControllerConnection, false, true));
+    connect(m_strategy.get(), &Strategy::sendStatus, this, &LogReplay::handleStatus);
+
+    m_strategy->handleCommand(createLoadCommand(m_setup.asBlue, m_setup.initScript, m_setup.entryPoint, m_setup.enablePerformanceMode));
+    m_stepTimer->start();
+}
+
+void LogReplay::step()
+{
+    if (m_packet >= m_logfile->packetCount()) {
+        finish();
+        return;
+    }
+    replayPacket(m_logfile.get(), m_strategy.get(), m_setup.asBlue, m_packet, m_progress);
+    m_packet++;
+}
+
+void LogReplay::finish()
+{
+    m_stepTimer->stop();
+    m_result.wallTime = (Timer::systemTime() - m_wallStart) * 1E-9;
+    emit finished();
+}
+
+void LogReplay::handleStatus(const Status &status)
+{
+    m_result.statistics.handleStatus(status);
+    if (m_result.failure.isEmpty() && status->has_status_strategy()
+            && status->status_strategy().status().state() == amun::StatusStrategy::FAILED) {
+        m_result.failure = "Strategy failed";
+    }
+}
+
+LogReplayWorker::LogReplayWorker(const LogReplaySetup &setup, CompilerRegistry *registry, const QStringList &logFiles,
+                                 std::atomic<int> &nextLog, std::vector<LogReplayResult> &results) :
+    m_setup(setup),
+    m_registry(registry),
+    m_logFiles(logFiles),
+    m_nextLog(nextLog),
+    m_results(results)
+{ }
+
+LogReplayWorker::~LogReplayWorker() = default;
+
+void LogReplayWorker::runNext()
+{
+    // the previous replay is destroyed in the thread it was used in
+    m_replay.reset();
+
+    m_index = m_nextLog++;
+    if (m_index >= m_logFiles.size()) {
+        emit done();
+        return;
+    }
+    m_replay.reset(new LogReplay(m_setup, m_registry, m_logFiles[m_index]));
+    connect(m_replay.get(), &LogReplay::finished, this, &LogReplayWorker::replayFinished);
+    m_replay->start();
+}
+
+void LogReplayWorker::replayFinished()
+{
+    m_results[m_index] = m_replay->result();
+    // do not delete the replay while it is still emitting its finished signal
+    QMetaObject::invokeMethod(this, "runNext", Qt::QueuedConnection);
+}
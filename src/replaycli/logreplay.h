@@ -0,0 +1,155 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LOGREPLAY_H
+#define LOGREPLAY_H
+
+#include "timingstatistics.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class CompilerRegistry;
+class QTimer;
+class StatusSource;
+class Strategy;
+class StrategyGameControllerMediator;
+class Timer;
+
+// returns nullptr and sets error if the log file could not be opened
+std::shared_ptr<StatusSource> openLogFile(const QString &filename, QString &error);
+
+/*!
+ * \brief Feeds all packets of a log to a strategy
+ *
+ * Frames without strategy execution state are processed every 10 ms of log time.
+ * If profileFile is set, the strategy is profiled from frame profileStart to profileEnd.
+ */
+void replayLog(StatusSource *logfile, Strategy *strategy, bool asBlue,
+               const QString &profileFile = QString(), int profileStart = 0, int profileEnd = -1);
+
+/*! \brief Position of a replay in its log, used to feed a log packet by packet */
+struct ReplayProgress
+{
+    bool hasExecutionState = false;
+    qint64 lastExecutionTime = 0;
+};
+
+/*! \brief Configuration shared by all replays, it is never modified while the replays run */
+struct LogReplaySetup
+{
+    QString initScript;
+    QString entryPoint;
+    bool asBlue = false;
+    bool enablePerformanceMode = false;
+};
+
+struct LogReplayResult
+{
+    LogReplayResult() : statistics(false, nullptr) { }
+
+    QString logFile;
+    // empty if the log was replayed without the strategy failing
+    QString failure;
+    TimingStatistics statistics;
+    // in seconds
+    double wallTime = 0;
+};
+
+/*!
+ * \brief Replays one log with its own strategy instance, used to replay many logs in parallel
+ *
+ * One packet is fed to the strategy per event loop iteration, so the timers and queued
+ * connections of the strategy work as in Ra. The replay has to be created in the thread
+ * that runs it, the strategy and its isolate are only used by this thread.
+ */
+class LogReplay : public QObject
+{
+    Q_OBJECT
+public:
+    LogReplay(const LogReplaySetup &setup, CompilerRegistry *registry, const QString &logFile);
+    ~LogReplay() override;
+    LogReplay(const LogReplay&) = delete;
+    LogReplay& operator=(const LogReplay&) = delete;
+
+    void start();
+    const LogReplayResult &result() const { return m_result; }
+
+signals:
+    void finished();
+
+private slots:
+    void step();
+
+private:
+    void handleStatus(const Status &status);
+    void finish();
+
+    const LogReplaySetup &m_setup;
+    CompilerRegistry *m_registry;
+    LogReplayResult m_result;
+    qint64 m_wallStart = 0;
+
+    std::shared_ptr<StatusSource> m_logfile;
+    std::unique_ptr<Timer> m_timer;
+    std::shared_ptr<StrategyGameControllerMediator> m_gameControllerConnection;
+    std::unique_ptr<Strategy> m_strategy;
+    ReplayProgress m_progress;
+    int m_packet = 0;
+    QTimer *m_stepTimer;
+};
+
+/*!
+ * \brief Replays logs in the thread it was moved to, until all logs are done
+ *
+ * The workers of all threads take the next log from a shared counter,
+ * the results are written to the slot of the log index.
+ */
+class LogReplayWorker : public QObject
+{
+    Q_OBJECT
+public:
+    LogReplayWorker(const LogReplaySetup &setup, CompilerRegistry *registry, const QStringList &logFiles,
+                    std::atomic<int> &nextLog, std::vector<LogReplayResult> &results);
+    ~LogReplayWorker() override;
+
+signals:
+    void done();
+
+public slots:
+    void runNext();
+
+private slots:
+    void replayFinished();
+
+private:
+    const LogReplaySetup &m_setup;
+    CompilerRegistry *m_registry;
+    const QStringList &m_logFiles;
+    std::atomic<int> &m_nextLog;
+    std::vector<LogReplayResult> &m_results;
+    int m_index = -1;
+    std::unique_ptr<LogReplay> m_replay;
+};
+
+#endif // LOGREPLAY_H
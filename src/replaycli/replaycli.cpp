@@ -21,21 +21,27 @@
 #include <QCommandLineParser>
 #include <QCoreApplication>
 #include <QDir>
+#include <QDirIterator>
+#include <QFile>
 #include <QFileInfo>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
 #include <clocale>
 #include <QtGlobal>
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <vector>
 
-#include "seshat/logfilereader.h"
-#include "seshat/visionlogliveconverter.h"
+#include "seshat/statussource.h"
 #include "strategy/strategy.h"
 #include "strategy/strategyreplayhelper.h"
 #include "strategy/script/compilerregistry.h"
 #include "timingstatistics.h"
 #include "core/timer.h"
 #include "replaytestrunner.h"
+#include "logreplay.h"
 
 static std::ofstream fileStream;
 
@@ -58,6 +64,123 @@ void myMessageOutput(QtMsgType type, const QMessageLogContext &, const QString &
     }
 }
 
+static void sendContinuousProfileCommand(Strategy *strategy, bool asBlue, int startInterval, const QString &stopAndSave)
+{
+    Command command(new amun::Command);
+    amun::CommandStrategy *commandStrategy = asBlue ? command->mutable_strategy_blue() : command->mutable_strategy_yellow();
+    if (startInterval > 0) {
+        commandStrategy->mutable_continuous_profile()->set_start_interval(startInterval);
+    } else {
+        commandStrategy->mutable_continuous_profile()->set_stop_and_save(stopAndSave.toStdString());
+    }
+    strategy->handleCommand(command);
+}
+
+// inserts the run number before the file extension if there are multiple runs
+static QString runFileName(const QString &filename, int run, int runs)
+{
+    if (runs <= 1) {
+        return filename;
+    }
+    const QFileInfo info(filename);
+    const QString suffix = info.completeSuffix();
+    const QString baseName = suffix.isEmpty() ? info.fileName() : info.fileName().chopped(suffix.size() + 1);
+    return info.dir().filePath(baseName + "." + QString::number(run) + (suffix.isEmpty() ? QString() : "." + suffix));
+}
+
+// path is either a directory that is searched for logs or a text file with one log per line
+static QStringList collectLogFiles(const QString &path)
+{
+    QStringList logFiles;
+    const QFileInfo info(path);
+    if (info.isDir()) {
+        QDirIterator it(path, {"*.log"}, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            logFiles.append(it.next());
+        }
+        logFiles.sort();
+        return logFiles;
+    }
+
+    QFile listFile(path);
+    if (!listFile.open(QFile::ReadOnly | QFile::Text)) {
+        qFatal("Error: Could not open log list %s", qPrintable(path));
+    }
+    while (!listFile.atEnd()) {
+        const QString line = QString::fromUtf8(listFile.readLine()).trimmed();
+        if (!line.isEmpty() && !line.startsWith("#")) {
+            // relative paths are relative to the list
+            logFiles.append(info.dir().absoluteFilePath(line));
+        }
+    }
+    return logFiles;
+}
+
+static int replayLogs(const QStringList &logFiles, const QString &initScript, const QString &entryPoint, bool asBlue,
+                      bool enablePerformanceMode, int threads, CompilerRegistry *compilerRegistry, TimingWriter *timingWriter,
+                      bool showHistogram, bool showCumulativeHistogram)
+{
+    {
+        // compiling once in the main thread also initializes v8 before the worker threads use it
+        Timer timer;
+        timer.setTime(0, 1.0);
+        auto connection = std::make_shared<StrategyGameControllerMediator>(false);
+        Strategy strategy(&timer, asBlue ? StrategyType::BLUE : StrategyType::YELLOW, nullptr, compilerRegistry, connection, false, true);
+        strategy.compileIfNecessary(initScript);
+        QCoreApplication::processEvents();
+    }
+
+    // every thread runs its own event loop for the timers and queued connections of the strategies
+    const int threadCount = std::max(1, std::min(int(logFiles.size()), threads));
+    const LogReplaySetup setup{initScript, entryPoint, asBlue, enablePerformanceMode};
+    std::vector<LogReplayResult> results(logFiles.size());
+    std::atomic<int> nextLog(0);
+    std::vector<std::unique_ptr<QThread>> workerThreads;
+    std::vector<std::unique_ptr<LogReplayWorker>> workers;
+
+    const qint64 wallStart = Timer::systemTime();
+    for (int i = 0;i<threadCount;i++) {
+        workerThreads.emplace_back(new QThread);
+        workers.emplace_back(new LogReplayWorker(setup, compilerRegistry, logFiles, nextLog, results));
+        QThread *thread = workerThreads.back().get();
+        LogReplayWorker *worker = workers.back().get();
+        worker->moveToThread(thread);
+        QObject::connect(thread, &QThread::started, worker, &LogReplayWorker::runNext);
+        QObject::connect(worker, &LogReplayWorker::done, thread, &QThread::quit);
+        thread->start();
+    }
+    for (auto &thread : workerThreads) {
+        thread->wait();
+    }
+    const double wallTime = (Timer::systemTime() - wallStart) * 1E-9;
+
+    TimingStatistics allLogs(asBlue, timingWriter);
+    int failed = 0;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const LogReplayResult &result = results[i];
+        if (!result.failure.isEmpty()) {
+            failed++;
+        }
+        const QString run = QString::number(i);
+        timingWriter->printLog(run, result.logFile, result.failure);
+
+        TimingStatistics logStatistics(asBlue, timingWriter);
+        logStatistics.merge(result.statistics);
+        logStatistics.printStatistics(run, showHistogram, showCumulativeHistogram);
+        allLogs.merge(result.statistics);
+    }
+
+    const QString allRuns = "all";
+    timingWriter->printLog(allRuns, "all logs", failed > 0 ? QString("%1 of %2 failed").arg(failed).arg(results.size()) : QString());
+    allLogs.printStatistics(allRuns, showHistogram, showCumulativeHistogram);
+
+    std::cout << std::endl << "Logs: " << results.size() << ", failed: " << failed << std::endl;
+    std::cout << "Threads: " << threadCount << std::endl;
+    std::cout << "Wall time: " << wallTime << " s" << std::endl;
+
+    return failed > 0 ? 1 : 0;
+}
+
 int main(int argc, char* argv[])
 {
     QCoreApplication app(argc, argv);
@@ -70,7 +193,7 @@ int main(int argc, char* argv[])
     parser.setApplicationDescription("Log replay command line interface");
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.addPositionalArgument("logfile", "Log file to read");
+    parser.addPositionalArgument("logfile", "Log file to read, omitted if logs is set");
     parser.addPositionalArgument("strategy_file", "Strategy init script");
     parser.addPositionalArgument("entrypoint", "Entrypoint, optional. Uses main if missing.", "[entrypoint]");
 
@@ -89,9 +212,13 @@ int main(int argc, char* argv[])
     QCommandLineOption profileFile("profileOutfile", "Perform profiling and output the the result to the specified file", "filename");
     QCommandLineOption profileStart("profileStart", "Only has effect together with profileOutfile: in which log frame to start profiling", "start frame", "0");
     QCommandLineOption profileLength("profileLength", "Only has effect together with profileOutfile: for how many log frames to profile", "end frame");
+    QCommandLineOption profileContinuous("profileContinuous", "Profile the whole replay and write the aggregated samples to the specified file, as speedscope profile if it ends with .json and as collapsed stacks otherwise", "filename");
+    QCommandLineOption profileInterval("profileInterval", "Only has effect together with profileContinuous: sampling interval in microseconds", "interval", "1000");
     QCommandLineOption showLogOption({"l", "show-log"}, "Print log output to std::cout");
     QCommandLineOption abortExecution({"d", "die-on-error"}, "Die when a strategy problem occurs");
     QCommandLineOption runTestScript({"t", "test-script"}, "A script to evaluate the test results", "script");
+    QCommandLineOption logsOption("logs", "Replay every log in a directory or listed in a file (one per line) in parallel and summarize the timings", "logs");
+    QCommandLineOption threadCount({"j", "threads"}, "Only has effect together with logs: number of logs to replay in parallel, defaults to the number of cores", "threads");
 
 
     parser.addOption(asBlueOption);
@@ -105,15 +232,22 @@ int main(int argc, char* argv[])
     parser.addOption(profileFile);
     parser.addOption(profileStart);
     parser.addOption(profileLength);
+    parser.addOption(profileContinuous);
+    parser.addOption(profileInterval);
     parser.addOption(showLogOption);
     parser.addOption(abortExecution);
     parser.addOption(runTestScript);
+    parser.addOption(logsOption);
+    parser.addOption(threadCount);
 
     // parse command line
     parser.process(app);
 
+    const bool multipleLogs = parser.isSet(logsOption);
+    // the log file is not passed as positional argument when replaying multiple logs
+    const int logArgCount = multipleLogs ? 0 : 1;
     int argCount = parser.positionalArguments().size();
-    if (argCount != 2 && argCount != 3) {
+    if (argCount != logArgCount + 1 && argCount != logArgCount + 2) {
         parser.showHelp(1);
     }
 
@@ -126,33 +260,18 @@ int main(int argc, char* argv[])
         qFatal("Options show-log and test-script can not be combined!");
     }
 
+    if (multipleLogs && (runAsTest || showLog || abortExec || parser.isSet(prefix) || parser.isSet(printAllTimings)
+                         || parser.isSet(profileFile) || parser.isSet(profileContinuous) || parser.isSet(runs))) {
+        qFatal("Option logs can only be combined with the as-blue, csv, histogram and performance mode options!");
+    }
+
     qRegisterMetaType<Status>("Status");
     qRegisterMetaType<Command>("Command");
 
-    std::shared_ptr<StatusSource> logfile;
-
-    QList<std::function<QPair<std::shared_ptr<StatusSource>, QString>(QString)>> openFunctions =
-        {&VisionLogLiveConverter::tryOpen, &LogFileReader::tryOpen};
-    for (const auto &openFunction : openFunctions) {
-        const QStringList arguments = parser.positionalArguments();
-        auto openResult = openFunction(arguments.first());
-
-        if (openResult.first != nullptr) {
-            logfile = openResult.first;
-            break;
-        } else if (!openResult.second.isEmpty()) {
-            // the header matched, but the log file is corrupt
-            qFatal(("Error: " + openResult.second).toStdString().c_str());
-        }
-    }
-    if (!logfile) {
-        qFatal("Error: Could not open log file - no matching format found");
-    }
-
     const QStringList args = parser.positionalArguments();
     QDir currentDirectory(".");
-    const QString initScript = currentDirectory.absoluteFilePath(args.at(1));
-    const QString entryPoint = (argCount > 2) ? args.at(2) : QString();
+    const QString initScript = currentDirectory.absoluteFilePath(args.at(logArgCount));
+    const QString entryPoint = (argCount > logArgCount + 1) ? args.at(logArgCount + 1) : QString();
     const unsigned int runsI = parser.value(runs).toInt();
     const bool redirect = parser.isSet(prefix);
     const QString prefixS = parser.value(prefix);
@@ -170,6 +289,22 @@ int main(int argc, char* argv[])
         timingWriter = std::make_unique<StdoutWriter>();
     }
 
+    if (multipleLogs) {
+        const QStringList logFiles = collectLogFiles(parser.value(logsOption));
+        if (logFiles.isEmpty()) {
+            qFatal("Error: No log files found");
+        }
+        const int threads = parser.isSet(threadCount) ? parser.value(threadCount).toInt() : QThread::idealThreadCount();
+        return replayLogs(logFiles, initScript, entryPoint, asBlue, parser.isSet(enablePerformanceMode), threads,
+                          &compilerRegistry, timingWriter.get(), parser.isSet(showHistogramOption), parser.isSet(showHistogramCumulativeOption));
+    }
+
+    QString logError;
+    std::shared_ptr<StatusSource> logfile = openLogFile(args.first(), logError);
+    if (!logfile) {
+        qFatal("%s", qPrintable(logError));
+    }
+
     for (unsigned int i=0; i < runsI; ++i) {
         if (redirect) {
             //keep the reference to filename bytes alive
@@ -201,7 +336,9 @@ int main(int argc, char* argv[])
             parser.isSet(printAllTimings),
             logfile->packetCount() + 1
         };
-        statistics.connect(strategy.get(), &Strategy::sendStatus, &statistics, &TimingStatistics::handleStatus);
+        QObject::connect(strategy.get(), &Strategy::sendStatus, [&statistics](const Status &status) {
+                statistics.handleStatus(status);
+            });
         if (showLog) {
             strategy->connect(strategy.get(), &Strategy::sendStatus, [](const Status& s) {
                     for(const auto& debugValues : s->debug()) {
@@ -231,71 +368,23 @@ int main(int argc, char* argv[])
 
         // load the strategy
         strategy->handleCommand(createLoadCommand(asBlue, initScript, entryPoint, parser.isSet(enablePerformanceMode)));
+        if (parser.isSet(profileContinuous)) {
+            sendContinuousProfileCommand(strategy.get(), asBlue, std::max(parser.value(profileInterval).toInt(), 1), QString());
+        }
 
-        int packetCount = logfile->packetCount();
-        int startPosition = parser.value(profileStart).toInt();
-        int endPosition = parser.isSet(profileLength) ? startPosition + parser.value(profileLength).toInt() : packetCount - 1;
-
-        bool hasExecutionState = false;
-        qint64 lastExecutionTime = 0;
-        for (int i = 0; i<packetCount; i++) {
-            Status status = logfile->readStatus(i);
-
-            if ((status->has_blue_running() && asBlue) || (status->has_yellow_running() && !asBlue)) {
-                hasExecutionState = true;
-            }
-
-            // give the team information to the strategy
-            if (status->has_team_blue()) {
-                Command command(new amun::Command);
-                robot::Team * teamBlue = command->mutable_set_team_blue();
-                teamBlue->CopyFrom(status->team_blue());
-                strategy->handleCommand(command);
-            }
-            if (status->has_team_yellow()) {
-                Command command(new amun::Command);
-                robot::Team * teamYellow = command->mutable_set_team_yellow();
-                teamYellow->CopyFrom(status->team_yellow());
-                strategy->handleCommand(command);
-            }
-
-            if (parser.isSet(profileFile) && i == startPosition) {
-                Command command(new amun::Command);
-                if (asBlue) {
-                    command->mutable_strategy_blue()->set_start_profiling(true);
-                } else {
-                    command->mutable_strategy_yellow()->set_start_profiling(true);
-                }
-                strategy->handleCommand(command);
-            }
-
-            strategy->handleStatus(status);
+        const int startPosition = parser.value(profileStart).toInt();
+        const int endPosition = parser.isSet(profileLength) ? startPosition + parser.value(profileLength).toInt() : -1;
+        replayLog(logfile.get(), strategy.get(), asBlue, parser.value(profileFile), startPosition, endPosition);
 
-            if (lastExecutionTime == 0) {
-                lastExecutionTime = status->time();
-            }
-            // every 10 ms
-            if (!hasExecutionState && status->time() - lastExecutionTime > 10000000) {
-                strategy->tryProcess();
-                lastExecutionTime = status->time();
-            }
-
-            if (parser.isSet(profileFile) && i == endPosition) {
-                Command command(new amun::Command);
-                if (asBlue) {
-                    command->mutable_strategy_blue()->set_finish_and_save_profile(parser.value(profileFile).toStdString());
-                } else {
-                    command->mutable_strategy_yellow()->set_finish_and_save_profile(parser.value(profileFile).toStdString());
-                }
-                strategy->handleCommand(command);
-            }
+        if (parser.isSet(profileContinuous)) {
+            sendContinuousProfileCommand(strategy.get(), asBlue, 0, runFileName(parser.value(profileContinuous), i, runsI));
         }
 
         if (runAsTest) {
             testRunner->runFinalReplayJudgement();
         } else {
             // no timing statistics are printed if the cli is used as a replay test runner
-            statistics.printStatistics(i, parser.isSet(showHistogramOption), parser.isSet(showHistogramCumulativeOption));
+            statistics.printStatistics(QString::number(i), parser.isSet(showHistogramOption), parser.isSet(showHistogramCumulativeOption));
         }
     }
     return 0;
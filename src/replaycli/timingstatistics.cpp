@@ -23,16 +23,18 @@
 #include <QDir>
 #include <QString>
 #include <QtGlobal>
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 
-void StdoutWriter::printRun(int run, double totalTime, double average)
+void StdoutWriter::printRun(const QString &run, double totalTime, double average)
 {
     std::cout << "Total: "<< totalTime << " s"<<std::endl;
     std::cout << "Average: " << average << " ms" << std::endl;
 }
 
-void StdoutWriter::printHistogram(int run, const QVector<int>& timeHistogram)
+void StdoutWriter::printHistogram(const QString &run, const QVector<int>& timeHistogram)
 {
     (void) run;
 
@@ -42,7 +44,7 @@ void StdoutWriter::printHistogram(int run, const QVector<int>& timeHistogram)
     }
 }
 
-void StdoutWriter::printCumulativeHistogram(int run, const QVector<double>& perFramePercentage)
+void StdoutWriter::printCumulativeHistogram(const QString &run, const QVector<double>& perFramePercentage)
 {
     (void) run;
 
@@ -52,17 +54,53 @@ void StdoutWriter::printCumulativeHistogram(int run, const QVector<double>& perF
     }
 }
 
+void StdoutWriter::printGarbageCollection(const QString &run, int count, double totalPause, double maxPause, double idleTime)
+{
+    (void) run;
+
+    std::cout << "GC: " << count << " collections, " << totalPause * 1000.0 << " ms total pause, "
+              << maxPause * 1000.0 << " ms max pause per frame, " << idleTime * 1000.0 << " ms in idle time" << std::endl;
+}
+
+void StdoutWriter::printPercentiles(const QString &run, double p50, double p95, double p99)
+{
+    (void) run;
+
+    std::cout << "p50: " << p50 << " ms, p95: " << p95 << " ms, p99: " << p99 << " ms" << std::endl;
+}
+
+void StdoutWriter::printLog(const QString &run, const QString &logFile, const QString &failure)
+{
+    std::cout << std::endl << "Log " << run.toStdString() << ": " << logFile.toStdString();
+    if (!failure.isEmpty()) {
+        std::cout << " (" << failure.toStdString() << ")";
+    }
+    std::cout << std::endl;
+}
+
 CSVWriter::CSVWriter(const QFileInfo& baseFile, bool openHistogram, bool openCumulativeHistogram)
 {
     Q_ASSERT(!baseFile.isDir());
     const QDir baseDir = baseFile.dir();
     const QString baseFileName = baseFile.fileName();
+    // only written when replaying multiple logs
+    logListFileName = baseDir.filePath(baseFileName + ".logs.csv");
 
     const QString runFileName = baseDir.filePath(baseFileName + ".runs.csv");
     runFile.open(runFileName.toStdString().c_str());
     Q_ASSERT(runFile.is_open());
     runFile << "\"run\",\"total_s\",\"average_ms\"" << std::endl;
 
+    const QString gcFileName = baseDir.filePath(baseFileName + ".gc.csv");
+    gcFile.open(gcFileName.toStdString().c_str());
+    Q_ASSERT(gcFile.is_open());
+    gcFile << "\"run\",\"count\",\"pause_ms\",\"max_pause_ms\",\"idle_ms\"" << std::endl;
+
+    const QString percentileFileName = baseDir.filePath(baseFileName + ".percentiles.csv");
+    percentileFile.open(percentileFileName.toStdString().c_str());
+    Q_ASSERT(percentileFile.is_open());
+    percentileFile << "\"run\",\"p50_ms\",\"p95_ms\",\"p99_ms\"" << std::endl;
+
     if (openHistogram) {
         const QString fileName = baseDir.filePath(baseFileName + ".histogram.csv");
         histFile.open(fileName.toStdString().c_str());
@@ -78,29 +116,60 @@ CSVWriter::CSVWriter(const QFileInfo& baseFile, bool openHistogram, bool openCum
     }
 }
 
-void CSVWriter::printRun(int run, double totalTime, double average) {
+void CSVWriter::printRun(const QString &run, double totalTime, double average) {
     Q_ASSERT(runFile.is_open());
-    runFile << run << "," << totalTime << "," << average << std::endl;
+    runFile << run.toStdString() << "," << totalTime << "," << average << std::endl;
 }
 
-void CSVWriter::printHistogram(int run, const QVector<int>& timeHistogram) {
+void CSVWriter::printHistogram(const QString &run, const QVector<int>& timeHistogram) {
     Q_ASSERT(histFile.is_open());
     for (int i = 0; i < timeHistogram.size(); ++i) {
-        histFile << run << "," << i << "," << timeHistogram[i] << std::endl;
+        histFile << run.toStdString() << "," << i << "," << timeHistogram[i] << std::endl;
     }
 }
 
-void CSVWriter::printCumulativeHistogram(int run, const QVector<double>& perFramePercentages) {
+void CSVWriter::printCumulativeHistogram(const QString &run, const QVector<double>& perFramePercentages) {
     Q_ASSERT(cumulativeHistFile.is_open());
     for (int i = 0; i < perFramePercentages.size(); ++i) {
-        cumulativeHistFile << run << "," << std::setprecision(4) << i << "," << perFramePercentages[i] << std::endl;
+        cumulativeHistFile << run.toStdString() << "," << std::setprecision(4) << i << "," << perFramePercentages[i] << std::endl;
     }
 }
 
+void CSVWriter::printGarbageCollection(const QString &run, int count, double totalPause, double maxPause, double idleTime) {
+    Q_ASSERT(gcFile.is_open());
+    gcFile << run.toStdString() << "," << count << "," << totalPause * 1000.0 << "," << maxPause * 1000.0 << "," << idleTime * 1000.0 << std::endl;
+}
+
+void CSVWriter::printPercentiles(const QString &run, double p50, double p95, double p99) {
+    Q_ASSERT(percentileFile.is_open());
+    percentileFile << run.toStdString() << "," << p50 << "," << p95 << "," << p99 << std::endl;
+}
+
+void CSVWriter::printLog(const QString &run, const QString &logFile, const QString &failure) {
+    if (!logListFile.is_open()) {
+        logListFile.open(logListFileName.toStdString().c_str());
+        Q_ASSERT(logListFile.is_open());
+        logListFile << "\"run\",\"log\",\"failure\"" << std::endl;
+    }
+    QString escapedLog = logFile;
+    QString escapedFailure = failure;
+    escapedLog.replace("\"", "\"\"");
+    escapedFailure.replace("\"", "\"\"");
+    logListFile << run.toStdString() << ",\"" << escapedLog.toStdString() << "\",\"" << escapedFailure.toStdString() << "\"" << std::endl;
+}
+
 void TimingStatistics::handleStatus(const Status &status)
 {
     if (status->has_timing()) {
         const amun::Timing &timing = status->timing();
+        if ((m_isBlue && timing.has_blue_heap()) || (!m_isBlue && timing.has_yellow_heap())) {
+            const amun::StrategyHeapTiming &heap = m_isBlue ? timing.blue_heap() : timing.yellow_heap();
+            m_hasHeapTiming = true;
+            m_gcCount += heap.gc_count();
+            m_gcPause += heap.gc_pause();
+            m_gcPauseMax = std::max(m_gcPauseMax, double(heap.gc_pause()));
+            m_idleGc += heap.idle_gc();
+        }
         float time = -1;
         if (m_isBlue && timing.has_blue_total()) {
             time = timing.blue_total();
@@ -116,14 +185,13 @@ void TimingStatistics::handleStatus(const Status &status)
                 m_timeHistogram.resize(ms+1);
             }
             m_timeHistogram[ms]++;
-            if (m_saveAllData) {
-                m_timings.push_back(time);
-            }
+            // also needed for the percentiles
+            m_timings.push_back(time);
         }
     }
 }
 
-void TimingStatistics::printStatistics(int run, bool showHistogram, bool showCumulativeHistogram)
+void TimingStatistics::printStatistics(const QString &run, bool showHistogram, bool showCumulativeHistogram)
 {
     if (m_saveAllData) {
         for (float time : m_timings) {
@@ -132,6 +200,14 @@ void TimingStatistics::printStatistics(int run, bool showHistogram, bool showCum
     } else {
         m_writer->printRun(run, m_totalTime, 1000.0 * m_totalTime / m_counter);
 
+        if (!m_timings.isEmpty()) {
+            m_writer->printPercentiles(run, 1000.0 * percentile(50), 1000.0 * percentile(95), 1000.0 * percentile(99));
+        }
+
+        if (m_hasHeapTiming) {
+            m_writer->printGarbageCollection(run, m_gcCount, m_gcPause, m_gcPauseMax, m_idleGc);
+        }
+
         if (showHistogram) {
             m_writer->printHistogram(run, m_timeHistogram);
         }
@@ -151,3 +227,33 @@ void TimingStatistics::printStatistics(int run, bool showHistogram, bool showCum
         }
     }
 }
+
+void TimingStatistics::merge(const TimingStatistics &other)
+{
+    m_counter += other.m_counter;
+    m_totalTime += other.m_totalTime;
+    if (other.m_timeHistogram.size() > m_timeHistogram.size()) {
+        m_timeHistogram.resize(other.m_timeHistogram.size());
+    }
+    for (int i = 0; i < other.m_timeHistogram.size(); ++i) {
+        m_timeHistogram[i] += other.m_timeHistogram[i];
+    }
+    m_timings.append(other.m_timings);
+
+    m_hasHeapTiming = m_hasHeapTiming || other.m_hasHeapTiming;
+    m_gcCount += other.m_gcCount;
+    m_gcPause += other.m_gcPause;
+    m_gcPauseMax = std::max(m_gcPauseMax, other.m_gcPauseMax);
+    m_idleGc += other.m_idleGc;
+}
+
+double TimingStatistics::percentile(double p) const
+{
+    if (m_timings.isEmpty()) {
+        return 0;
+    }
+    QVector<float> sorted = m_timings;
+    const int rank = std::clamp(int(std::ceil(p / 100.0 * sorted.size())) - 1, 0, sorted.size() - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
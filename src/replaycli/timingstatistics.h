@@ -22,7 +22,7 @@
 #define TIMINGSTATISTICS_H
 
 #include <QFileInfo>
-#include <QObject>
+#include <QString>
 #include <QVector>
 #include <fstream>
 #include <memory>
@@ -34,39 +34,57 @@
 struct TimingWriter {
     virtual ~TimingWriter() = default;
 
-    virtual void printRun(int run, double totalTime, double average) = 0;
-    virtual void printHistogram(int run, const QVector<int>& timeHistogram) = 0;
-    virtual void printCumulativeHistogram(int run, const QVector<double>& perframepercentage) = 0;
+    virtual void printRun(const QString &run, double totalTime, double average) = 0;
+    virtual void printHistogram(const QString &run, const QVector<int>& timeHistogram) = 0;
+    virtual void printCumulativeHistogram(const QString &run, const QVector<double>& perframepercentage) = 0;
+    // pause times in seconds
+    virtual void printGarbageCollection(const QString &run, int count, double totalPause, double maxPause, double idleTime) = 0;
+    // frame times in milliseconds
+    virtual void printPercentiles(const QString &run, double p50, double p95, double p99) = 0;
+    // failure is empty if the log was replayed without the strategy failing
+    virtual void printLog(const QString &run, const QString &logFile, const QString &failure) = 0;
 };
 
 struct StdoutWriter : public TimingWriter {
-    void printRun(int run, double totalTime, double average) override;
-    void printHistogram(int run, const QVector<int>& timeHistogram) override;
-    void printCumulativeHistogram(int run, const QVector<double>& perFramePercentage) override;
+    void printRun(const QString &run, double totalTime, double average) override;
+    void printHistogram(const QString &run, const QVector<int>& timeHistogram) override;
+    void printCumulativeHistogram(const QString &run, const QVector<double>& perFramePercentage) override;
+    void printGarbageCollection(const QString &run, int count, double totalPause, double maxPause, double idleTime) override;
+    void printPercentiles(const QString &run, double p50, double p95, double p99) override;
+    void printLog(const QString &run, const QString &logFile, const QString &failure) override;
 };
 
 class CSVWriter : public TimingWriter {
 public:
     CSVWriter(const QFileInfo& baseFile, bool openHistogram, bool openCumulativeHistogram);
 
-    void printRun(int run, double totalTime, double average) override;
-    void printHistogram(int run, const QVector<int>& timeHistogram) override;
-    void printCumulativeHistogram(int run, const QVector<double>& perFramePercentage) override;
+    void printRun(const QString &run, double totalTime, double average) override;
+    void printHistogram(const QString &run, const QVector<int>& timeHistogram) override;
+    void printCumulativeHistogram(const QString &run, const QVector<double>& perFramePercentage) override;
+    void printGarbageCollection(const QString &run, int count, double totalPause, double maxPause, double idleTime) override;
+    void printPercentiles(const QString &run, double p50, double p95, double p99) override;
+    void printLog(const QString &run, const QString &logFile, const QString &failure) override;
 private:
+    QString logListFileName;
     std::ofstream runFile;
+    std::ofstream gcFile;
+    std::ofstream percentileFile;
+    std::ofstream logListFile;
     std::ofstream histFile;
     std::ofstream cumulativeHistFile;
 };
 
-class TimingStatistics : public QObject
+// plain accumulator, it may be filled in any thread as long as only one thread uses it at a time
+class TimingStatistics
 {
-    Q_OBJECT
 public:
     TimingStatistics(bool isBlue, TimingWriter* writer, bool saveAllData = false, int frames = 0) :
         m_isBlue(isBlue), m_writer(writer), m_saveAllData(saveAllData) { m_timings.reserve(frames); }
-    void printStatistics(int run, bool showHistogram, bool showCumulativeHistogram);
-
-public slots:
+    void printStatistics(const QString &run, bool showHistogram, bool showCumulativeHistogram);
+    // adds the frames of another replay, used to summarize many logs
+    void merge(const TimingStatistics &other);
+    // nearest rank percentile of the frame times in seconds, p in [0, 100]
+    double percentile(double p) const;
     void handleStatus(const Status &status);
 
 private:
@@ -77,6 +95,13 @@ private:
     double m_totalTime = 0.0;
     QVector<int> m_timeHistogram;
     QVector<float> m_timings;
+
+    // garbage collection of the strategy isolate, if reported
+    bool m_hasHeapTiming = false;
+    int m_gcCount = 0;
+    double m_gcPause = 0;
+    double m_gcPauseMax = 0;
+    double m_idleGc = 0;
 };
 
 #endif // TIMINGSTATISTICS_H
@@ -0,0 +1,225 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "simulatedmatch.h"
+#include "core/configuration.h"
+#include "core/timer.h"
+#include "strategy/strategy.h"
+#include "strategy/script/compilerregistry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <clocale>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+static robot::Team createTeam(const robot::Generation &generation, int numRobots, bool blue)
+{
+    robot::Team team;
+    for (int i = 0;i<numRobots;i++) {
+        robot::Specs *robot = team.add_robot();
+        robot->CopyFrom(generation.default_());
+        robot->set_id(blue ? (i > 15 ? i : (15 - i)) : i);
+    }
+    return team;
+}
+
+static void compileStrategy(CompilerRegistry *registry, const QString &initScript)
+{
+    // compiling once in the main thread also initializes v8 before the worker threads use it
+    Timer timer;
+    timer.setTime(0, 1.0);
+    auto connection = std::make_shared<StrategyGameControllerMediator>(false);
+    Strategy strategy(&timer, StrategyType::YELLOW, nullptr, registry, connection);
+    strategy.compileIfNecessary(initScript);
+}
+
+static QJsonObject toJson(const MatchResult &result)
+{
+    QJsonObject object;
+    object["index"] = result.index;
+    object["seed"] = double(result.seed);
+    object["strategy_failed"] = result.strategyFailed;
+    object["exit_code"] = result.exitCode;
+    object["simulated_time"] = result.simulatedTime * 1E-9;
+    object["wall_time"] = result.wallTime * 1E-9;
+    object["strategy_runs"] = result.strategyRuns;
+    object["strategy_time_mean"] = result.strategyRuns > 0 ? result.strategyTimeTotal / result.strategyRuns : 0.0;
+    object["strategy_time_max"] = result.strategyTimeMax;
+    return object;
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Simulation-Farm-CLI");
+    app.setOrganizationName("ER-Force");
+
+    std::setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs many simulated matches in parallel without a gui");
+    parser.addHelpOption();
+    parser.addPositionalArgument("strategy_file", "Strategy init script");
+    parser.addPositionalArgument("entrypoint", "Entrypoint");
+
+    QCommandLineOption strategyColorConfig({"c", "strategy-color"}, "Color(s) of the strategy to run, either yellow, blue or both, defaults to yellow", "color", "yellow");
+    QCommandLineOption simulatorConfig({"s", "simulator-config"}, "Which simulator config to use (field size etc.), loaded from the config directory", "file", "2020");
+    QCommandLineOption realismConfig("realism", "Simulator realism configuration (short file name without the .txt)", "realism");
+    QCommandLineOption numberOfRobots({"n", "num-robots"}, "Number of robots to load per team. Defaults to zero", "num-robots", "0");
+    QCommandLineOption robotGenerationFile("robot-generation", "Robot generation to create the robots of", "generation");
+    QCommandLineOption simulationTime({"t", "simulation-time"}, "Number of seconds to simulate per match, defaults to 60", "seconds", "60");
+    QCommandLineOption matchCount("matches", "Number of matches to run, defaults to 1", "count", "1");
+    QCommandLineOption seedOption("seed", "Seed of the first match, the following matches use consecutive seeds", "seed", "1");
+    QCommandLineOption threadCount({"j", "threads"}, "Number of matches to run in parallel, defaults to the number of cores", "threads");
+    QCommandLineOption forceStart({"f", "force-start"}, "Force start the game immediately (Kickoff will be used otherwise)");
+    QCommandLineOption outputFile({"o", "output"}, "Write the match results as json to the given file", "file");
+    parser.addOption(strategyColorConfig);
+    parser.addOption(simulatorConfig);
+    parser.addOption(realismConfig);
+    parser.addOption(numberOfRobots);
+    parser.addOption(robotGenerationFile);
+    parser.addOption(simulationTime);
+    parser.addOption(matchCount);
+    parser.addOption(seedOption);
+    parser.addOption(threadCount);
+    parser.addOption(forceStart);
+    parser.addOption(outputFile);
+
+    // parse command line, handles --version
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 2) {
+        parser.showHelp(1);
+    }
+
+    const QString strategyColor = parser.value(strategyColorConfig);
+    if (strategyColor != "yellow" && strategyColor != "blue" && strategyColor != "both") {
+        std::cerr <<"Invalid strategy color configuration "<<strategyColor.toStdString()<<std::endl;
+        return 1;
+    }
+
+    MatchSetup setup;
+    setup.initScript = parser.positionalArguments().at(0);
+    setup.entryPoint = parser.positionalArguments().at(1);
+    setup.runBlue = strategyColor == "blue" || strategyColor == "both";
+    setup.runYellow = strategyColor == "yellow" || strategyColor == "both";
+    setup.forceStart = parser.isSet(forceStart);
+    setup.duration = qint64(parser.value(simulationTime).toDouble() * 1E9);
+
+    if (!loadConfiguration("simulator/" + parser.value(simulatorConfig), &setup.simulatorSetup, false)) {
+        return 1;
+    }
+    if (parser.isSet(realismConfig)
+            && !loadConfiguration("simulator-realism/" + parser.value(realismConfig), &setup.realism, true)) {
+        return 1;
+    }
+
+    const int numRobots = parser.value(numberOfRobots).toInt();
+    if (parser.isSet(robotGenerationFile)) {
+        robot::Generation generation;
+        if (!loadConfiguration("robots/" + parser.value(robotGenerationFile), &generation, true)) {
+            return 1;
+        }
+        setup.teamBlue = createTeam(generation, numRobots, true);
+        setup.teamYellow = createTeam(generation, numRobots, false);
+    } else if (numRobots > 0) {
+        std::cerr <<"Option robot-generation must be specified with a non-zero robot count"<<std::endl;
+        return 1;
+    }
+
+    const int matches = parser.value(matchCount).toInt();
+    if (matches <= 0 || setup.duration <= 0) {
+        std::cerr <<"The number of matches and the simulation time must be positive!"<<std::endl;
+        return 1;
+    }
+    const uint32_t firstSeed = parser.value(seedOption).toUInt();
+
+    CompilerRegistry registry;
+    compileStrategy(&registry, setup.initScript);
+
+    // every thread runs its own event loop for the timers and queued connections of the strategies
+    const int threads = std::max(1, std::min(matches, parser.isSet(threadCount) ? parser.value(threadCount).toInt() : QThread::idealThreadCount()));
+    std::vector<MatchResult> results(matches);
+    std::atomic<int> nextMatch(0);
+    std::vector<std::unique_ptr<QThread>> workerThreads;
+    std::vector<std::unique_ptr<MatchWorker>> workers;
+
+    const qint64 wallStart = Timer::systemTime();
+    for (int i = 0;i<threads;i++) {
+        workerThreads.emplace_back(new QThread);
+        workers.emplace_back(new MatchWorker(setup, &registry, firstSeed, nextMatch, results));
+        QThread *thread = workerThreads.back().get();
+        MatchWorker *worker = workers.back().get();
+        worker->moveToThread(thread);
+        QObject::connect(thread, &QThread::started, worker, &MatchWorker::runNext);
+        QObject::connect(worker, &MatchWorker::done, thread, &QThread::quit);
+        thread->start();
+    }
+    for (auto &thread : workerThreads) {
+        thread->wait();
+    }
+    const double wallTime = (Timer::systemTime() - wallStart) * 1E-9;
+
+    QJsonArray jsonResults;
+    double simulatedTime = 0;
+    int failed = 0;
+    for (const MatchResult &result : results) {
+        simulatedTime += result.simulatedTime * 1E-9;
+        if (result.strategyFailed) {
+            failed++;
+        }
+        std::cout <<"Match "<<result.index<<" (seed "<<result.seed<<"): "
+                 <<(result.strategyFailed ? "strategy failed" : "ok")
+                 <<", exit code "<<result.exitCode
+                 <<", "<<result.wallTime * 1E-9<<" s"<<std::endl;
+        jsonResults.append(toJson(result));
+    }
+    std::cout <<std::endl<<"Matches: "<<matches<<", failed: "<<failed<<std::endl;
+    std::cout <<"Threads: "<<threads<<std::endl;
+    std::cout <<"Wall time: "<<wallTime<<" s"<<std::endl;
+    std::cout <<"Simulated time per wall time: "<<simulatedTime / wallTime<<std::endl;
+
+    if (parser.isSet(outputFile)) {
+        QJsonObject summary;
+        summary["threads"] = threads;
+        summary["wall_time"] = wallTime;
+        summary["simulated_time"] = simulatedTime;
+        summary["failed"] = failed;
+        summary["matches"] = jsonResults;
+
+        QFile file(parser.value(outputFile));
+        if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+            std::cerr <<"Could not open output file "<<file.fileName().toStdString()<<std::endl;
+            return 1;
+        }
+        file.write(QJsonDocument(summary).toJson());
+    }
+
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "simulatedmatch.h"
+#include "amun/lockstepamun.h"
+#include "core/timer.h"
+#include "internalreferee/internalreferee.h"
+#include "testtools/testtools.h"
+#include <QTimer>
+#include <algorithm>
+
+SimulatedMatch::SimulatedMatch(const MatchSetup &setup, CompilerRegistry *registry, int index, uint32_t seed) :
+    m_setup(setup),
+    m_registry(registry)
+{
+    m_result.index = index;
+    m_result.seed = seed;
+
+    // run the next step as soon as all pending events are processed
+    m_stepTimer = new QTimer(this);
+    m_stepTimer->setInterval(0);
+    connect(m_stepTimer, &QTimer::timeout, this, &SimulatedMatch::step);
+}
+
+SimulatedMatch::~SimulatedMatch() = default;
+
+void SimulatedMatch::start()
+{
+    m_wallStart = Timer::systemTime();
+
+    m_amun.reset(new LockstepAmun(m_setup.simulatorSetup, m_registry, m_result.seed, m_setup.runBlue, m_setup.runYellow));
+    m_referee.reset(new InternalReferee);
+    connect(m_amun.get(), &LockstepAmun::sendStatus, this, &SimulatedMatch::handleStatus);
+    connect(m_referee.get(), &InternalReferee::sendCommand, m_amun.get(), &LockstepAmun::handleCommand);
+
+    Command command(new amun::Command);
+    command->mutable_simulator()->set_enable(true);
+    command->mutable_simulator()->mutable_realism_config()->CopyFrom(m_setup.realism);
+    command->mutable_transceiver()->set_enable(true);
+    command->mutable_transceiver()->set_charge(true);
+    command->mutable_set_team_blue()->CopyFrom(m_setup.teamBlue);
+    command->mutable_set_team_yellow()->CopyFrom(m_setup.teamYellow);
+    auto addStrategyLoad = [this](amun::CommandStrategy *strategy) {
+        strategy->set_enable_debug(true);
+        auto *load = strategy->mutable_load();
+        load->set_filename(m_setup.initScript.toStdString());
+        load->set_entry_point(m_setup.entryPoint.toStdString());
+    };
+    if (m_setup.runBlue) {
+        addStrategyLoad(command->mutable_strategy_blue());
+    }
+    if (m_setup.runYellow) {
+        addStrategyLoad(command->mutable_strategy_yellow());
+    }
+    m_amun->handleCommand(command);
+
+    m_referee->changeStage(SSL_Referee::NORMAL_FIRST_HALF);
+    if (m_setup.forceStart) {
+        m_referee->changeCommand(SSL_Referee::FORCE_START);
+    } else if (m_setup.runBlue) {
+        m_referee->changeCommand(SSL_Referee::PREPARE_KICKOFF_BLUE);
+    } else {
+        m_referee->changeCommand(SSL_Referee::PREPARE_KICKOFF_YELLOW);
+    }
+
+    m_stepTimer->start();
+}
+
+void SimulatedMatch::step()
+{
+    const qint64 endTime = LockstepAmun::START_TIME + m_setup.duration;
+    if (m_amun->currentTime() < endTime) {
+        m_amun->step();
+        return;
+    }
+
+    m_stepTimer->stop();
+    m_result.simulatedTime = m_amun->currentTime() - LockstepAmun::START_TIME;
+    m_result.wallTime = Timer::systemTime() - m_wallStart;
+    emit finished();
+}
+
+void SimulatedMatch::handleStatus(const Status &status)
+{
+    if (status->has_status_strategy()
+            && status->status_strategy().status().state() == amun::StatusStrategy::FAILED) {
+        m_result.strategyFailed = true;
+    }
+    for (const amun::DebugValues &debug : status->debug()) {
+        for (const amun::StatusLog &entry : debug.log()) {
+            const QString text = TestTools::stripHTML(QString::fromStdString(entry.text()));
+            const std::pair<int, bool> exitCode = TestTools::toExitCode(text);
+            if (exitCode.second) {
+                m_result.exitCode = exitCode.first;
+            }
+        }
+    }
+    if (status->has_timing()) {
+        const amun::Timing &timing = status->timing();
+        auto addTime = [this](float time) {
+            m_result.strategyRuns++;
+            m_result.strategyTimeTotal += time;
+            m_result.strategyTimeMax = std::max(m_result.strategyTimeMax, double(time));
+        };
+        if (timing.has_blue_total()) {
+            addTime(timing.blue_total());
+        }
+        if (timing.has_yellow_total()) {
+            addTime(timing.yellow_total());
+        }
+    }
+}
+
+MatchWorker::MatchWorker(const MatchSetup &setup, CompilerRegistry *registry, uint32_t firstSeed,
+                         std::atomic<int> &nextMatch, std::vector<MatchResult> &results) :
+    m_setup(setup),
+    m_registry(registry),
+    m_firstSeed(firstSeed),
+    m_nextMatch(nextMatch),
+    m_results(results)
+{ }
+
+MatchWorker::~MatchWorker() = default;
+
+void MatchWorker::runNext()
+{
+    // the previous match is destroyed in the thread it was used in
+    m_match.reset();
+
+    const int index = m_nextMatch++;
+    if (index >= int(m_results.size())) {
+        emit done();
+        return;
+    }
+    m_match.reset(new SimulatedMatch(m_setup, m_registry, index, m_firstSeed + uint32_t(index)));
+    connect(m_match.get(), &SimulatedMatch::finished, this, &MatchWorker::matchFinished);
+    m_match->start();
+}
+
+void MatchWorker::matchFinished()
+{
+    m_results[m_match->result().index] = m_match->result();
+    // do not delete the match while it is still emitting its finished signal
+    QMetaObject::invokeMethod(this, "runNext", Qt::QueuedConnection);
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef SIMULATEDMATCH_H
+#define SIMULATEDMATCH_H
+
+#include "protobuf/command.h"
+#include "protobuf/status.h"
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class CompilerRegistry;
+class InternalReferee;
+class LockstepAmun;
+class QTimer;
+
+/*! \brief Configuration shared by all matches of a farm run, it is never modified while the matches run */
+struct MatchSetup
+{
+    amun::SimulatorSetup simulatorSetup;
+    RealismConfigErForce realism;
+    robot::Team teamBlue;
+    robot::Team teamYellow;
+    QString initScript;
+    QString entryPoint;
+    bool runBlue = false;
+    bool runYellow = false;
+    bool forceStart = false;
+    qint64 duration = 0;
+};
+
+struct MatchResult
+{
+    int index = 0;
+    uint32_t seed = 0;
+    bool strategyFailed = false;
+    // exit code requested by the strategy using os.exit, -1 if none
+    int exitCode = -1;
+    qint64 simulatedTime = 0;
+    qint64 wallTime = 0;
+    int strategyRuns = 0;
+    double strategyTimeTotal = 0;
+    double strategyTimeMax = 0;
+};
+
+/*!
+ * \brief A headless match of simulator, tracking, controller and strategies
+ *
+ * All objects of a match are created in and only used by the thread that runs the match.
+ * The match is driven by LockstepAmun, which runs the processor and the strategies
+ * every 10 ms of simulated time. Each step is triggered from the event loop of the
+ * thread, such that the timers and queued connections of the strategies still work.
+ */
+class SimulatedMatch : public QObject
+{
+    Q_OBJECT
+public:
+    SimulatedMatch(const MatchSetup &setup, CompilerRegistry *registry, int index, uint32_t seed);
+    ~SimulatedMatch() override;
+    SimulatedMatch(const SimulatedMatch&) = delete;
+    SimulatedMatch& operator=(const SimulatedMatch&) = delete;
+
+    const MatchResult &result() const { return m_result; }
+
+signals:
+    void finished();
+
+public slots:
+    void start();
+
+private slots:
+    void step();
+
+private:
+    void handleStatus(const Status &status);
+
+    const MatchSetup &m_setup;
+    CompilerRegistry *m_registry;
+    MatchResult m_result;
+    std::unique_ptr<LockstepAmun> m_amun;
+    std::unique_ptr<InternalReferee> m_referee;
+    QTimer *m_stepTimer;
+    qint64 m_wallStart = 0;
+};
+
+/*!
+ * \brief Runs matches one after another in the thread it lives in
+ *
+ * The workers of all threads take the next match from a shared counter,
+ * the results are written to the slot of the match index.
+ */
+class MatchWorker : public QObject
+{
+    Q_OBJECT
+public:
+    MatchWorker(const MatchSetup &setup, CompilerRegistry *registry, uint32_t firstSeed,
+                std::atomic<int> &nextMatch, std::vector<MatchResult> &results);
+    ~MatchWorker() override;
+
+signals:
+    void done();
+
+public slots:
+    void runNext();
+
+private slots:
+    void matchFinished();
+
+private:
+    const MatchSetup &m_setup;
+    CompilerRegistry *m_registry;
+    const uint32_t m_firstSeed;
+    std::atomic<int> &m_nextMatch;
+    std::vector<MatchResult> &m_results;
+    std::unique_ptr<SimulatedMatch> m_match;
+};
+
+#endif // SIMULATEDMATCH_H
@@ -0,0 +1,270 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "batchedudpsocket.h"
+#include <google/protobuf/message.h>
+#include <QSocketNotifier>
+#include <QUdpSocket>
+#include <QtGlobal>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+struct BatchedUdpSocket::Batch
+{
+    // allocated without initialization, thus only the pages which are actually used get mapped
+    std::unique_ptr<char[]> receiveBuffers{new char[BATCH_SIZE * MAX_DATAGRAM_SIZE]};
+    std::unique_ptr<char[]> sendBuffers{new char[BATCH_SIZE * MAX_DATAGRAM_SIZE]};
+    int sendSizes[BATCH_SIZE];
+    QHostAddress sendAddresses[BATCH_SIZE];
+    quint16 sendPorts[BATCH_SIZE];
+#ifdef Q_OS_LINUX
+    mmsghdr receiveHeaders[BATCH_SIZE];
+    iovec receiveVectors[BATCH_SIZE];
+    sockaddr_in receiveNames[BATCH_SIZE];
+    mmsghdr sendHeaders[BATCH_SIZE];
+    iovec sendVectors[BATCH_SIZE];
+    sockaddr_in sendNames[BATCH_SIZE];
+#endif
+};
+
+BatchedUdpSocket::BatchedUdpSocket(QObject *parent) :
+    QObject(parent),
+    m_batch(new Batch)
+{
+    m_received.reserve(BATCH_SIZE);
+#ifdef Q_OS_LINUX
+    m_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (m_fd < 0) {
+        // bind fails and nothing is sent without a socket
+        qWarning("Could not create udp socket: %s", std::strerror(errno));
+    }
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        m_batch->receiveVectors[i].iov_base = m_batch->receiveBuffers.get() + i * MAX_DATAGRAM_SIZE;
+        m_batch->receiveVectors[i].iov_len = MAX_DATAGRAM_SIZE;
+        msghdr &header = m_batch->receiveHeaders[i].msg_hdr;
+        header = msghdr();
+        header.msg_iov = &m_batch->receiveVectors[i];
+        header.msg_iovlen = 1;
+
+        m_batch->sendVectors[i].iov_base = m_batch->sendBuffers.get() + i * MAX_DATAGRAM_SIZE;
+        msghdr &sendHeader = m_batch->sendHeaders[i].msg_hdr;
+        sendHeader = msghdr();
+        sendHeader.msg_iov = &m_batch->sendVectors[i];
+        sendHeader.msg_iovlen = 1;
+        sendHeader.msg_name = &m_batch->sendNames[i];
+        sendHeader.msg_namelen = sizeof(sockaddr_in);
+    }
+#else
+    m_socket = new QUdpSocket(this);
+    connect(m_socket, &QUdpSocket::readyRead, this, &BatchedUdpSocket::readyRead);
+#endif
+}
+
+BatchedUdpSocket::~BatchedUdpSocket()
+{
+    // the notifier must not outlive the file descriptor
+    delete m_notifier;
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+}
+
+bool BatchedUdpSocket::isBatched()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool BatchedUdpSocket::bind(quint16 port)
+{
+#ifdef Q_OS_LINUX
+    if (m_fd < 0) {
+        return false;
+    }
+    // same behaviour as the default bind mode of QUdpSocket
+    int reuse = 1;
+    ::setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = sockaddr_in();
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        return false;
+    }
+    delete m_notifier;
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), SIGNAL(readyRead()));
+    return true;
+#else
+    return m_socket->bind(QHostAddress::Any, port);
+#endif
+}
+
+quint16 BatchedUdpSocket::localPort() const
+{
+#ifdef Q_OS_LINUX
+    sockaddr_in address = sockaddr_in();
+    socklen_t length = sizeof(address);
+    if (::getsockname(m_fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+#else
+    return m_socket->localPort();
+#endif
+}
+
+void BatchedUdpSocket::setMulticastTtl(int ttl)
+{
+#ifdef Q_OS_LINUX
+    ::setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+#else
+    m_socket->setSocketOption(QAbstractSocket::MulticastTtlOption, ttl);
+#endif
+}
+
+const std::vector<BatchedUdpSocket::Datagram> &BatchedUdpSocket::receive()
+{
+    m_received.clear();
+#ifdef Q_OS_LINUX
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        msghdr &header = m_batch->receiveHeaders[i].msg_hdr;
+        header.msg_name = &m_batch->receiveNames[i];
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_flags = 0;
+    }
+    const int count = ::recvmmsg(m_fd, m_batch->receiveHeaders, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    for (int i = 0; i < count; i++) {
+        const mmsghdr &header = m_batch->receiveHeaders[i];
+        // a truncated datagram could not be parsed anyway
+        if (header.msg_hdr.msg_flags & MSG_TRUNC) {
+            continue;
+        }
+        const sockaddr_in &name = m_batch->receiveNames[i];
+        m_received.push_back({static_cast<const char*>(m_batch->receiveVectors[i].iov_base), int(header.msg_len),
+                              QHostAddress(ntohl(name.sin_addr.s_addr)), ntohs(name.sin_port)});
+    }
+#else
+    while (int(m_received.size()) < BATCH_SIZE && m_socket->hasPendingDatagrams()) {
+        char *buffer = m_batch->receiveBuffers.get() + m_received.size() * MAX_DATAGRAM_SIZE;
+        Datagram datagram{buffer, 0, QHostAddress(), 0};
+        const qint64 size = m_socket->readDatagram(buffer, MAX_DATAGRAM_SIZE, &datagram.senderAddress, &datagram.senderPort);
+        if (size < 0) {
+            break;
+        }
+        datagram.size = int(size);
+        m_received.push_back(datagram);
+    }
+#endif
+    m_receivedDatagrams += m_received.size();
+    return m_received;
+}
+
+char *BatchedUdpSocket::reserveSendBuffer(const QHostAddress &address, quint16 port, int size)
+{
+    if (size > MAX_DATAGRAM_SIZE) {
+        return nullptr;
+    }
+    if (m_queued == BATCH_SIZE) {
+        flush();
+    }
+    const int index = m_queued++;
+    m_batch->sendSizes[index] = size;
+    m_batch->sendAddresses[index] = address;
+    m_batch->sendPorts[index] = port;
+#ifdef Q_OS_LINUX
+    sockaddr_in &name = m_batch->sendNames[index];
+    name = sockaddr_in();
+    name.sin_family = AF_INET;
+    name.sin_addr.s_addr = htonl(address.toIPv4Address());
+    name.sin_port = htons(port);
+    m_batch->sendVectors[index].iov_len = size;
+#endif
+    return m_batch->sendBuffers.get() + index * MAX_DATAGRAM_SIZE;
+}
+
+bool BatchedUdpSocket::queue(const google::protobuf::Message &message, const QHostAddress &address, quint16 port)
+{
+    const int size = message.ByteSize();
+    char *buffer = reserveSendBuffer(address, port, size);
+    if (!buffer) {
+        return false;
+    }
+    message.SerializeWithCachedSizesToArray(reinterpret_cast<google::protobuf::uint8*>(buffer));
+    return true;
+}
+
+bool BatchedUdpSocket::queue(const QByteArray &data, const QHostAddress &address, quint16 port)
+{
+    char *buffer = reserveSendBuffer(address, port, data.size());
+    if (!buffer) {
+        return false;
+    }
+    std::copy(data.begin(), data.end(), buffer);
+    return true;
+}
+
+bool BatchedUdpSocket::flush()
+{
+    int sent = 0;
+#ifdef Q_OS_LINUX
+    int next = m_fd >= 0 ? 0 : m_queued;
+    while (next < m_queued) {
+        const int count = ::sendmmsg(m_fd, m_batch->sendHeaders + next, m_queued - next, 0);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // an error is only reported if the first datagram could not be sent,
+            // e.g. for an unreachable receiver. Skip it and send the remaining ones
+            next++;
+            continue;
+        }
+        next += count;
+        sent += count;
+    }
+#else
+    for (int i = 0; i < m_queued; i++) {
+        const int size = m_batch->sendSizes[i];
+        if (m_socket->writeDatagram(m_batch->sendBuffers.get() + i * MAX_DATAGRAM_SIZE, size,
+                                    m_batch->sendAddresses[i], m_batch->sendPorts[i]) == size) {
+            sent++;
+        }
+    }
+#endif
+    const bool success = sent == m_queued;
+    m_sentDatagrams += sent;
+    m_queued = 0;
+    return success;
+}
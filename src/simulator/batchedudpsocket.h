@@ -0,0 +1,100 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef BATCHEDUDPSOCKET_H
+#define BATCHEDUDPSOCKET_H
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QObject>
+#include <memory>
+#include <vector>
+
+class QSocketNotifier;
+class QUdpSocket;
+
+namespace google {
+    namespace protobuf {
+        class Message;
+    }
+}
+
+// UDP socket which receives and sends datagrams in batches.
+// On Linux, recvmmsg and sendmmsg are used to handle a whole batch with a single system call,
+// on other platforms the datagrams are handled one by one with a QUdpSocket.
+// All buffers are allocated once on construction.
+class BatchedUdpSocket : public QObject
+{
+    Q_OBJECT
+public:
+    struct Datagram {
+        const char *data;
+        int size;
+        QHostAddress senderAddress;
+        quint16 senderPort;
+    };
+
+    static const int BATCH_SIZE = 32;
+    static const int MAX_DATAGRAM_SIZE = 65507;
+
+    explicit BatchedUdpSocket(QObject *parent = nullptr);
+    ~BatchedUdpSocket() override;
+    BatchedUdpSocket(const BatchedUdpSocket&) = delete;
+    BatchedUdpSocket& operator=(const BatchedUdpSocket&) = delete;
+
+    static bool isBatched();
+
+    bool bind(quint16 port);
+    quint16 localPort() const;
+    void setMulticastTtl(int ttl);
+
+    // receives up to BATCH_SIZE pending datagrams, returns an empty list if nothing is pending.
+    // The data is only valid until the next call
+    const std::vector<Datagram> &receive();
+
+    // serializes the message into the next free send buffer, a full batch is sent immediately
+    bool queue(const google::protobuf::Message &message, const QHostAddress &address, quint16 port);
+    bool queue(const QByteArray &data, const QHostAddress &address, quint16 port);
+    // sends all queued datagrams, returns false if any of them could not be sent
+    bool flush();
+
+    quint64 receivedDatagrams() const { return m_receivedDatagrams; }
+    quint64 sentDatagrams() const { return m_sentDatagrams; }
+
+signals:
+    void readyRead();
+
+private:
+    char *reserveSendBuffer(const QHostAddress &address, quint16 port, int size);
+
+private:
+    struct Batch;
+    std::unique_ptr<Batch> m_batch;
+    std::vector<Datagram> m_received;
+    int m_queued = 0;
+    quint64 m_receivedDatagrams = 0;
+    quint64 m_sentDatagrams = 0;
+
+    int m_fd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    QUdpSocket *m_socket = nullptr;
+};
+
+#endif // BATCHEDUDPSOCKET_H
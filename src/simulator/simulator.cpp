@@ -19,9 +19,7 @@
  ***************************************************************************/
 #include <clocale>
 #include <QCoreApplication>
-#include <QUdpSocket>
 #include <QThread>
-#include <QNetworkDatagram>
 #include <QCommandLineParser>
 #include <QTime>
 #include <cmath>
@@ -44,7 +42,8 @@
 #include "core/coordinates.h"
 #include "core/sslprotocols.h"
 
-#include "ssl_robocup_server.h"
+#include "batchedudpsocket.h"
+#include "udpbenchmark.h"
 
 /**
  * Stand alone Erforce simulator
@@ -52,7 +51,6 @@
  * Known issues:
  *  - [ ]: Currently, it is not possible to supply partial positions for teleportBall or teleportRobot
  *  - [ ]: Robots go into standby after 0.1 seconds without command (Safty)
- *  - [ ]: It is not possible to change specs or geometry without resetting the world
  *  - [ ]: It is not possible to setUp a team with no robots (You can still teleport them away)
  *  - [ ]: It is not possible to supply only partial specs. It is planned to fuse them with the last specs for this team if not supplied, but NYI.
  *  - [ ]: Dribbler will reset if a new command doesn't contain a new dribbling speed (contrary to the definition that states all not set values should stay as previously assumed)
@@ -81,15 +79,17 @@ static void CHECK_PRINTF log(FILE* stream, const char* fmt, ...) {
 class SSLVisionServer: public QObject {
     Q_OBJECT
 public:
-    SSLVisionServer(int port, const string &net_address);
+    SSLVisionServer(int port, const std::string &net_address);
     void setPort(int port);
 
 
 public slots:
-    void sendVisionData(const QByteArray& data, qint64 time, QString sender);
+    void sendVisionFrame(const SimulatorVisionFramePtr &frame, qint64 time);
 
 private:
-    RoboCupSSLServer m_server;
+    BatchedUdpSocket m_server;
+    QHostAddress m_address;
+    quint16 m_port;
 };
 
 class SimulatorCommandAdaptor: public QObject {
@@ -99,6 +99,9 @@ public:
 private slots:
     void handleDatagrams();
 
+private:
+    void handleDatagram(const BatchedUdpSocket::Datagram& datagram);
+
 public slots:
     void handleSimulatorError(const QList<SSLSimError> &error, camun::simulator::ErrorSource source);
 
@@ -106,7 +109,7 @@ signals:
     void sendCommand(const Command& c);
 
 private:
-    QUdpSocket m_server;
+    BatchedUdpSocket m_server;
     QHostAddress m_senderAddress;
     int m_senderPort;
     Timer* m_timer; // unowned
@@ -120,8 +123,10 @@ SimulatorCommandAdaptor::SimulatorCommandAdaptor(Timer* timer, SSLVisionServer*
     m_timer(timer),
     m_visionServer(vision)
 {
-    m_server.bind(QHostAddress::Any, SSL_SIMULATION_CONTROL_PORT);
-    connect(&m_server, &QUdpSocket::readyRead, this, &SimulatorCommandAdaptor::handleDatagrams);
+    if (!m_server.bind(SSL_SIMULATION_CONTROL_PORT)) {
+        log(stderr, "Could not bind the simulation control port %d\n", SSL_SIMULATION_CONTROL_PORT);
+    }
+    connect(&m_server, &BatchedUdpSocket::readyRead, this, &SimulatorCommandAdaptor::handleDatagrams);
 }
 
 class RobotCommandAdaptor: public QObject{
@@ -130,7 +135,8 @@ public:
     RobotCommandAdaptor(bool blue, Timer* timer);
 
 private:
-    void sendRobotRespose(const sslsim::RobotControlResponse& rcr);
+    void queueRobotResponse(const sslsim::RobotControlResponse& rcr);
+    void handleDatagram(const BatchedUdpSocket::Datagram& datagram);
 
 public slots:
     void handleRobotResponse(const QList<robot::RadioResponse>& responses);
@@ -145,7 +151,7 @@ signals:
 
 private:
     bool m_is_blue;
-    QUdpSocket m_server;
+    BatchedUdpSocket m_server;
     QHostAddress m_senderAddress;
     int m_senderPort;
     Timer* m_timer; // unowned
@@ -157,8 +163,11 @@ RobotCommandAdaptor::RobotCommandAdaptor(bool blue, Timer* timer): m_is_blue(blu
     m_senderPort(-1),
     m_timer(timer)
 {
-    m_server.bind(QHostAddress::Any, (blue)? SSL_SIMULATION_CONTROL_BLUE_PORT : SSL_SIMULATION_CONTROL_YELLOW_PORT);
-    connect(&m_server, &QUdpSocket::readyRead, this, &RobotCommandAdaptor::handleDatagrams);
+    const int port = (blue)? SSL_SIMULATION_CONTROL_BLUE_PORT : SSL_SIMULATION_CONTROL_YELLOW_PORT;
+    if (!m_server.bind(port)) {
+        log(stderr, "Could not bind the %s robot control port %d\n", blue ? "blue" : "yellow", port);
+    }
+    connect(&m_server, &BatchedUdpSocket::readyRead, this, &RobotCommandAdaptor::handleDatagrams);
 }
 
 enum class SimError {
@@ -225,14 +234,15 @@ static void setError(sslsim::SimulatorError* error, SimError code, SimErrorSourc
     log(stderr, "[%-10s - %-15s] %s\n", sourceStr, codeStr, message.c_str());
 }
 
-static void sendUDP(const google::protobuf::Message& out, QUdpSocket& server, const QHostAddress& senderAddress, int senderPort) {
-    QByteArray data;
-    data.resize(out.ByteSize());
-    bool sendingSuccessful = false;
-    if (out.SerializeToArray(data.data(), data.size())) {
-        sendingSuccessful = server.writeDatagram(data, senderAddress, senderPort) == data.size();
+// the reply is only sent on the next flush of the socket, which happens after each batch of received datagrams
+static void queueUDP(const google::protobuf::Message& out, BatchedUdpSocket& server, const QHostAddress& senderAddress, int senderPort) {
+    if (!server.queue(out, senderAddress, senderPort)) {
+        log(stderr, "Sending reply failed:\n");
     }
-    if (!sendingSuccessful) {
+}
+
+static void flushUDP(BatchedUdpSocket& server) {
+    if (!server.flush()) {
         log(stderr, "Sending reply failed:\n");
     }
 }
@@ -367,104 +377,113 @@ message RobotLimits {
 
 
 void SimulatorCommandAdaptor::handleDatagrams() {
-    while(m_server.hasPendingDatagrams()) {
-        qint64 start = m_timer->currentTime();
-        auto datagram = m_server.receiveDatagram();
-        sslsim::SimulatorResponse sir;
-        bool sendSir = false;
-        m_senderAddress = datagram.senderAddress();
-        m_senderPort = datagram.senderPort();
-        auto data = datagram.data();
-
-        RUN_WHEN_OUT_OF_SCOPE({
-                if (sendSir) {
-                    sendUDP(sir, m_server, m_senderAddress, m_senderPort);
-                }
-            });
-        sslsim::SimulatorCommand simcom;
-        if (!simcom.ParseFromArray(data.data(), data.size())) {
-            sendSir = true;
-            setError(sir.add_errors(), SimError::UNREADABLE, SimErrorSource::CONTROLLER);
-            continue;
+    for (;;) {
+        const auto& datagrams = m_server.receive();
+        if (datagrams.empty()) {
+            break;
         }
-        if (simcom.has_control()) {
-            Command c{new amun::Command};
-            auto* sslControl = c->mutable_simulator()->mutable_ssl_control();
-            sslControl->CopyFrom(simcom.control());
-            if (sslControl->has_teleport_ball()) {
-                auto* teleportBall = sslControl->mutable_teleport_ball();
-                SCALE_UP(*teleportBall, x);
-                SCALE_UP(*teleportBall, y);
-                SCALE_UP(*teleportBall, z);
-                SCALE_UP(*teleportBall, vx);
-                SCALE_UP(*teleportBall, vy);
-                SCALE_UP(*teleportBall, vz);
-            }
-            for(sslsim::TeleportRobot& robot : *sslControl->mutable_teleport_robot()) {
-                SCALE_UP(robot, x);
-                SCALE_UP(robot, y);
-                SCALE_UP(robot, v_x);
-                SCALE_UP(robot, v_y);
+        for (const auto& datagram : datagrams) {
+            handleDatagram(datagram);
+        }
+        flushUDP(m_server);
+    }
+}
+
+void SimulatorCommandAdaptor::handleDatagram(const BatchedUdpSocket::Datagram& datagram) {
+    qint64 start = m_timer->currentTime();
+    sslsim::SimulatorResponse sir;
+    bool sendSir = false;
+    m_senderAddress = datagram.senderAddress;
+    m_senderPort = datagram.senderPort;
+
+    RUN_WHEN_OUT_OF_SCOPE({
+            if (sendSir) {
+                queueUDP(sir, m_server, m_senderAddress, m_senderPort);
             }
+        });
+    sslsim::SimulatorCommand simcom;
+    if (!simcom.ParseFromArray(datagram.data, datagram.size)) {
+        sendSir = true;
+        setError(sir.add_errors(), SimError::UNREADABLE, SimErrorSource::CONTROLLER);
+        return;
+    }
+    if (simcom.has_control()) {
+        Command c{new amun::Command};
+        auto* sslControl = c->mutable_simulator()->mutable_ssl_control();
+        sslControl->CopyFrom(simcom.control());
+        if (sslControl->has_teleport_ball()) {
+            auto* teleportBall = sslControl->mutable_teleport_ball();
+            SCALE_UP(*teleportBall, x);
+            SCALE_UP(*teleportBall, y);
+            SCALE_UP(*teleportBall, z);
+            SCALE_UP(*teleportBall, vx);
+            SCALE_UP(*teleportBall, vy);
+            SCALE_UP(*teleportBall, vz);
+        }
+        for(sslsim::TeleportRobot& robot : *sslControl->mutable_teleport_robot()) {
+            SCALE_UP(robot, x);
+            SCALE_UP(robot, y);
+            SCALE_UP(robot, v_x);
+            SCALE_UP(robot, v_y);
+        }
+        emit sendCommand(c);
+    }
+    if (simcom.has_config()) {
+        const auto& config{simcom.config()};
+
+        if (config.has_geometry()) {
+            Command c{new amun::Command};
+            auto* setup = c->mutable_simulator()->mutable_simulator_setup();
+            convertFromSSlGeometry(config.geometry().field(), *(setup->mutable_geometry()));
+            setup->mutable_camera_setup()->CopyFrom(config.geometry().calib());
             emit sendCommand(c);
         }
-        if (simcom.has_config()) {
-            const auto& config{simcom.config()};
-
-            if (config.has_geometry()) {
-                Command c{new amun::Command};
-                auto* setup = c->mutable_simulator()->mutable_simulator_setup();
-                convertFromSSlGeometry(config.geometry().field(), *(setup->mutable_geometry()));
-                setup->mutable_camera_setup()->CopyFrom(config.geometry().calib());
-                emit sendCommand(c);
-            }
 
-            if (config.robot_specs_size() > 0) {
-                Command c{new amun::Command};
-                robot::Team* blueTeam = nullptr;
-                robot::Team* yellowTeam = nullptr;
-                auto newSz = config.robot_specs_size();
-                for (const auto& spec : config.robot_specs()) {
-                    bool success = convertSpecsToErForce([&blueTeam, &yellowTeam, &c](bool isBlue){
-                            if (isBlue) {
-                                if (blueTeam == nullptr) {
-                                    blueTeam = c->mutable_set_team_blue();
-                                }
-                                return blueTeam->add_robot();
-                            }
-                            if (yellowTeam == nullptr) {
-                                yellowTeam = c->mutable_set_team_yellow();
-                            }
-                            return yellowTeam->add_robot();
+        if (config.robot_specs_size() > 0) {
+            Command c{new amun::Command};
+            robot::Team* blueTeam = nullptr;
+            robot::Team* yellowTeam = nullptr;
+            auto newSz = config.robot_specs_size();
+            for (const auto& spec : config.robot_specs()) {
+                bool success = convertSpecsToErForce([&blueTeam, &yellowTeam, &c](bool isBlue){
+                        if (isBlue) {
+                            if (blueTeam == nullptr) {
+                                blueTeam = c->mutable_set_team_blue();
                             }
-                            , spec);
-                    if (!success) {
-                        sendSir = true;
-                        setError(sir.add_errors(), SimError::MISSING_SPEC, SimErrorSource::CONTROLLER, spec.DebugString());
-                        newSz--;
-                    }
+                            return blueTeam->add_robot();
+                        }
+                        if (yellowTeam == nullptr) {
+                            yellowTeam = c->mutable_set_team_yellow();
+                        }
+                        return yellowTeam->add_robot();
+                        }
+                        , spec);
+                if (!success) {
+                    sendSir = true;
+                    setError(sir.add_errors(), SimError::MISSING_SPEC, SimErrorSource::CONTROLLER, spec.DebugString());
+                    newSz--;
                 }
-                log(stdout, "Updated to %d robots\n", newSz);
-                emit sendCommand(c);
             }
-            if (config.has_realism_config()) {
-                for(const auto& c : config.realism_config().custom()) {
-                RealismConfigErForce rcef;
-                    if (c.UnpackTo(&rcef)) {
-                        Command c{new amun::Command};
-                        c->mutable_simulator()->mutable_realism_config()->CopyFrom(rcef);
-                        emit sendCommand(c);
-                    }
+            log(stdout, "Updated to %d robots\n", newSz);
+            emit sendCommand(c);
+        }
+        if (config.has_realism_config()) {
+            for(const auto& c : config.realism_config().custom()) {
+            RealismConfigErForce rcef;
+                if (c.UnpackTo(&rcef)) {
+                    Command c{new amun::Command};
+                    c->mutable_simulator()->mutable_realism_config()->CopyFrom(rcef);
+                    emit sendCommand(c);
                 }
             }
-            if (config.has_vision_port()) {
-                m_visionServer->setPort(config.vision_port());
-            }
         }
-
-        qint64 delta = m_timer->currentTime() - start;
-        warnLatency(delta);
+        if (config.has_vision_port()) {
+            m_visionServer->setPort(config.vision_port());
+        }
     }
+
+    qint64 delta = m_timer->currentTime() - start;
+    warnLatency(delta);
 }
 
 void RobotCommandAdaptor::handleSimulatorError(const QList<SSLSimError> &error,camun::simulator::ErrorSource source)
@@ -481,7 +500,8 @@ void RobotCommandAdaptor::handleSimulatorError(const QList<SSLSimError> &error,c
         *sendError = *err;
     }
 
-    sendRobotRespose(rcr);
+    queueRobotResponse(rcr);
+    flushUDP(m_server);
 }
 
 void SimulatorCommandAdaptor::handleSimulatorError(const QList<SSLSimError> &error, camun::simulator::ErrorSource source) {
@@ -491,54 +511,65 @@ void SimulatorCommandAdaptor::handleSimulatorError(const QList<SSLSimError> &err
     for (const SSLSimError& err : error) {
         sir.add_errors()->CopyFrom(*err);
     }
-    sendUDP(sir, m_server, m_senderAddress, m_senderPort);
+    queueUDP(sir, m_server, m_senderAddress, m_senderPort);
+    flushUDP(m_server);
 }
 
 
 void RobotCommandAdaptor::handleDatagrams()
+{
+    for (;;) {
+        const auto& datagrams = m_server.receive();
+        if (datagrams.empty()) {
+            break;
+        }
+        for (const auto& datagram : datagrams) {
+            handleDatagram(datagram);
+        }
+        flushUDP(m_server);
+    }
+}
+
+void RobotCommandAdaptor::handleDatagram(const BatchedUdpSocket::Datagram& datagram)
 {
     const SimErrorSource ERROR_SOURCE = m_is_blue
         ? SimErrorSource::BLUE_TEAM
         : SimErrorSource::YELLOW_TEAM;
-    while(m_server.hasPendingDatagrams()) {
-        qint64 start =m_timer->currentTime();
-        sslsim::RobotControlResponse rcr;
-        bool sendRcr = false;
-        auto datagram = m_server.receiveDatagram();
-        // TODO: do something with m_senderAddress and datagram.senderAddress
-        m_senderAddress = datagram.senderAddress();
-        m_senderPort = datagram.senderPort();
-        auto data = datagram.data();
-
-        RUN_WHEN_OUT_OF_SCOPE({
-                if (sendRcr) {
-                    sendRobotRespose(rcr);
-                }
-            });
+    qint64 start =m_timer->currentTime();
+    sslsim::RobotControlResponse rcr;
+    bool sendRcr = false;
+    // TODO: do something with m_senderAddress and datagram.senderAddress
+    m_senderAddress = datagram.senderAddress;
+    m_senderPort = datagram.senderPort;
+
+    RUN_WHEN_OUT_OF_SCOPE({
+            if (sendRcr) {
+                queueRobotResponse(rcr);
+            }
+        });
 
-        SSLSimRobotControl control{new sslsim::RobotControl};
-        if (!control->ParseFromArray(data.data(), data.size())) {
-            sendRcr = true;
-            setError(rcr.add_errors(), SimError::UNREADABLE, ERROR_SOURCE);
-            continue;
-        }
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    if (!control->ParseFromArray(datagram.data, datagram.size)) {
+        sendRcr = true;
+        setError(rcr.add_errors(), SimError::UNREADABLE, ERROR_SOURCE);
+        return;
+    }
 
-        for (const auto& command : control->robot_commands()) {
-            if (command.has_move_command()) {
-                const auto& moveCmd = command.move_command();
-                if (moveCmd.has_wheel_velocity() || moveCmd.has_global_velocity()) {
-                    sendRcr = true;
-                    const std::string robotStr = "(Robot :" + std::to_string(command.id()) + ")";
-                    setError(rcr.add_errors(), SimError::UNSUPPORTED_VELOCITY, ERROR_SOURCE, robotStr);
-                }
+    for (const auto& command : control->robot_commands()) {
+        if (command.has_move_command()) {
+            const auto& moveCmd = command.move_command();
+            if (moveCmd.has_wheel_velocity() || moveCmd.has_global_velocity()) {
+                sendRcr = true;
+                const std::string robotStr = "(Robot :" + std::to_string(command.id()) + ")";
+                setError(rcr.add_errors(), SimError::UNSUPPORTED_VELOCITY, ERROR_SOURCE, robotStr);
             }
         }
-        emit sendRadioCommands(control, m_is_blue, m_timer->currentTime()); // This might be a bit late.
-        // TODO: response!
-        qint64 delta = m_timer->currentTime() - start;
-
-        warnLatency(delta);
     }
+    emit sendRadioCommands(control, m_is_blue, m_timer->currentTime()); // This might be a bit late.
+    // TODO: response!
+    qint64 delta = m_timer->currentTime() - start;
+
+    warnLatency(delta);
 }
 
 void RobotCommandAdaptor::handleRobotResponse(const QList<robot::RadioResponse>& res) {
@@ -559,26 +590,39 @@ void RobotCommandAdaptor::handleRobotResponse(const QList<robot::RadioResponse>&
     }
 
     if (send) {
-        sendRobotRespose(out);
+        queueRobotResponse(out);
+        flushUDP(m_server);
     }
 }
 
-void RobotCommandAdaptor::sendRobotRespose(const sslsim::RobotControlResponse& out) {
-    sendUDP(out, m_server, m_senderAddress, m_senderPort);
+void RobotCommandAdaptor::queueRobotResponse(const sslsim::RobotControlResponse& out) {
+    queueUDP(out, m_server, m_senderAddress, m_senderPort);
 }
 
 
-SSLVisionServer::SSLVisionServer(int port, const string &net_address): m_server(this, port, net_address)
+SSLVisionServer::SSLVisionServer(int port, const std::string &net_address):
+    m_server(this),
+    m_address(QString::fromStdString(net_address)),
+    m_port(port)
 {
+    m_server.setMulticastTtl(1);
 }
 
-void SSLVisionServer::sendVisionData(const QByteArray& data, qint64, QString)
+void SSLVisionServer::sendVisionFrame(const SimulatorVisionFramePtr &frame, qint64)
 {
-    m_server.send(data);
+    // all cameras of a frame are sent with a single system call
+    bool success = true;
+    for (const SSL_WrapperPacket &packet : frame->packets) {
+        success &= m_server.queue(packet, m_address, m_port);
+    }
+    success &= m_server.flush();
+    if (!success) {
+        log(stderr, "Sending vision packet failed\n");
+    }
 }
 
 void SSLVisionServer::setPort(int port) {
-    m_server.change_port(port);
+    m_port = port;
 }
 
 using camun::simulator::Simulator;
@@ -591,7 +635,7 @@ public:
 signals:
     void sendSSLSimError(const QList<SSLSimError>& errors, ErrorSource source); // out
     void sendRadioResponses(const QList<robot::RadioResponse> &responses); // out
-    void gotPacket(const QByteArray &data, qint64 time, QString sender); // out
+    void gotVisionFrame(const SimulatorVisionFramePtr &frame, qint64 time); // out
     void gotCommand(const Command &command); // internal
     void handleRadioCommands(const SSLSimRobotControl& control, bool isBlue, qint64 processingStart); // in
 public slots:
@@ -604,36 +648,26 @@ private:
 };
 
 void SimProxy::handleCommand(const Command &command) {
-    bool hasSimSetup = command->has_simulator() && command->simulator().has_simulator_setup();
+    // the simulator applies later setups in place, only the first one creates it
+    if (m_sim != nullptr) {
+        emit gotCommand(command);
+        return;
+    }
 
     if (command->has_set_team_blue()) {
         m_teamCommand->mutable_set_team_blue()->CopyFrom(command->set_team_blue());
-        if (hasSimSetup) {
-            command->clear_set_team_blue();
-        }
     }
     if (command->has_set_team_yellow()) {
         m_teamCommand->mutable_set_team_yellow()->CopyFrom(command->set_team_yellow());
-        if (hasSimSetup) {
-            command->clear_set_team_yellow();
-        }
     }
     if (command->has_simulator() && command->simulator().has_realism_config()) {
         m_teamCommand->mutable_simulator()->mutable_realism_config()->CopyFrom(command->simulator().realism_config());
-        if (hasSimSetup) {
-            command->mutable_simulator()->clear_realism_config();
-        }
     }
-    if (hasSimSetup) {
-        // replace m_sim
-        if (m_sim != nullptr) {
-            // replace old connectios
-            m_sim->blockSignals(true);
-            m_sim->deleteLater();
-        }
+    if (command->has_simulator() && command->simulator().has_simulator_setup()) {
         m_sim = new Simulator(m_timer, command->simulator().simulator_setup());
         connect(this, &SimProxy::gotCommand, m_sim, &Simulator::handleCommand);
-        connect(m_sim, &Simulator::gotPacket, this, &SimProxy::gotPacket);
+        m_sim->setVisionFrameOutput(true);
+        connect(m_sim, &Simulator::gotVisionFrame, this, &SimProxy::gotVisionFrame);
         connect(this, &SimProxy::handleRadioCommands, m_sim, &Simulator::handleRadioCommands);
         connect(m_sim, &Simulator::sendSSLSimError, this, &SimProxy::sendSSLSimError);
         connect(m_sim, &Simulator::sendRadioResponses, this, &SimProxy::sendRadioResponses);
@@ -642,8 +676,8 @@ void SimProxy::handleCommand(const Command &command) {
         auto* trCommand = m_teamCommand->mutable_transceiver();
         trCommand->set_charge(true);
         emit gotCommand(m_teamCommand);
+        emit gotCommand(command);
     }
-    emit gotCommand(command);
 }
 
 #include "simulator.moc"
@@ -663,6 +697,7 @@ int main(int argc, char* argv[])
     qRegisterMetaType<Command>("Command");
     qRegisterMetaType<SSLSimRobotControl>("SSLSimRobotControl");
     qRegisterMetaType<SSLSimError>("SSLSimError");
+    qRegisterMetaType<SimulatorVisionFramePtr>("SimulatorVisionFramePtr");
     qRegisterMetaType<QList<SSLSimError>>("QList<SSLSimError>");
     qRegisterMetaType<camun::simulator::ErrorSource>("ErrorSource");
 
@@ -673,12 +708,18 @@ int main(int argc, char* argv[])
     QCommandLineOption geometryConfig({"g", "geometry"}, "The geometry file to load as default", "file", "2020");
     QCommandLineOption realismConfig("realism", "Simulator realism configuration (short file name without the .txt)", "realism", "Realistic");
     QCommandLineOption localhostConfig("localhost", "Use localhost as the output address for the simulator");
+    QCommandLineOption udpBenchmark("udp-benchmark", "Measure the packet rate of the batched and the plain UDP path on loopback and exit", "datagrams");
     parser.addOption(geometryConfig);
     parser.addOption(realismConfig);
     parser.addOption(localhostConfig);
+    parser.addOption(udpBenchmark);
 
     parser.process(app);
 
+    if (parser.isSet(udpBenchmark)) {
+        return runUdpBenchmark(parser.value(udpBenchmark).toInt()) ? 0 : 1;
+    }
+
     auto* desc = sslsim::RobotSpecs::descriptor();
     int real_fields = desc->field_count();
     auto* desc2 = sslsim::RobotSpecErForce::descriptor();
@@ -708,7 +749,7 @@ int main(int argc, char* argv[])
     yellow.connect(&sim, &SimProxy::sendRadioResponses, &yellow, &RobotCommandAdaptor::handleRobotResponse);
 
 
-    vision.connect(&sim, &SimProxy::gotPacket, &vision, &SSLVisionServer::sendVisionData);
+    vision.connect(&sim, &SimProxy::gotVisionFrame, &vision, &SSLVisionServer::sendVisionFrame);
     commands.connect(&commands, &SimulatorCommandAdaptor::sendCommand, &sim, &SimProxy::handleCommand);
 
 
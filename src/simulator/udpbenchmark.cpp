@@ -0,0 +1,136 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "udpbenchmark.h"
+#include "batchedudpsocket.h"
+#include "core/timer.h"
+#include "protobuf/ssl_simulation_robot_control.pb.h"
+#include <QUdpSocket>
+#include <algorithm>
+#include <cstdio>
+
+// give up if a datagram did not arrive in this time, loopback does not reorder but may drop
+static const qint64 RECEIVE_TIMEOUT = 1000 * 1000 * 1000;
+
+static sslsim::RobotControl benchmarkPacket()
+{
+    // the typical packet of a team controlling all robots
+    sslsim::RobotControl control;
+    for (int i = 0; i < 11; i++) {
+        sslsim::RobotCommand *command = control.add_robot_commands();
+        command->set_id(i);
+        command->set_kick_speed(0);
+        command->set_dribbler_speed(0);
+        auto *local = command->mutable_move_command()->mutable_local_velocity();
+        local->set_forward(1.5f);
+        local->set_left(0.5f);
+        local->set_angular(1.0f);
+    }
+    return control;
+}
+
+static void printResult(const char *name, int sent, int received, qint64 duration)
+{
+    const double seconds = duration * 1E-9;
+    std::printf("%-8s %8d datagrams sent, %8d received in %7.3f s: %10.0f packets/s\n",
+                name, sent, received, seconds, received / seconds);
+}
+
+static bool benchmarkBatched(const QByteArray &packet, int datagrams)
+{
+    BatchedUdpSocket sender;
+    BatchedUdpSocket receiver;
+    if (!receiver.bind(0)) {
+        std::fprintf(stderr, "Could not bind the batched receiver\n");
+        return false;
+    }
+    const QHostAddress address(QHostAddress::LocalHost);
+    const quint16 port = receiver.localPort();
+
+    int sent = 0;
+    int received = 0;
+    const qint64 start = Timer::systemTime();
+    while (sent < datagrams) {
+        const int batch = std::min(datagrams - sent, int(BatchedUdpSocket::BATCH_SIZE));
+        for (int i = 0; i < batch; i++) {
+            sender.queue(packet, address, port);
+        }
+        sender.flush();
+        sent += batch;
+
+        const qint64 waitStart = Timer::systemTime();
+        while (received < sent && Timer::systemTime() - waitStart < RECEIVE_TIMEOUT) {
+            received += receiver.receive().size();
+        }
+    }
+    printResult("batched", sent, received, Timer::systemTime() - start);
+    return received == sent;
+}
+
+static bool benchmarkPlain(const QByteArray &packet, int datagrams)
+{
+    QUdpSocket sender;
+    QUdpSocket receiver;
+    if (!receiver.bind(QHostAddress::LocalHost, 0)) {
+        std::fprintf(stderr, "Could not bind the plain receiver\n");
+        return false;
+    }
+    const quint16 port = receiver.localPort();
+    QByteArray buffer(BatchedUdpSocket::MAX_DATAGRAM_SIZE, 0);
+
+    int sent = 0;
+    int received = 0;
+    const qint64 start = Timer::systemTime();
+    while (sent < datagrams) {
+        const int batch = std::min(datagrams - sent, int(BatchedUdpSocket::BATCH_SIZE));
+        for (int i = 0; i < batch; i++) {
+            sender.writeDatagram(packet, QHostAddress::LocalHost, port);
+        }
+        sent += batch;
+
+        const qint64 waitStart = Timer::systemTime();
+        while (received < sent && Timer::systemTime() - waitStart < RECEIVE_TIMEOUT) {
+            if (receiver.hasPendingDatagrams() && receiver.readDatagram(buffer.data(), buffer.size()) >= 0) {
+                received++;
+            }
+        }
+    }
+    printResult("plain", sent, received, Timer::systemTime() - start);
+    return received == sent;
+}
+
+bool runUdpBenchmark(int datagrams)
+{
+    if (datagrams <= 0) {
+        std::fprintf(stderr, "The number of datagrams must be positive\n");
+        return false;
+    }
+    if (!BatchedUdpSocket::isBatched()) {
+        std::printf("recvmmsg and sendmmsg are not available, the batched socket falls back to single datagrams\n");
+    }
+    // serialize once, such that both variants only measure the socket calls
+    const sslsim::RobotControl control = benchmarkPacket();
+    QByteArray packet(control.ByteSize(), 0);
+    control.SerializeToArray(packet.data(), packet.size());
+    std::printf("datagram size: %d bytes\n", packet.size());
+    const bool batched = benchmarkBatched(packet, datagrams);
+    const bool plain = benchmarkPlain(packet, datagrams);
+    return batched && plain;
+}
@@ -0,0 +1,379 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "core/configuration.h"
+#include "core/timer.h"
+#include "protobuf/command.h"
+#include "protobuf/sslsim.h"
+#include "protobuf/visionframe.h"
+#include "simulator/fastsimulator.h"
+#include "simulator/simulator.h"
+
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+using camun::simulator::Simulator;
+
+struct BenchmarkConfig
+{
+    int robots;
+    int cameras;
+    QString realism;
+    bool dribbling;
+    bool simplifiedPhysics;
+};
+
+// number of snapshots taken and restored to average their timing
+static const int SNAPSHOT_REPETITIONS = 20;
+
+struct BenchmarkResult
+{
+    qint64 steps = 0;
+    qint64 visionFrames = 0;
+    qint64 visionPackets = 0;
+    double wallTime = 0;
+    // time to apply changed specs of a single robot and a changed camera setup
+    double specsReconfigureTime = 0;
+    double cameraReconfigureTime = 0;
+    // average time to take and to restore a snapshot of the simulation
+    double checkpointTime = 0;
+    double restoreTime = 0;
+};
+
+static robot::Team createTeam(const robot::Generation &generation, int numRobots, bool blue)
+{
+    robot::Team team;
+    for (int i = 0;i<numRobots;i++) {
+        robot::Specs *robot = team.add_robot();
+        robot->CopyFrom(generation.default_());
+        robot->set_id(blue ? (i > 15 ? i : (15 - i)) : i);
+    }
+    return team;
+}
+
+// distributes the cameras in a grid over the field, the grid has more cells along the longer side
+static void setCameras(amun::SimulatorSetup &setup, int numCameras)
+{
+    int columns = int(std::sqrt(numCameras));
+    while (numCameras % columns != 0) {
+        columns--;
+    }
+    const int rows = numCameras / columns;
+    const float width = setup.geometry().field_width();
+    const float height = setup.geometry().field_height();
+
+    setup.clear_camera_setup();
+    for (int i = 0;i<numCameras;i++) {
+        const float x = (i % columns + 0.5f) * width / columns - width / 2;
+        const float y = (i / columns + 0.5f) * height / rows - height / 2;
+        setup.add_camera_setup()->CopyFrom(createDefaultCamera(i, x, y, 4.0f));
+    }
+}
+
+// lets every robot drive in a circle and dribble, thus the robots collide from time to time
+static SSLSimRobotControl createRobotCommands(const robot::Team &team)
+{
+    SSLSimRobotControl control(new sslsim::RobotControl);
+    for (const robot::Specs &robot : team.robot()) {
+        sslsim::RobotCommand *command = control->add_robot_commands();
+        command->set_id(robot.id());
+        command->set_dribbler_speed(1000);
+        sslsim::MoveLocalVelocity *velocity = command->mutable_move_command()->mutable_local_velocity();
+        velocity->set_forward(1.5f);
+        velocity->set_left(0);
+        velocity->set_angular(1.0f + robot.id() * 0.1f);
+    }
+    return control;
+}
+
+static BenchmarkResult runBenchmark(const BenchmarkConfig &config, const amun::SimulatorSetup &baseSetup,
+                                    const robot::Generation &generation, qint64 duration, bool serialize)
+{
+    amun::SimulatorSetup setup = baseSetup;
+    setCameras(setup, config.cameras);
+
+    Timer timer;
+    timer.setTime(1000 * 1000 * 1000, 0);
+    Simulator simulator(&timer, setup, true);
+    simulator.seedPRGN(1);
+    simulator.setVisionFrameOutput(!serialize);
+
+    BenchmarkResult result;
+    QObject::connect(&simulator, &Simulator::gotVisionFrame, [&result](const SimulatorVisionFramePtr &frame, qint64) {
+        result.visionFrames++;
+        result.visionPackets += frame->packets.size();
+    });
+    QObject::connect(&simulator, &Simulator::sendRealData, [&result](const QByteArray &) {
+        result.visionFrames++;
+    });
+    QObject::connect(&simulator, &Simulator::gotPacket, [&result](const QByteArray &, qint64, QString) {
+        result.visionPackets++;
+    });
+
+    const robot::Team blue = createTeam(generation, config.robots, true);
+    const robot::Team yellow = createTeam(generation, config.robots, false);
+
+    Command command(new amun::Command);
+    command->mutable_simulator()->set_enable(true);
+    if (!loadConfiguration("simulator-realism/" + config.realism, command->mutable_simulator()->mutable_realism_config(), true)) {
+        std::exit(1);
+    }
+    command->mutable_simulator()->mutable_realism_config()->set_simulate_dribbling(config.dribbling);
+    command->mutable_simulator()->mutable_realism_config()->set_simplified_physics(config.simplifiedPhysics);
+    command->mutable_set_team_blue()->CopyFrom(blue);
+    command->mutable_set_team_yellow()->CopyFrom(yellow);
+    command->mutable_transceiver()->set_charge(true);
+    sslsim::TeleportBall *ball = command->mutable_simulator()->mutable_ssl_control()->mutable_teleport_ball();
+    ball->set_x(0);
+    ball->set_y(0);
+    ball->set_vx(2);
+    ball->set_vy(1);
+    simulator.handleCommand(command);
+
+    const SSLSimRobotControl blueCommands = createRobotCommands(blue);
+    const SSLSimRobotControl yellowCommands = createRobotCommands(yellow);
+    auto sendCommands = [&] {
+        simulator.handleRadioCommands(blueCommands, true, timer.currentTime());
+        simulator.handleRadioCommands(yellowCommands, false, timer.currentTime());
+    };
+
+    // let the robots settle and fill the vision queue before measuring
+    FastSimulator::goDeltaCallback(&simulator, &timer, 500 * 1000 * 1000, sendCommands);
+    result = BenchmarkResult();
+
+    const qint64 wallStart = Timer::systemTime();
+    const qint64 startTime = timer.currentTime();
+    FastSimulator::goDeltaCallback(&simulator, &timer, duration, sendCommands);
+    result.wallTime = (Timer::systemTime() - wallStart) * 1E-9;
+    // FastSimulator advances the time in steps of 5 ms
+    result.steps = (timer.currentTime() - startTime) / (5 * 1000 * 1000);
+
+    // continue a bit after each restore, so that the restore actually has to reset the simulation
+    const qint64 checkpointSimTime = timer.currentTime();
+    for (int i = 0;i<SNAPSHOT_REPETITIONS;i++) {
+        const qint64 checkpointStart = Timer::systemTime();
+        const auto snapshot = simulator.checkpoint();
+        result.checkpointTime += (Timer::systemTime() - checkpointStart) * 1E-9;
+
+        FastSimulator::goDeltaCallback(&simulator, &timer, 50 * 1000 * 1000, sendCommands);
+
+        timer.setTime(checkpointSimTime, 0);
+        const qint64 restoreStart = Timer::systemTime();
+        simulator.restore(*snapshot);
+        result.restoreTime += (Timer::systemTime() - restoreStart) * 1E-9;
+    }
+    result.checkpointTime /= SNAPSHOT_REPETITIONS;
+    result.restoreTime /= SNAPSHOT_REPETITIONS;
+
+    if (config.robots > 0) {
+        Command specsCommand(new amun::Command);
+        robot::Team *team = specsCommand->mutable_set_team_blue();
+        team->CopyFrom(blue);
+        team->mutable_robot(0)->set_mass(team->robot(0).mass() + 0.1f);
+        const qint64 specsStart = Timer::systemTime();
+        simulator.handleCommand(specsCommand);
+        result.specsReconfigureTime = (Timer::systemTime() - specsStart) * 1E-9;
+    }
+
+    amun::SimulatorSetup cameraSetup = setup;
+    setCameras(cameraSetup, config.cameras == 1 ? 2 : config.cameras - 1);
+    Command cameraCommand(new amun::Command);
+    cameraCommand->mutable_simulator()->mutable_simulator_setup()->CopyFrom(cameraSetup);
+    const qint64 cameraStart = Timer::systemTime();
+    simulator.handleCommand(cameraCommand);
+    result.cameraReconfigureTime = (Timer::systemTime() - cameraStart) * 1E-9;
+
+    return result;
+}
+
+static QList<int> parseIntList(const QString &value)
+{
+    QList<int> list;
+    for (const QString &entry : value.split(',', QString::SkipEmptyParts)) {
+        bool ok;
+        const int number = entry.toInt(&ok);
+        if (!ok || number < 0) {
+            std::cerr <<"Invalid number "<<entry.toStdString()<<std::endl;
+            std::exit(1);
+        }
+        list.append(number);
+    }
+    return list;
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Simulator-Benchmark");
+    app.setOrganizationName("ER-Force");
+
+    std::setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures how the simulator scales with the number of robots, cameras, the realism settings and the physics backend, "
+                                     "how long changing the robot specs and the camera setup takes "
+                                     "and how long taking and restoring a snapshot of the simulation takes");
+    parser.addHelpOption();
+
+    QCommandLineOption robotsOption({"n", "robots"}, "Comma separated robot counts per team, defaults to 0,4,8,11,16", "counts", "0,4,8,11,16");
+    QCommandLineOption camerasOption("cameras", "Comma separated camera counts, defaults to 1,2,4,8", "counts", "1,2,4,8");
+    QCommandLineOption realismOption("realism", "Comma separated simulator realism configurations, defaults to None,Realistic", "realism", "None,Realistic");
+    QCommandLineOption dribblingOption("dribbling", "Dribbling modes to run, either glued, simulated or both, defaults to both", "mode", "both");
+    QCommandLineOption physicsOption("physics", "Physics backends to run, either bullet, simplified or both, defaults to bullet", "backend", "bullet");
+    QCommandLineOption simulatorConfig({"s", "simulator-config"}, "Which simulator config to use (field size etc.), loaded from the config directory", "file", "2020");
+    QCommandLineOption robotGenerationFile("robot-generation", "Robot generation to create the robots of, defaults to generation_2020", "generation", "generation_2020");
+    QCommandLineOption simulationTime({"t", "simulation-time"}, "Number of seconds to simulate per configuration, defaults to 10", "seconds", "10");
+    QCommandLineOption serializeOption("serialize", "Serialize the vision packets like the standalone simulator instead of passing the frames directly");
+    QCommandLineOption outputFile({"o", "output"}, "Write the results as json to the given file", "file");
+    parser.addOption(robotsOption);
+    parser.addOption(camerasOption);
+    parser.addOption(realismOption);
+    parser.addOption(dribblingOption);
+    parser.addOption(physicsOption);
+    parser.addOption(simulatorConfig);
+    parser.addOption(robotGenerationFile);
+    parser.addOption(simulationTime);
+    parser.addOption(serializeOption);
+    parser.addOption(outputFile);
+
+    // parse command line, handles --version
+    parser.process(app);
+
+    const QList<int> robotCounts = parseIntList(parser.value(robotsOption));
+    const QList<int> cameraCounts = parseIntList(parser.value(camerasOption));
+    const QStringList realismConfigs = parser.value(realismOption).split(',', QString::SkipEmptyParts);
+    const QString dribbling = parser.value(dribblingOption);
+    if (dribbling != "glued" && dribbling != "simulated" && dribbling != "both") {
+        std::cerr <<"Invalid dribbling mode "<<dribbling.toStdString()<<std::endl;
+        return 1;
+    }
+    QList<bool> dribblingModes;
+    if (dribbling != "simulated") {
+        dribblingModes.append(false);
+    }
+    if (dribbling != "glued") {
+        dribblingModes.append(true);
+    }
+    const QString physics = parser.value(physicsOption);
+    if (physics != "bullet" && physics != "simplified" && physics != "both") {
+        std::cerr <<"Invalid physics backend "<<physics.toStdString()<<std::endl;
+        return 1;
+    }
+    QList<bool> physicsModes;
+    if (physics != "simplified") {
+        physicsModes.append(false);
+    }
+    if (physics != "bullet") {
+        physicsModes.append(true);
+    }
+    for (int robots : robotCounts) {
+        if (robots > 16) {
+            std::cerr <<"At most 16 robots per team are supported"<<std::endl;
+            return 1;
+        }
+    }
+    for (int cameras : cameraCounts) {
+        if (cameras == 0) {
+            std::cerr <<"At least one camera is required"<<std::endl;
+            return 1;
+        }
+    }
+
+    amun::SimulatorSetup setup;
+    if (!loadConfiguration("simulator/" + parser.value(simulatorConfig), &setup, false)) {
+        return 1;
+    }
+    robot::Generation generation;
+    if (!loadConfiguration("robots/" + parser.value(robotGenerationFile), &generation, true)) {
+        return 1;
+    }
+    const qint64 duration = qint64(parser.value(simulationTime).toDouble() * 1E9);
+    const bool serialize = parser.isSet(serializeOption);
+
+    std::cout <<std::left<<std::setw(8)<<"robots"<<std::setw(9)<<"cameras"<<std::setw(14)<<"realism"
+             <<std::setw(11)<<"dribbling"<<std::setw(12)<<"physics"<<std::setw(12)<<"steps/s"<<std::setw(12)<<"frames/s"<<std::setw(17)<<"realtime factor"
+             <<std::setw(13)<<"specs [ms]"<<std::setw(14)<<"cameras [ms]"<<std::setw(17)<<"checkpoint [ms]"<<"restore [ms]"<<std::endl;
+
+    QJsonArray jsonResults;
+    for (bool simplifiedPhysics : physicsModes) {
+        for (const QString &realism : realismConfigs) {
+            for (bool simulateDribbling : dribblingModes) {
+                for (int cameras : cameraCounts) {
+                    for (int robots : robotCounts) {
+                        const BenchmarkConfig config{robots, cameras, realism, simulateDribbling, simplifiedPhysics};
+                        const BenchmarkResult result = runBenchmark(config, setup, generation, duration, serialize);
+                        const double stepsPerSecond = result.steps / result.wallTime;
+                        const double framesPerSecond = result.visionFrames / result.wallTime;
+                        const double realtimeFactor = duration * 1E-9 / result.wallTime;
+                        std::cout <<std::setw(8)<<robots<<std::setw(9)<<cameras<<std::setw(14)<<realism.toStdString()
+                                 <<std::setw(11)<<(simulateDribbling ? "simulated" : "glued")<<std::setw(12)<<(simplifiedPhysics ? "simplified" : "bullet")
+                                 <<std::setw(12)<<int(stepsPerSecond)<<std::setw(12)<<int(framesPerSecond)<<std::setw(17)<<realtimeFactor
+                                 <<std::setw(13)<<result.specsReconfigureTime * 1000<<std::setw(14)<<result.cameraReconfigureTime * 1000
+                                 <<std::setw(17)<<result.checkpointTime * 1000<<result.restoreTime * 1000<<std::endl;
+
+                        QJsonObject object;
+                        object["robots_per_team"] = robots;
+                        object["cameras"] = cameras;
+                        object["realism"] = realism;
+                        object["simulate_dribbling"] = simulateDribbling;
+                        object["simplified_physics"] = simplifiedPhysics;
+                        object["steps"] = double(result.steps);
+                        object["vision_frames"] = double(result.visionFrames);
+                        object["vision_packets"] = double(result.visionPackets);
+                        object["wall_time"] = result.wallTime;
+                        object["steps_per_second"] = stepsPerSecond;
+                        object["vision_frames_per_second"] = framesPerSecond;
+                        object["specs_reconfigure_time"] = result.specsReconfigureTime;
+                        object["camera_reconfigure_time"] = result.cameraReconfigureTime;
+                        object["checkpoint_time"] = result.checkpointTime;
+                        object["restore_time"] = result.restoreTime;
+                        jsonResults.append(object);
+                    }
+                }
+            }
+        }
+    }
+
+    if (parser.isSet(outputFile)) {
+        QJsonObject summary;
+        summary["simulated_time"] = duration * 1E-9;
+        summary["serialize"] = serialize;
+        summary["results"] = jsonResults;
+
+        QFile file(parser.value(outputFile));
+        if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+            std::cerr <<"Could not open output file "<<file.fileName().toStdString()<<std::endl;
+            return 1;
+        }
+        file.write(QJsonDocument(summary).toJson());
+    }
+
+    return 0;
+}
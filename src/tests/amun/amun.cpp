@@ -20,12 +20,18 @@
 
 #include "gtest/gtest.h"
 #include "amun/amun.h"
+#include "amun/lockstepamun.h"
 #include "config/config.h"
+#include "core/coordinates.h"
+#include "protobuf/command.h"
+#include "protobuf/robot.h"
 #include "seshat/logfilereader.h"
 
 #include <QCoreApplication>
 #include <QProcess>
 #include <map>
+#include <string>
+#include <vector>
 
 static void checkTeamEquality(google::protobuf::RepeatedPtrField<world::Robot> r1,
                               google::protobuf::RepeatedPtrField<world::Robot> r2)
@@ -151,3 +157,45 @@ TEST(Amun, DISABLED_TrackingReplay) {
         }
     }
 }
+
+static std::vector<std::string> runLockstep(uint32_t seed, int steps)
+{
+    amun::SimulatorSetup setup;
+    simulatorSetupSetDefault(setup);
+    // no strategies, thus no compiler is necessary
+    LockstepAmun amun(setup, nullptr, seed, false, false);
+    amun.setDeterministicStatus(true);
+
+    std::vector<std::string> statuses;
+    QObject::connect(&amun, &LockstepAmun::sendStatus, [&statuses](const Status &status) {
+        statuses.push_back(status->SerializeAsString());
+    });
+
+    Command command(new amun::Command);
+    command->mutable_simulator()->set_enable(true);
+    for (robot::Team *team : {command->mutable_set_team_blue(), command->mutable_set_team_yellow()}) {
+        for (int i = 0; i < 3; i++) {
+            robot::Specs *specs = team->add_robot();
+            robotSetDefault(specs);
+            specs->set_id(i);
+        }
+    }
+    // a moving ball, such that the tracking has something to do
+    auto *teleport = command->mutable_simulator()->mutable_ssl_control()->mutable_teleport_ball();
+    coordinates::toVision(Vector(0, 0), *teleport);
+    teleport->set_z(0);
+    coordinates::toVisionVelocity(Vector(1, 2), *teleport);
+    teleport->set_vz(0);
+    amun.handleCommand(command);
+
+    for (int i = 0; i < steps; i++) {
+        amun.step();
+    }
+    return statuses;
+}
+
+TEST(LockstepAmun, SameSeedSameStatus) {
+    const std::vector<std::string> first = runLockstep(42, 200);
+    ASSERT_GT(first.size(), 0u);
+    ASSERT_EQ(first, runLockstep(42, 200));
+}
@@ -34,6 +34,7 @@
 #include <QQuaternion>
 #include <algorithm>
 #include <functional>
+#include <set>
 #include <cmath>
 
 constexpr const float SHOOT_LINEAR_MAX = 8.0f;
@@ -112,14 +113,14 @@ public:
         emit test.sendCommand(c);
     }
 
-    void loadRobots(int blue, int yellow) {
+    void loadRobots(int blue, int yellow, float mass = 1.5) {
         Command c{new amun::Command};
 
         robot::Specs fourteen;
         fourteen.set_generation(0);
         fourteen.set_year(1970);
         fourteen.set_type(robot::Specs::Regular);
-        fourteen.set_mass(1.5);
+        fourteen.set_mass(mass);
         fourteen.set_angle(0.98291);
         fourteen.set_v_max(3);
         fourteen.set_omega_max(6);
@@ -955,3 +956,263 @@ TEST_F(ShootTest, ShootSpeedCapped) {
     const float max_speed = measureMaxShootSpeed(SHOOT_LINEAR_MAX + 5.0f);
     EXPECT_LT(max_speed, SHOOT_LINEAR_MAX + 0.1f);
 }
+
+TEST_F(ShootTest, SnapshotRollout) {
+    prepareShoot();
+    FastSimulator::goDelta(s, &t, 1e8);
+    const qint64 checkpointTime = t.currentTime();
+    const auto snapshot = s->checkpoint();
+
+    const float first_speed = measureMaxShootSpeed(4.0f);
+    EXPECT_LT(std::abs(first_speed - 4.0f), 0.10f);
+
+    // a different rollout from the same situation
+    s->restore(*snapshot);
+    t.setTime(checkpointTime, 0);
+    const float other_speed = measureMaxShootSpeed(6.0f);
+    EXPECT_LT(std::abs(other_speed - 6.0f), 0.10f);
+
+    // every rollout from a snapshot continues identically
+    s->restore(*snapshot);
+    t.setTime(checkpointTime, 0);
+    const float repeated_speed = measureMaxShootSpeed(4.0f);
+    s->restore(*snapshot);
+    t.setTime(checkpointTime, 0);
+    EXPECT_EQ(measureMaxShootSpeed(4.0f), repeated_speed);
+}
+
+TEST_F(FastSimulatorTest, SnapshotRestoreTrajectory) {
+    loadRobots(11, 11);
+    FastSimulator::goDelta(s, &t, 1e8);
+    const qint64 checkpointTime = t.currentTime();
+    const auto snapshot = s->checkpoint();
+
+    std::vector<std::string> trajectory;
+    test.handleSimulatorTruth = [&trajectory](const world::SimulatorState &truth) {
+        trajectory.push_back(truth.SerializeAsString());
+    };
+    test.handleDetectionWrapper = [&trajectory](const SSL_WrapperPacket &packet, qint64) {
+        trajectory.push_back(packet.SerializeAsString());
+    };
+
+    // the contact caches are not part of the snapshot, thus only the restored runs are identical
+    s->restore(*snapshot);
+    t.setTime(checkpointTime, 0);
+    FastSimulator::goDelta(s, &t, 2e8);
+    const std::vector<std::string> restored = std::move(trajectory);
+    ASSERT_GT(restored.size(), 0u);
+
+    for (int i = 0; i < 2; i++) {
+        FastSimulator::goDelta(s, &t, 1e8);
+        s->restore(*snapshot);
+        t.setTime(checkpointTime, 0);
+        trajectory.clear();
+        FastSimulator::goDelta(s, &t, 2e8);
+        ASSERT_EQ(restored, trajectory);
+    }
+}
+
+TEST_F(FastSimulatorTest, VisionFrameOutput) {
+    QObject::disconnect(s, &Simulator::sendRealData, &test, &SimTester::handleSimulatorTruthRaw);
+    loadRobots(3, 3);
+    std::vector<std::string> serialized;
+    test.handleDetectionWrapper = [&serialized](const SSL_WrapperPacket &packet, qint64) {
+        serialized.push_back(packet.SerializeAsString());
+    };
+    FastSimulator::goDelta(s, &t, 2e8);
+    ASSERT_GT(serialized.size(), 0u);
+
+    // the same run with frames handed out directly must yield the same packets
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    createSimulator(setup);
+    QObject::disconnect(s, &Simulator::sendRealData, &test, &SimTester::handleSimulatorTruthRaw);
+    s->setVisionFrameOutput(true);
+    loadRobots(3, 3);
+    std::vector<std::string> direct;
+    std::vector<SimulatorVisionFramePtr> heldFrames;
+    QObject::connect(s, &Simulator::gotVisionFrame, [&](const SimulatorVisionFramePtr &frame, qint64) {
+        for (const auto &packet : frame->packets) {
+            direct.push_back(packet.SerializeAsString());
+        }
+        // frames still held by a receiver must not be reused
+        heldFrames.push_back(frame);
+        if (heldFrames.size() > 4) {
+            heldFrames.erase(heldFrames.begin());
+        }
+        for (std::size_t i = 0; i + 1 < heldFrames.size(); i++) {
+            ASSERT_NE(heldFrames[i].get(), frame.get());
+        }
+    });
+    FastSimulator::goDelta(s, &t, 2e8);
+    ASSERT_EQ(serialized, direct);
+}
+
+TEST_F(FastSimulatorTest, ReconfigureInPlace) {
+    loadRobots(2, 0);
+
+    const Vector desiredPos(2, 3);
+    Command command(new amun::Command);
+    auto teleport = command->mutable_simulator()->mutable_ssl_control()->add_teleport_robot();
+    teleport->mutable_id()->set_id(0);
+    teleport->mutable_id()->set_team(gameController::Team::BLUE);
+    coordinates::toVision(desiredPos, *teleport);
+    teleport->set_v_x(0);
+    teleport->set_v_y(0);
+    teleport->set_v_angular(0);
+    teleport->set_orientation(0);
+    emit test.sendCommand(command);
+    FastSimulator::goDelta(s, &t, 5e7);
+
+    auto checkRobots = [&desiredPos](int expected) {
+        return [&desiredPos, expected](const world::SimulatorState &truth) {
+            ASSERT_EQ(truth.blue_robots_size(), expected);
+            for (const auto &robot : truth.blue_robots()) {
+                if (robot.id() == 0) {
+                    ASSERT_LE(desiredPos.distance(Vector(robot.p_x(), robot.p_y())), 0.01f);
+                }
+            }
+        };
+    };
+
+    // unchanged specs keep the robots, changed specs rebuild them at their pose
+    loadRobots(3, 0);
+    test.handleSimulatorTruth = checkRobots(3);
+    FastSimulator::goDelta(s, &t, 5e7);
+    loadRobots(3, 0, 2.0);
+    FastSimulator::goDelta(s, &t, 5e7);
+
+    // a new camera setup does not reset the world either
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    setup.clear_camera_setup();
+    setup.add_camera_setup()->CopyFrom(createDefaultCamera(0, 0, -3, 4));
+    setup.add_camera_setup()->CopyFrom(createDefaultCamera(1, 0, 3, 4));
+    Command setupCommand(new amun::Command);
+    setupCommand->mutable_simulator()->mutable_simulator_setup()->CopyFrom(setup);
+    emit test.sendCommand(setupCommand);
+
+    std::set<uint32_t> cameras;
+    test.handleDetectionWrapper = [&cameras](const SSL_WrapperPacket &packet, qint64) {
+        cameras.insert(packet.detection().camera_id());
+    };
+    FastSimulator::goDelta(s, &t, 1e8);
+    ASSERT_EQ(cameras.size(), 2u);
+}
+
+class SimplifiedPhysicsTest : public ShootTest {
+protected:
+    void reset(bool simplified) {
+        amun::SimulatorSetup setup;
+        loadConfiguration("cpptests/simulator-2020", &setup, false);
+        createSimulator(setup);
+        loadRobots(0, 1);
+
+        Command command{new amun::Command};
+        command->mutable_simulator()->mutable_realism_config()->set_simplified_physics(simplified);
+        emit test.sendCommand(command);
+    }
+
+    // returns the position where the ball stops
+    Vector rollBall(const Vector &speed) {
+        Command command{new amun::Command};
+        sslsim::TeleportBall *teleport = command->mutable_simulator()->mutable_ssl_control()->mutable_teleport_ball();
+        coordinates::toVision(Vector(0, -1), *teleport);
+        teleport->set_z(0);
+        coordinates::toVisionVelocity(speed, *teleport);
+        teleport->set_vz(0);
+        emit test.sendCommand(command);
+
+        Vector position;
+        test.handleSimulatorTruth = [&position](const world::SimulatorState &truth) {
+            position = Vector(truth.ball().p_x(), truth.ball().p_y());
+        };
+        FastSimulator::goDelta(s, &t, 6e9);
+        return position;
+    }
+
+    // returns the distance driven by the robot after accelerating for one second
+    float driveForward(float speed) {
+        SSLSimRobotControl control{new sslsim::RobotControl};
+        auto *command = control->add_robot_commands();
+        command->set_id(0);
+        auto *localVelocity = command->mutable_move_command()->mutable_local_velocity();
+        localVelocity->set_forward(speed);
+        localVelocity->set_left(0);
+        localVelocity->set_angular(0);
+
+        bool init = false;
+        Vector start, end;
+        test.handleSimulatorTruth = [&](const world::SimulatorState &truth) {
+            ASSERT_EQ(truth.yellow_robots_size(), 1);
+            end = Vector(truth.yellow_robots(0).p_x(), truth.yellow_robots(0).p_y());
+            if (!init) {
+                start = end;
+                init = true;
+            }
+        };
+        FastSimulator::goDeltaCallback(s, &t, 1e9, [&control, this]() {
+            emit test.sendSSLRadioCommand(control, false, 0);
+        });
+        return (end - start).length();
+    }
+};
+
+// Compares the simplified physics to the full simulation on standard situations,
+// the deviations are recorded to keep track of the accuracy
+TEST_F(SimplifiedPhysicsTest, AccuracyReport) {
+    float shootSpeed[2], driveDistance[2];
+    Vector ballStop[2];
+    for (bool simplified : {false, true}) {
+        reset(simplified);
+        prepareShoot();
+        shootSpeed[simplified] = measureMaxShootSpeed(4.0f);
+
+        reset(simplified);
+        ballStop[simplified] = rollBall(Vector(0.5, 2));
+
+        reset(simplified);
+        FastSimulator::goDelta(s, &t, 1e8);
+        driveDistance[simplified] = driveForward(2.0f);
+    }
+
+    const float shootDeviation = std::abs(shootSpeed[0] - shootSpeed[1]);
+    const float ballStopDeviation = (ballStop[0] - ballStop[1]).length();
+    const float driveDeviation = std::abs(driveDistance[0] - driveDistance[1]);
+    RecordProperty("shoot_speed_deviation_mm_per_s", int(shootDeviation * 1000));
+    RecordProperty("ball_stop_deviation_mm", int(ballStopDeviation * 1000));
+    RecordProperty("drive_distance_deviation_mm", int(driveDeviation * 1000));
+
+    EXPECT_LT(shootDeviation, 0.2f);
+    EXPECT_LT(ballStopDeviation, 0.5f);
+    EXPECT_LT(driveDeviation, 0.15f);
+}
+
+// the simplified ball follows the ball model configured with the geometry
+TEST_F(SimplifiedPhysicsTest, ConfiguredBallModel) {
+    const float fastDeceleration = 3.0f;
+    const float slowDeceleration = 0.5f;
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    setup.mutable_geometry()->mutable_ball_model()->set_fast_deceleration(fastDeceleration);
+    setup.mutable_geometry()->mutable_ball_model()->set_slow_deceleration(slowDeceleration);
+    createSimulator(setup);
+
+    Command command{new amun::Command};
+    command->mutable_simulator()->mutable_realism_config()->set_simplified_physics(true);
+    emit test.sendCommand(command);
+
+    const Vector speed(0.5, 2);
+    const Vector stop = rollBall(speed);
+
+    // a ball without spin slides until it rolls with 5/7 of its initial speed,
+    // the rolling friction is scaled by 1.4 like in the full simulation
+    const float initialSpeed = speed.length();
+    const float rollingSpeed = initialSpeed * 5.0f / 7.0f;
+    const float slidingDistance = (initialSpeed * initialSpeed - rollingSpeed * rollingSpeed) / (2 * fastDeceleration);
+    const float rollingDistance = rollingSpeed * rollingSpeed / (2 * 1.4f * slowDeceleration);
+
+    const Vector traveled = stop - Vector(0, -1);
+    EXPECT_NEAR(traveled.length(), slidingDistance + rollingDistance, 0.05f);
+    EXPECT_NEAR(traveled.x * speed.y - traveled.y * speed.x, 0.0f, 0.01f);
+}
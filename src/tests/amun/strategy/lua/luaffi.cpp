@@ -0,0 +1,138 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "strategy/lua/lua_ffi.h"
+#include "protobuf/gamestate.pb.h"
+#include "protobuf/robot.pb.h"
+#include "protobuf/world.pb.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+TEST(LuaFFI, Declarations) {
+    const char *declarations = ffiDeclarations();
+    ASSERT_NE(std::strstr(declarations, "amun_ffi_world_state;"), nullptr);
+    ASSERT_NE(std::strstr(declarations, "amun_ffi_commands;"), nullptr);
+    // array sizes must be expanded for ffi.cdef
+    ASSERT_EQ(std::strstr(declarations, "LUA_FFI_"), nullptr);
+}
+
+TEST(LuaFFI, WorldState) {
+    world::State state;
+    state.set_time(1234);
+    state.set_has_vision_data(false);
+    world::Ball *ball = state.mutable_ball();
+    ball->set_p_x(1);
+    ball->set_p_y(2);
+    ball->set_v_x(3);
+    ball->set_v_y(4);
+    ball->set_p_z(0.5f);
+    world::BallPosition *raw = ball->add_raw();
+    raw->set_time(1000);
+    raw->set_p_x(5);
+    raw->set_p_y(6);
+    world::Robot *robot = state.add_blue();
+    robot->set_id(7);
+    robot->set_p_x(1);
+    robot->set_p_y(2);
+    robot->set_phi(3);
+    robot->set_v_x(4);
+    robot->set_v_y(5);
+    robot->set_omega(6);
+
+    amun_ffi_world_state out;
+    ffiFillWorldState(out, state);
+    ASSERT_EQ(out.time, 1234);
+    ASSERT_FALSE(out.has_vision_data);
+    ASSERT_TRUE(out.has_ball);
+    ASSERT_EQ(out.ball.p_z, 0.5f);
+    ASSERT_TRUE(std::isnan(out.ball.v_z));
+    ASSERT_TRUE(std::isnan(out.ball.touchdown_x));
+    ASSERT_EQ(out.ball.raw_count, 1);
+    ASSERT_EQ(out.ball.raw[0].p_y, 6);
+    ASSERT_EQ(out.yellow_count, 0);
+    ASSERT_EQ(out.blue_count, 1);
+    ASSERT_EQ(out.blue[0].id, 7u);
+    ASSERT_EQ(out.blue[0].omega, 6);
+
+    // vision data is only missing if it is explicitly reported
+    state.clear_has_vision_data();
+    for (int i = 0; i < LUA_FFI_MAX_ROBOTS + 1; i++) {
+        state.add_yellow()->CopyFrom(*robot);
+    }
+    ffiFillWorldState(out, state);
+    ASSERT_TRUE(out.has_vision_data);
+    ASSERT_EQ(out.yellow_count, LUA_FFI_MAX_ROBOTS);
+}
+
+TEST(LuaFFI, GameState) {
+    amun::GameState state;
+    state.set_state(amun::GameState::BallPlacementBlue);
+    state.set_stage(SSL_Referee::NORMAL_SECOND_HALF);
+    state.mutable_designated_position()->set_x(100);
+    state.mutable_designated_position()->set_y(-200);
+    state.mutable_blue()->set_goalie(3);
+    state.mutable_blue()->add_yellow_card_times(120000000);
+
+    amun_ffi_game_state out;
+    ffiFillGameState(out, state);
+    ASSERT_EQ(out.state, amun::GameState::BallPlacementBlue);
+    ASSERT_EQ(out.stage, SSL_Referee::NORMAL_SECOND_HALF);
+    ASSERT_TRUE(out.has_designated_position);
+    ASSERT_EQ(out.designated_y, -200);
+    ASSERT_EQ(out.blue.goalie, 3u);
+    ASSERT_EQ(out.blue.yellow_card_count, 1u);
+    ASSERT_EQ(out.blue.yellow_card_times[0], 120000000u);
+    ASSERT_EQ(out.yellow.yellow_card_count, 0u);
+}
+
+TEST(LuaFFI, Command) {
+    const float NaN = std::numeric_limits<float>::quiet_NaN();
+    amun_ffi_command in{};
+    in.spline_count = -1;
+    in.v_f = NaN;
+    in.v_s = NaN;
+    in.omega = NaN;
+    in.dribbler = 0.5f;
+
+    robot::Command halt;
+    ffiToCommand(in, halt);
+    ASSERT_FALSE(halt.has_controller());
+    ASSERT_FALSE(halt.has_v_f());
+    ASSERT_FALSE(halt.has_kick_style());
+    ASSERT_FALSE(halt.has_kick_power());
+    ASSERT_EQ(halt.dribbler(), 0.5f);
+    ASSERT_TRUE(halt.has_standby());
+
+    in.spline_count = 1;
+    in.spline[0].t_end = 2;
+    in.spline[0].x[1] = 1.5f;
+    in.kick_style = robot::Command::Chip;
+    in.kick_power = 3;
+    robot::Command command;
+    ffiToCommand(in, command);
+    ASSERT_EQ(command.controller().spline_size(), 1);
+    ASSERT_EQ(command.controller().spline(0).t_end(), 2);
+    ASSERT_EQ(command.controller().spline(0).x().a1(), 1.5f);
+    ASSERT_EQ(command.kick_style(), robot::Command::Chip);
+    ASSERT_EQ(command.kick_power(), 3);
+}
@@ -0,0 +1,56 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "strategy/script/profilesamples.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+TEST(ProfileSamples, CollapsedStacks) {
+    ProfileSamples samples(1000);
+    samples.add({"main", "update"}, 3);
+    samples.add({"main"}, 1);
+    // samples of a second profile are merged
+    samples.add({"main", "update"}, 2);
+    samples.add({"main", "a;b"}, 1);
+    samples.add({"main", "never"}, 0);
+
+    ASSERT_EQ(samples.toCollapsedStacks(), QByteArray("main 1\nmain;a,b 1\nmain;update 5\n"));
+}
+
+TEST(ProfileSamples, Speedscope) {
+    ProfileSamples samples(500);
+    samples.add({"main", "update"}, 4);
+    samples.add({"main"}, 2);
+
+    const QJsonObject file = QJsonDocument::fromJson(samples.toSpeedscope("test")).object();
+    const QJsonArray frames = file["shared"].toObject()["frames"].toArray();
+    ASSERT_EQ(frames.size(), 2);
+    ASSERT_EQ(frames[0].toObject()["name"].toString(), "main");
+    ASSERT_EQ(frames[1].toObject()["name"].toString(), "update");
+
+    const QJsonObject profile = file["profiles"].toArray()[0].toObject();
+    ASSERT_EQ(profile["type"].toString(), "sampled");
+    ASSERT_EQ(profile["samples"].toArray(), (QJsonArray{QJsonArray{0}, QJsonArray{0, 1}}));
+    ASSERT_EQ(profile["weights"].toArray(), (QJsonArray{1000, 2000}));
+    ASSERT_EQ(profile["endValue"].toInt(), 3000);
+}
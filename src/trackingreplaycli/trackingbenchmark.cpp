@@ -0,0 +1,251 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "trackingbenchmark.h"
+#include "core/timer.h"
+#include "processor/trackingreplay.h"
+#include "protobuf/status.h"
+#include "seshat/logfilereader.h"
+#include "seshat/logfilewriter.h"
+#include <QFileInfo>
+#include <QMap>
+#include <algorithm>
+#include <cmath>
+
+TrackingBenchmark::TrackingBenchmark(float tolerance) :
+    m_tolerance(tolerance)
+{ }
+
+static void updateDeviation(float &maxDeviation, float value, float golden)
+{
+    maxDeviation = std::max(maxDeviation, std::abs(value - golden));
+}
+
+static bool compareRobots(const google::protobuf::RepeatedPtrField<world::Robot> &robots,
+                          const google::protobuf::RepeatedPtrField<world::Robot> &goldenRobots, float &maxDeviation)
+{
+    if (robots.size() != goldenRobots.size()) {
+        return false;
+    }
+    QMap<uint, const world::Robot*> goldenById;
+    for (const world::Robot &robot : goldenRobots) {
+        goldenById[robot.id()] = &robot;
+    }
+    for (const world::Robot &robot : robots) {
+        const world::Robot *golden = goldenById.value(robot.id(), nullptr);
+        if (golden == nullptr) {
+            return false;
+        }
+        updateDeviation(maxDeviation, robot.p_x(), golden->p_x());
+        updateDeviation(maxDeviation, robot.p_y(), golden->p_y());
+        updateDeviation(maxDeviation, robot.phi(), golden->phi());
+        updateDeviation(maxDeviation, robot.v_x(), golden->v_x());
+        updateDeviation(maxDeviation, robot.v_y(), golden->v_y());
+        updateDeviation(maxDeviation, robot.omega(), golden->omega());
+    }
+    return true;
+}
+
+TrackingBenchmark::Deviation TrackingBenchmark::compareWorldStates(const world::State &state, const world::State &golden)
+{
+    Deviation result;
+    if (!compareRobots(state.blue(), golden.blue(), result.maxDeviation)
+            || !compareRobots(state.yellow(), golden.yellow(), result.maxDeviation)
+            || state.has_ball() != golden.has_ball()) {
+        result.structureMismatch = true;
+        return result;
+    }
+    if (state.has_ball()) {
+        const world::Ball &ball = state.ball();
+        const world::Ball &goldenBall = golden.ball();
+        updateDeviation(result.maxDeviation, ball.p_x(), goldenBall.p_x());
+        updateDeviation(result.maxDeviation, ball.p_y(), goldenBall.p_y());
+        updateDeviation(result.maxDeviation, ball.p_z(), goldenBall.p_z());
+        updateDeviation(result.maxDeviation, ball.v_x(), goldenBall.v_x());
+        updateDeviation(result.maxDeviation, ball.v_y(), goldenBall.v_y());
+        updateDeviation(result.maxDeviation, ball.v_z(), goldenBall.v_z());
+    }
+    return result;
+}
+
+// strips everything but the tracked objects to keep golden files small
+static Status goldenStatus(const Status &status)
+{
+    Status golden(new amun::Status);
+    golden->set_time(status->time());
+    world::State *state = golden->mutable_world_state();
+    state->set_time(status->world_state().time());
+    state->mutable_blue()->CopyFrom(status->world_state().blue());
+    state->mutable_yellow()->CopyFrom(status->world_state().yellow());
+    if (status->world_state().has_ball()) {
+        state->mutable_ball()->CopyFrom(status->world_state().ball());
+    }
+    for (world::Robot &robot : *state->mutable_blue()) {
+        robot.clear_raw();
+    }
+    for (world::Robot &robot : *state->mutable_yellow()) {
+        robot.clear_raw();
+    }
+    if (state->has_ball()) {
+        state->mutable_ball()->clear_raw();
+    }
+    return golden;
+}
+
+bool TrackingBenchmark::runLog(const QString &filename, const QString &goldenFilename, bool updateGolden)
+{
+    QJsonObject logResult;
+    logResult["log"] = filename;
+
+    LogFileReader logfile;
+    if (!logfile.open(filename)) {
+        logResult["error"] = "could not open logfile";
+        m_logResults.append(logResult);
+        return false;
+    }
+
+    LogFileReader goldenReader;
+    LogFileWriter goldenWriter;
+    bool compareGolden = false;
+    if (!goldenFilename.isEmpty()) {
+        if (updateGolden) {
+            if (!goldenWriter.open(goldenFilename, true)) {
+                logResult["error"] = "could not write golden file";
+                m_logResults.append(logResult);
+                return false;
+            }
+        } else if (QFileInfo::exists(goldenFilename)) {
+            compareGolden = goldenReader.open(goldenFilename);
+        }
+    }
+
+    Timer timer;
+    timer.setTime(0, 0);
+    TrackingReplay replay(&timer);
+
+    Command command(new amun::Command);
+    command->mutable_tracking()->set_measure_filter_timing(true);
+    replay.handleCommand(command);
+
+    qint64 frames = 0;
+    // time spent for evaluation in the status callback, which is not part of the tracking
+    qint64 evaluationTime = 0;
+    double trackingTime = 0, robotFilterTime = 0, groundFilterTime = 0, flyFilterTime = 0;
+    float maxDeviation = 0;
+    qint64 driftFrames = 0;
+    qint64 mismatchedFrames = 0;
+
+    replay.connect(&replay, &TrackingReplay::gotStatus, [&](const Status &status) {
+        if (!status->has_world_state()) {
+            return;
+        }
+        const qint64 evaluationStart = Timer::systemTime();
+        if (status->has_timing()) {
+            const amun::Timing &timing = status->timing();
+            trackingTime += timing.tracking();
+            robotFilterTime += timing.tracking_robot_filter();
+            groundFilterTime += timing.tracking_ground_filter();
+            flyFilterTime += timing.tracking_fly_filter();
+        }
+
+        if (updateGolden && goldenWriter.isOpen()) {
+            goldenWriter.writeStatus(goldenStatus(status));
+        } else if (compareGolden) {
+            if (frames < goldenReader.packetCount()) {
+                const Status golden = goldenReader.readStatus(frames);
+                const Deviation deviation = golden.isNull() ? Deviation { 0, true } :
+                        compareWorldStates(status->world_state(), golden->world_state());
+                if (deviation.structureMismatch) {
+                    mismatchedFrames++;
+                } else if (deviation.maxDeviation > m_tolerance) {
+                    driftFrames++;
+                }
+                maxDeviation = std::max(maxDeviation, deviation.maxDeviation);
+            } else {
+                // frames beyond the end of the golden file
+                mismatchedFrames++;
+            }
+        }
+        frames++;
+        evaluationTime += Timer::systemTime() - evaluationStart;
+    });
+
+    qint64 replayTime = 0;
+    for (int i = 0; i < logfile.packetCount(); i++) {
+        const Status status = logfile.readStatus(i);
+        if (status.isNull()) {
+            continue;
+        }
+        const qint64 start = Timer::systemTime();
+        replay.handleStatus(status);
+        replayTime += Timer::systemTime() - start;
+    }
+    replayTime -= evaluationTime;
+
+    const double seconds = replayTime * 1E-9;
+    logResult["frames"] = frames;
+    logResult["time"] = seconds;
+    logResult["frames_per_second"] = seconds > 0 ? frames / seconds : 0;
+
+    QJsonObject filterTimes;
+    filterTimes["tracking"] = trackingTime;
+    filterTimes["robot_filter"] = robotFilterTime;
+    filterTimes["ball_ground_collision_filter"] = groundFilterTime;
+    filterTimes["fly_filter"] = flyFilterTime;
+    logResult["filter_time"] = filterTimes;
+
+    if (updateGolden) {
+        goldenWriter.close();
+        logResult["golden"] = "updated";
+    } else if (compareGolden) {
+        // golden frames which were not reproduced, additional frames are already counted
+        if (frames < goldenReader.packetCount()) {
+            mismatchedFrames += goldenReader.packetCount() - frames;
+        }
+        const bool hasDrift = driftFrames > 0 || mismatchedFrames > 0;
+        QJsonObject golden;
+        golden["max_deviation"] = maxDeviation;
+        golden["drift_frames"] = driftFrames;
+        golden["mismatched_frames"] = mismatchedFrames;
+        golden["passed"] = !hasDrift;
+        logResult["golden"] = golden;
+        m_hasDrift |= hasDrift;
+    } else if (!goldenFilename.isEmpty()) {
+        logResult["golden"] = "missing";
+    }
+
+    m_totalFrames += frames;
+    m_totalTime += replayTime;
+    m_logResults.append(logResult);
+    return !compareGolden || (driftFrames == 0 && mismatchedFrames == 0);
+}
+
+QJsonObject TrackingBenchmark::result() const
+{
+    const double seconds = m_totalTime * 1E-9;
+    QJsonObject result;
+    result["logs"] = m_logResults;
+    result["frames"] = m_totalFrames;
+    result["time"] = seconds;
+    result["frames_per_second"] = seconds > 0 ? m_totalFrames / seconds : 0;
+    result["tolerance"] = m_tolerance;
+    result["drift"] = m_hasDrift;
+    return result;
+}
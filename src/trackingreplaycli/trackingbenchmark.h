@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   Copyright 2026 ER-Force                                               *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TRACKINGBENCHMARK_H
+#define TRACKINGBENCHMARK_H
+
+#include "protobuf/world.pb.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+class TrackingBenchmark
+{
+public:
+    explicit TrackingBenchmark(float tolerance);
+
+    // replays the log as fast as possible, compares the resulting world states
+    // with the golden file if it exists or writes it if updateGolden is set
+    bool runLog(const QString &filename, const QString &goldenFilename, bool updateGolden);
+    QJsonObject result() const;
+
+private:
+    struct Deviation {
+        float maxDeviation = 0;
+        bool structureMismatch = false;
+    };
+    static Deviation compareWorldStates(const world::State &state, const world::State &golden);
+
+private:
+    const float m_tolerance;
+    QJsonArray m_logResults;
+    qint64 m_totalFrames = 0;
+    qint64 m_totalTime = 0;
+    bool m_hasDrift = false;
+};
+
+#endif // TRACKINGBENCHMARK_H
@@ -20,6 +20,10 @@
 
 #include <QCoreApplication>
 #include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
 #include <clocale>
 #include <QtGlobal>
 #include <iostream>
@@ -28,6 +32,56 @@
 #include "protobuf/status.h"
 #include "seshat/logfilereader.h"
 #include "core/timer.h"
+#include "trackingbenchmark.h"
+
+static int runBenchmark(const QString &path, const QCommandLineParser &parser, const QCommandLineOption &goldenOption,
+                        const QCommandLineOption &updateGoldenOption, const QCommandLineOption &toleranceOption,
+                        const QCommandLineOption &outputOption)
+{
+    QStringList logs;
+    const QFileInfo pathInfo(path);
+    if (pathInfo.isDir()) {
+        const QDir dir(path);
+        for (const QString &file : dir.entryList({"*.log"}, QDir::Files, QDir::Name)) {
+            logs.append(dir.filePath(file));
+        }
+    } else {
+        logs.append(path);
+    }
+
+    bool ok = false;
+    const float tolerance = parser.value(toleranceOption).toFloat(&ok);
+    if (!ok || tolerance < 0) {
+        std::cerr <<"Invalid tolerance "<<parser.value(toleranceOption).toStdString()<<std::endl;
+        return 1;
+    }
+
+    // golden files are named like the log they belong to
+    const QString goldenDir = parser.value(goldenOption);
+    if (!goldenDir.isEmpty() && parser.isSet(updateGoldenOption)) {
+        QDir().mkpath(goldenDir);
+    }
+
+    TrackingBenchmark benchmark(tolerance);
+    bool success = true;
+    for (const QString &log : logs) {
+        const QString golden = goldenDir.isEmpty() ? QString() : QDir(goldenDir).filePath(QFileInfo(log).fileName());
+        success &= benchmark.runLog(log, golden, parser.isSet(updateGoldenOption));
+    }
+
+    const QByteArray json = QJsonDocument(benchmark.result()).toJson();
+    if (parser.isSet(outputOption)) {
+        QFile output(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::cerr <<"Could not open output file "<<output.fileName().toStdString()<<std::endl;
+            return 1;
+        }
+        output.write(json);
+    } else {
+        std::cout <<json.toStdString();
+    }
+    return success ? 0 : 2;
+}
 
 int main(int argc, char* argv[])
 {
@@ -41,7 +95,18 @@ int main(int argc, char* argv[])
     parser.setApplicationDescription("Command line interface for tracking replay on ER-Force logs");
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.addPositionalArgument("logfile", "Log file to read");
+    parser.addPositionalArgument("logfile", "Log file to read, may be a directory of logs in benchmark mode");
+
+    QCommandLineOption benchmarkOption("benchmark", "Run the tracking as fast as possible and report the performance as json");
+    QCommandLineOption goldenOption("golden", "Directory with golden files to compare the tracked world states against", "directory");
+    QCommandLineOption updateGoldenOption("update-golden", "Write the golden files instead of comparing against them");
+    QCommandLineOption toleranceOption("tolerance", "Maximum deviation from the golden files, defaults to 0.0001", "tolerance", "0.0001");
+    QCommandLineOption outputOption({"o", "output"}, "Write the benchmark results to this file instead of stdout", "file");
+    parser.addOption(benchmarkOption);
+    parser.addOption(goldenOption);
+    parser.addOption(updateGoldenOption);
+    parser.addOption(toleranceOption);
+    parser.addOption(outputOption);
 
 //    QCommandLineOption asBlueOption({"b", "as-blue"}, "Run as blue strategy, defaults to yellow");
 //    parser.addOption(asBlueOption);
@@ -57,6 +122,10 @@ int main(int argc, char* argv[])
     qRegisterMetaType<Status>("Status");
     qRegisterMetaType<Command>("Command");
 
+    if (parser.isSet(benchmarkOption)) {
+        return runBenchmark(parser.positionalArguments().first(), parser, goldenOption, updateGoldenOption, toleranceOption, outputOption);
+    }
+
     Timer timer;
     timer.setTime(0, 0);
     TrackingReplay replay(&timer);
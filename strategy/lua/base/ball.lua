@@ -80,7 +80,16 @@ function Ball:_updateLostBall(time)
 	end
 end
 
+-- unset optional values are NaN in the ffi world state
+local function optional(value)
+	if value ~= value then
+		return nil
+	end
+	return value
+end
+
 -- Processes ball information from amun, passed by world
+-- data is either a protobuf table or an amun_ffi_ball struct
 function Ball:_update(data, time)
 	self.hasRawData = false
 	-- WARNING: this is the quality BEFORE the frame
@@ -106,29 +115,33 @@ function Ball:_update(data, time)
 	self._isVisible = true
 	self.pos = nextPos
 	self.speed = nextSpeed
-	self.posZ = data.p_z
-	self.speedZ = data.v_z
-	if data.touchdown_x and data.touchdown_y then
+	self.posZ = optional(data.p_z)
+	self.speedZ = optional(data.v_z)
+	if optional(data.touchdown_x) and optional(data.touchdown_y) then
 		self.touchdownPos = Coordinates.toLocal(Vector.createReadOnly(data.touchdown_x, data.touchdown_y))
 	end
 	self.isBouncing = data.is_bouncing
 
 	self:_updateTrackedState(lastSpeedLength)
 
-	self:_updateRawDetections(data.raw)
+	self:_updateRawDetections(data.raw, data.raw_count)
 end
 
-function Ball:_updateRawDetections(rawData)
-	if not rawData or #rawData == 0 then
+-- rawCount is only set for the ffi world state, its raw array is zero based
+function Ball:_updateRawDetections(rawData, rawCount)
+	local first = rawCount and 0 or 1
+	local last = rawCount and rawCount - 1 or (rawData and #rawData or 0)
+	if last < first then
 		return
 	end
-	local count = math.min(1, #rawData)
+	local count = math.min(1, last - first + 1)
 	self._hadRawData = true
 	self.hasRawData = true
 	self.detectionQuality = BALL_QUALITY_FILTER_FACTOR * count + (1 - BALL_QUALITY_FILTER_FACTOR) * self.detectionQuality
 
 	self.rawPositions = {}
-	for _, detection in ipairs(rawData) do
+	for i = first, last do
+		local detection = rawData[i]
 		local pos = Coordinates.toLocal(Vector.createReadOnly(detection.p_x, detection.p_y))
 		table.insert(self.rawPositions, pos)
 	end
@@ -236,9 +236,13 @@ function Robot:_updatePathBoundaries(geometry, aoi)
 	end
 end
 
-function Robot:_command()
+function Robot:_isStandby()
 	local STANDBY_DELAY = 30
-	local standby = self._standbyTimer >= 0 and (self._currentTime - self._standbyTimer > STANDBY_DELAY)
+	return self._standbyTimer >= 0 and (self._currentTime - self._standbyTimer > STANDBY_DELAY)
+end
+
+function Robot:_command()
+	local standby = self:_isStandby()
 
 	return {
 		controller = self._controllerInput,
@@ -253,6 +257,46 @@ function Robot:_command()
 	}
 end
 
+local NaN = 0/0
+local kickStyles = { Linear = 1, Chip = 2 }
+
+local function writePolynomial(out, polynomial)
+	out[0], out[1], out[2], out[3] = polynomial.a0, polynomial.a1, polynomial.a2, polynomial.a3
+end
+
+-- Writes the same command as _command into an amun_ffi_command struct
+-- @return bool - false if the command does not fit into the struct
+function Robot:_writeCommand(out, maxSplines)
+	local input = self._controllerInput
+	local splines = input and input.spline
+	if splines and #splines > maxSplines then
+		return false
+	end
+
+	out.generation = self.generation
+	out.id = self.id
+	out.spline_count = input and (splines and #splines or 0) or -1
+	if splines then
+		for i, spline in ipairs(splines) do
+			local outSpline = out.spline[i - 1]
+			outSpline.t_start = spline.t_start
+			outSpline.t_end = spline.t_end
+			writePolynomial(outSpline.x, spline.x)
+			writePolynomial(outSpline.y, spline.y)
+			writePolynomial(outSpline.phi, spline.phi)
+		end
+	end
+	out.v_f = input and input.v_f or NaN
+	out.v_s = input and input.v_s or NaN
+	out.omega = input and input.omega or NaN
+	out.kick_style = self._kickStyle and kickStyles[self._kickStyle] or 0
+	out.kick_power = self._kickPower
+	out.dribbler = self._dribblerSpeed or 0
+	out.force_kick = self._forceKick == true
+	out.standby = self:_isStandby()
+	return true
+end
+
 --- Set output from trajectory planing on robot
 -- The robot is halted by default if no command is set for it. To tell a robot to follow its old trajectory call robot:setControllerInput(nil)
 -- @param input Spline - Target points for the controller, in global coordinates!
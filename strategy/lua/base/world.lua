@@ -25,6 +25,7 @@ module "World"
 *************************************************************************]]
 
 local amun = amun
+local ffi = require "ffi"
 local Ball = require "../base/ball"
 local Constants = require "../base/constants"
 local Coordinates = require "../base/coordinates"
@@ -91,6 +92,13 @@ World.SelectedOptions = nil
 
 World.RULEVERSION = nil
 
+-- native structs used by World.useFFIState
+local useFFI = false
+local ffiInterface = nil
+local ffiWorldState = nil
+local ffiGameState = nil
+local ffiCommands = nil
+
 World.Geometry = {}
 --- Field geometry.
 -- Lengths in meter
@@ -142,13 +150,49 @@ function World.update()
 	if World.SelectedOptions == nil then
 		World.SelectedOptions = amun.getSelectedOptions()
 	end
-	local hasVisionData = World._updateWorld(amun.getWorldState())
-	World._updateGameState(amun.getGameState())
+	local hasVisionData
+	if useFFI then
+		-- only the rarely set parts of the world state are converted to a table
+		local extra = amun.updateFFIState()
+		hasVisionData = World._updateWorld(ffiWorldState, extra)
+		World._updateGameState(ffiGameState)
+	else
+		local state = amun.getWorldState()
+		hasVisionData = World._updateWorld(state, state)
+		World._updateGameState(amun.getGameState())
+	end
 	World._updateUserInput(amun.getUserInput())
 	World.IsReplay = amun.isReplay and amun.isReplay() or false
 	return hasVisionData
 end
 
+--- Read world and game state from native structs instead of converting them to tables each frame.
+-- The robot commands are written back the same way. Has no effect if amun does not support it
+-- @name useFFIState
+-- @param enable bool
+function World.useFFIState(enable)
+	if enable and not ffiInterface and amun.getFFIInterface then
+		ffiInterface = amun.getFFIInterface()
+		ffi.cdef(ffiInterface.declarations)
+		ffiWorldState = ffi.cast("const amun_ffi_world_state*", ffiInterface.worldState)[0]
+		ffiGameState = ffi.cast("const amun_ffi_game_state*", ffiInterface.gameState)[0]
+		ffiCommands = ffi.cast("amun_ffi_commands*", ffiInterface.commands)[0]
+	end
+	useFFI = enable and ffiInterface ~= nil
+end
+
+-- returns the robots of a team and their index range, for protobuf tables and the ffi world state
+local function teamData(state, isBlue)
+	if type(state) == "cdata" then
+		if isBlue then
+			return state.blue, 0, state.blue_count - 1
+		end
+		return state.yellow, 0, state.yellow_count - 1
+	end
+	local robots = isBlue and state.blue or state.yellow
+	return robots, 1, robots and #robots or 0
+end
+
 -- Creates generation specific robot object for own team
 function World._updateTeam(state)
 	local friendlyRobotsById = {}
@@ -218,7 +262,9 @@ function World._updateGeometry(geom)
 	World.IsLargeField = wgeom.FieldWidth > 5 and wgeom.FieldHeight > 7
 end
 
-function World._updateWorld(state)
+-- state is either the world state table or an amun_ffi_world_state struct,
+-- extra contains radio_response, mixed_team_info and tracking_aoi, it is nil if none of them is set
+function World._updateWorld(state, extra)
 	-- Get time
 	if World.Time then
 		World.TimeDiff = state.time * 1E-9 - World.Time
@@ -233,16 +279,21 @@ function World._updateWorld(state)
 		Constants.switchSimulatorConstants(World.IsSimulated)
 	end
 
-	local radioResponses = state.radio_response
+	local radioResponses = extra and extra.radio_response or {}
 
 	-- update ball if available
-	World.Ball:_update(state.ball, World.Time)
+	local ball = state.ball
+	if type(state) == "cdata" and not state.has_ball then
+		ball = nil
+	end
+	World.Ball:_update(ball, World.Time)
 
-	local dataFriendly = World.TeamIsBlue and state.blue or state.yellow
+	local dataFriendly, firstFriendly, lastFriendly = teamData(state, World.TeamIsBlue)
 	if dataFriendly then
 		-- sort data by robot id
 		local dataById = {}
-		for _,rdata in ipairs(dataFriendly) do
+		for i = firstFriendly, lastFriendly do
+			local rdata = dataFriendly[i]
 			dataById[rdata.id] = rdata
 		end
 
@@ -271,7 +322,7 @@ function World._updateWorld(state)
 		end
 	end
 
-	local dataOpponent = World.TeamIsBlue and state.yellow or state.blue
+	local dataOpponent, firstOpponent, lastOpponent = teamData(state, not World.TeamIsBlue)
 	if dataOpponent then
 		-- only keep robots that are still existent
 		local opponentRobotsById = World.OpponentRobotsById
@@ -279,7 +330,8 @@ function World._updateWorld(state)
 		World.OpponentRobotsById = {}
 		-- just update every opponent robot
 		-- robots that are invisible for more than one second are dropped by amun
-		for _,rdata in ipairs(dataOpponent) do
+		for i = firstOpponent, lastOpponent do
+			local rdata = dataOpponent[i]
 			local robot = opponentRobotsById[rdata.id]
 			opponentRobotsById[rdata.id] = nil
 			if not robot then
@@ -299,14 +351,14 @@ function World._updateWorld(state)
 	table.append(World.Robots, World.OpponentRobots)
 
 	-- convert mixed team info
-	if state.mixed_team_info and state.mixed_team_info.plans then
-		World.MixedTeam = mixedTeam.decodeData(state.mixed_team_info.plans)
+	if extra and extra.mixed_team_info and extra.mixed_team_info.plans then
+		World.MixedTeam = mixedTeam.decodeData(extra.mixed_team_info.plans)
 	else
 		World.MixedTeam = nil
 	end
 
 	-- update aoi data
-	World.AoI = state.tracking_aoi
+	World.AoI = extra and extra.tracking_aoi
 
 	-- no vision data only if the parameter is false
 	return state.has_vision_data ~= false
@@ -335,13 +387,19 @@ World.gameStageMapping = {
 local fullRefereeState = nil
 
 function World._getFullRefereeState()
+	if not fullRefereeState and useFFI then
+		fullRefereeState = amun.getGameState()
+	end
 	return fullRefereeState
 end
 
 -- updates referee command and keeper information
+-- state is either the game state table or an amun_ffi_game_state struct
 function World._updateGameState(state)
-	fullRefereeState = state
-	local refState = state.state
+	local isFFI = type(state) == "cdata"
+	-- the full game state is converted on demand
+	fullRefereeState = not isFFI and state or nil
+	local refState = isFFI and ffiInterface.gameStateNames[state.state] or state.state
 	-- map referee command to own team
 	if World.TeamIsBlue then
 		World.RefereeState = refState:gsub("Blue", "Offensive"):gsub("Yellow", "Defensive")
@@ -353,7 +411,12 @@ function World._updateGameState(state)
 		World.RefereeState = "Halt"
 	end
 
-	if state.designated_position and state.designated_position.x then
+	if isFFI then
+		if state.has_designated_position then
+			World.BallPlacementPos = Coordinates.toLocal(Vector.createReadOnly(
+				-state.designated_y / 1000, state.designated_x / 1000))
+		end
+	elseif state.designated_position and state.designated_position.x then
 		World.BallPlacementPos = Coordinates.toLocal(Vector.createReadOnly(
 			-- refbox position message uses millimeters
 			-- ssl-vision's coordinate system is rotated by 90 degrees
@@ -361,7 +424,8 @@ function World._updateGameState(state)
 			state.designated_position.x / 1000))
 	end
 
-	World.GameStage = World.gameStageMapping[state.stage]
+	local stage = isFFI and ffiInterface.gameStageNames[state.stage] or state.stage
+	World.GameStage = World.gameStageMapping[stage]
 
 	local friendlyTeamInfo = World.TeamIsBlue and state.blue or state.yellow
 	local opponentTeamInfo = World.TeamIsBlue and state.yellow or state.blue
@@ -404,18 +468,26 @@ function World._updateGameState(state)
 		required uint32 timeout_time = 7;
 	}]]
 
-	World.FriendlyYellowCards = {}
-	for _, time in ipairs(friendlyTeamInfo.yellow_card_times) do
-		table.insert(World.FriendlyYellowCards, time / 1000000)
-	end
-	World.OpponentYellowCards = {}
-	for _, time in ipairs(opponentTeamInfo.yellow_card_times) do
-		table.insert(World.OpponentYellowCards, time / 1000000)
-	end
+	World.FriendlyYellowCards = World._yellowCardTimes(friendlyTeamInfo, isFFI)
+	World.OpponentYellowCards = World._yellowCardTimes(opponentTeamInfo, isFFI)
 	World.FriendlyRedCards = friendlyTeamInfo.red_cards
 	World.OpponentRedCards = opponentTeamInfo.red_cards
 end
 
+function World._yellowCardTimes(teamInfo, isFFI)
+	local times = {}
+	if isFFI then
+		for i = 0, teamInfo.yellow_card_count - 1 do
+			table.insert(times, teamInfo.yellow_card_times[i] / 1000000)
+		end
+	else
+		for _, time in ipairs(teamInfo.yellow_card_times) do
+			table.insert(times, time / 1000000)
+		end
+	end
+	return times
+end
+
 -- update and handle user inputs set for own robots
 function World._updateUserInput(input)
 	if input.radio_command then
@@ -466,9 +538,25 @@ end
 -- Robots without a command stop by default
 -- @name setRobotCommands
 function World.setRobotCommands()
+	if not useFFI then
+		for _, robot in ipairs(World.FriendlyRobotsAll) do
+			amun.setCommand(robot.generation, robot.id, robot:_command())
+		end
+		return
+	end
+
+	local count = 0
 	for _, robot in ipairs(World.FriendlyRobotsAll) do
-		amun.setCommand(robot.generation, robot.id, robot:_command())
+		-- commands which don't fit into the struct are sent individually
+		if count >= ffiInterface.maxRobots
+				or not robot:_writeCommand(ffiCommands.command[count], ffiInterface.maxSplines) then
+			amun.setCommand(robot.generation, robot.id, robot:_command())
+		else
+			count = count + 1
+		end
 	end
+	ffiCommands.count = count
+	amun.setFFICommands()
 end
 
 World._init()
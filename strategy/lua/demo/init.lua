@@ -13,6 +13,8 @@ local debug = require "../base/debug"
 local debugger = require "../base/debugger"
 -- Holds world state and geometry
 local World = require "../base/world"
+-- Read the world state directly from native memory instead of converting it to tables each frame
+World.useFFIState(true)
 -- Support for visualizations
 local vis = require "../base/vis"
 -- For adding data to the plotter
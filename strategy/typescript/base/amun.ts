@@ -72,6 +72,8 @@ interface AmunPublic {
 	// ra version/feature tags
 	readonly SUPPORTS_OPTION_DEFAULT: boolean | undefined;
 	readonly SUPPORTS_EFFICIENT_PATHVIS: boolean | undefined;
+	readonly SUPPORTS_BATCH_VISUALIZATION: boolean | undefined;
+	readonly SUPPORTS_WORLD_STATE_BUFFER: boolean | undefined;
 }
 
 /**
@@ -82,6 +84,11 @@ interface AmunPublic {
 interface Amun extends AmunPublic {
 	/** Returns world state */
 	getWorldState(): pb.world.State;
+	/**
+	 * Writes ball and robots into buffer using the layout from base/worldbuffer, only available if amun.SUPPORTS_WORLD_STATE_BUFFER is true.
+	 * Returns the radio responses and the tracking aoi or undefined if the buffer is too small
+	 */
+	getWorldStateBuffered(buffer: Float64Array): pb.world.State | undefined;
 	/** Returns world geometry */
 	getGeometry(): pb.world.Geometry;
 	/** Returns team information */
@@ -108,6 +115,13 @@ interface Amun extends AmunPublic {
 	/** Adds a polygon visualization, pointCoordinates takes consecutive x and y coordinates of the points */
 	addPolygonSimple(name: string, r: number, g: number, b: number, alpha: number, filled: boolean,
 		background: boolean, pointCoordinates: number[]): void;
+	/**
+	 * Adds many circles, paths and polygons in one call, only available if amun.SUPPORTS_BATCH_VISUALIZATION is true.
+	 * styles holds red, green, blue, alpha, lineWidth, filled and background for every entry in names.
+	 * Each primitive starts with its type (0: circle, 1: path, 2: polygon) and style index, followed by
+	 * x, y and radius for circles or the point count and consecutive x and y coordinates for paths and polygons
+	 */
+	addVisualizations(names: string[], styles: Float32Array, primitives: Float32Array): void;
 	/** Set commands for a robot */
 	setCommand(generation: number, id: number, cmd: pb.robot.Command): void;
 	/** Takes an array of tuples of generation, id, and command. */
@@ -124,6 +138,8 @@ interface Amun extends AmunPublic {
 	addDebug(key: string, value?: number | boolean | string): void;
 	/** Add a value to the plotter */
 	addPlot(name: string, value: number): void;
+	/** Adds one value per name to the plotter, only available if amun.SUPPORTS_BATCH_VISUALIZATION is true */
+	addPlots(names: string[], values: Float32Array): void;
 	/** Send internal referee command. Only works in debug mode. Must be fully populated */
 	sendRefereeCommand(command: pb.SSL_Referee): void;
 	/** Send mixed team info packet */
@@ -186,6 +202,8 @@ export function _hideFunctions() {
 	let sendCommand = amun.sendCommand;
 	let supportsOptionDefault = amun.SUPPORTS_OPTION_DEFAULT;
 	let supportsEfficientPath = amun.SUPPORTS_EFFICIENT_PATHVIS;
+	let supportsBatchVisualization = amun.SUPPORTS_BATCH_VISUALIZATION;
+	let supportsWorldStateBuffer = amun.SUPPORTS_WORLD_STATE_BUFFER;
 
 	const makeDisabledFunction = function(name: string) {
 		// eslint-disable-next-line @typescript-eslint/naming-convention
@@ -210,6 +228,7 @@ export function _hideFunctions() {
 		sendCommand: isDebug ? sendCommand : makeDisabledFunction("sendCommand"),
 
 		getWorldState: makeDisabledFunction("getWorldState"),
+		getWorldStateBuffered: makeDisabledFunction("getWorldStateBuffered"),
 		getGeometry: makeDisabledFunction("getGeometry"),
 		getTeam: makeDisabledFunction("getTeam"),
 		isBlue: makeDisabledFunction("isBlue"),
@@ -217,6 +236,7 @@ export function _hideFunctions() {
 		addCircleSimple: makeDisabledFunction("addCircleSimple"),
 		addPathSimple: makeDisabledFunction("addPathSimple"),
 		addPolygonSimple: makeDisabledFunction("addPolygonSimple"),
+		addVisualizations: makeDisabledFunction("addVisualizations"),
 		setCommand: makeDisabledFunction("setCommand"),
 		setCommands: makeDisabledFunction("setCommands"),
 		getGameState: makeDisabledFunction("getGameState"),
@@ -225,6 +245,7 @@ export function _hideFunctions() {
 		getSelectedOptions: makeDisabledFunction("getSelectedOptions"),
 		addDebug: makeDisabledFunction("addDebug"),
 		addPlot: makeDisabledFunction("addPlot"),
+		addPlots: makeDisabledFunction("addPlots"),
 		sendRefereeCommand: makeDisabledFunction("sendRefereeCommand"),
 		sendMixedTeamInfo: makeDisabledFunction("sendMixedTeamInfo"),
 		getPerformanceMode: makeDisabledFunction("getPerformanceMode"),
@@ -238,7 +259,9 @@ export function _hideFunctions() {
 		tryCatch: makeDisabledFunction("tryCatch"),
 
 		SUPPORTS_OPTION_DEFAULT: supportsOptionDefault,
-		SUPPORTS_EFFICIENT_PATHVIS: supportsEfficientPath
+		SUPPORTS_EFFICIENT_PATHVIS: supportsEfficientPath,
+		SUPPORTS_BATCH_VISUALIZATION: supportsBatchVisualization,
+		SUPPORTS_WORLD_STATE_BUFFER: supportsWorldStateBuffer
 	};
 }
 
@@ -91,7 +91,7 @@ export class Ball {
 	}
 
 	// Processes ball information from amun, passed by world
-	public update(data: world.Ball | undefined, time: number, geom?: GeometryType, robots?: readonly Robot[]) {
+	public update(data: (world.Ball & { rawCount?: number }) | undefined, time: number, geom?: GeometryType, robots?: readonly Robot[]) {
 		this.hasRawData = false;
 		// WARNING: this is the quality BEFORE the frame
 		plot.addPlot("Ball.quality", this.detectionQuality);
@@ -137,15 +137,16 @@ export class Ball {
 
 		this._updateTrackedState(data, lastSpeedLength, robots);
 
-		this._updateRawDetections(data.raw);
+		// the world state buffer only provides the number of raw detections
+		this._updateRawDetections(data.rawCount ?? (data.raw ? data.raw.length : 0));
 	}
 
-	private _updateRawDetections(rawData: world.BallPosition[] | undefined) {
+	private _updateRawDetections(rawCount: number) {
 		let count = 0;
-		if (rawData !== undefined && rawData.length > 0) {
+		if (rawCount > 0) {
 			this._hadRawData = true;
 			this.hasRawData = true;
-			count = Math.min(1, rawData.length);
+			count = Math.min(1, rawCount);
 		}
 		if (this._hadRawData === true) {
 			this.detectionQuality = BALL_QUALITY_FILTER_FACTOR * count + (1 - BALL_QUALITY_FILTER_FACTOR) * this.detectionQuality;
@@ -39,13 +39,26 @@ export function addPlot(name: string, value: number) {
 let aggregated: { [name: string]: number } = {};
 let lastAggregated: { [name: string]: number } = {};
 export function _plotAggregated() {
+	let names: string[] = [];
+	let values: number[] = [];
 	for (let k in aggregated) {
-		addPlot(k, aggregated[k]);
+		names.push(k);
+		values.push(aggregated[k]);
 	}
 	for (let k in lastAggregated) {
 		if (aggregated[k] == undefined) {
 			// line down to zero
-			addPlot(k, 0);
+			names.push(k);
+			values.push(0);
+		}
+	}
+	if (amunLocal.SUPPORTS_BATCH_VISUALIZATION) {
+		if (names.length > 0) {
+			amunLocal.addPlots(names, new Float32Array(values));
+		}
+	} else {
+		for (let i = 0; i < names.length; i++) {
+			addPlot(names[i], values[i]);
 		}
 	}
 	lastAggregated = aggregated;
@@ -417,3 +417,89 @@ export function addFieldVisualization(name: string, f: (pos: Vector) => Color, p
 		}
 	} } as any);
 }
+
+const enum BatchPrimitive { Circle = 0, Path = 1, Polygon = 2 }
+
+/**
+ * Collects circles, paths and polygons and hands them to amun in a single call.
+ * Use this instead of the individual functions when adding many visualizations per frame.
+ * All positions are in global coordinates, the visualizations are only added once submit is called.
+ * Falls back to the individual functions if amun does not support batches.
+ */
+export class VisualizationBatch {
+	private names: string[] = [];
+	private styles: number[] = [];
+	private styleIndices = new Map<string, number>();
+	private primitives: number[] = [];
+
+	/** @see addCircleRaw */
+	public addCircle(name: string, center: Position, radius: number, color?: Color,
+			isFilled: boolean = false, background: boolean = false, lineWidth: number = 0.01) {
+		if (!amunLocal.SUPPORTS_BATCH_VISUALIZATION) {
+			addCircleRaw(name, center, radius, color, isFilled, background, undefined, lineWidth);
+			return;
+		}
+		// if color is set use passed isFilled
+		if (color == undefined) {
+			isFilled = gisFilled;
+			color = gcolor;
+		}
+		this.primitives.push(BatchPrimitive.Circle, this.style(name, color, lineWidth, isFilled, background),
+			center.x, center.y, radius);
+	}
+
+	/** @see addPathRaw */
+	public addPath(name: string, points: Position[], color: Color = gcolor, background: boolean = false,
+			lineWidth: number = 0.01) {
+		if (!amunLocal.SUPPORTS_BATCH_VISUALIZATION) {
+			addPathRaw(name, points, color, background, undefined, lineWidth);
+			return;
+		}
+		this.addPoints(BatchPrimitive.Path, this.style(name, color, lineWidth, false, background), points);
+	}
+
+	/** @see addPolygonRaw */
+	public addPolygon(name: string, points: Position[], color?: Color,
+			isFilled: boolean = false, background: boolean = false) {
+		if (!amunLocal.SUPPORTS_BATCH_VISUALIZATION) {
+			addPolygonRaw(name, points, color, isFilled, background);
+			return;
+		}
+		// if color is set use passed isFilled
+		if (color == undefined) {
+			isFilled = gisFilled;
+			color = gcolor;
+		}
+		this.addPoints(BatchPrimitive.Polygon, this.style(name, color, 0.01, isFilled, background), points);
+	}
+
+	/** Adds all collected visualizations and empties the batch */
+	public submit() {
+		if (this.primitives.length > 0) {
+			amunLocal.addVisualizations(this.names, new Float32Array(this.styles), new Float32Array(this.primitives));
+		}
+		this.names = [];
+		this.styles = [];
+		this.styleIndices.clear();
+		this.primitives = [];
+	}
+
+	private addPoints(type: BatchPrimitive, style: number, points: Position[]) {
+		this.primitives.push(type, style, points.length);
+		for (let pos of points) {
+			this.primitives.push(pos.x, pos.y);
+		}
+	}
+
+	private style(name: string, color: Color, lineWidth: number, isFilled: boolean, background: boolean): number {
+		const key = `${name}\u0000${color.red},${color.green},${color.blue},${color.alpha},${lineWidth},${isFilled},${background}`;
+		let index = this.styleIndices.get(key);
+		if (index == undefined) {
+			index = this.names.length;
+			this.names.push(name);
+			this.styles.push(color.red, color.green, color.blue, color.alpha, lineWidth, isFilled ? 1 : 0, background ? 1 : 0);
+			this.styleIndices.set(key, index);
+		}
+		return index;
+	}
+}
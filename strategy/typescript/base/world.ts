@@ -36,6 +36,7 @@ import * as pb from "base/protobuf";
 import { FriendlyRobot, Robot } from "base/robot";
 import { AbsTime, RelTime } from "base/timing";
 import { Position, Vector } from "base/vector";
+import { WorldStateBuffer } from "base/worldbuffer";
 
 
 /** Current unix timestamp in seconds (with nanoseconds precision) */
@@ -237,6 +238,24 @@ export function _init() {
 	_updateTeam(amunLocal.getTeam());
 }
 
+let worldStateBuffer: WorldStateBuffer | undefined;
+
+/**
+ * Read the world state through a preallocated typed array instead of converting it into new objects every frame.
+ * This reduces the garbage created each frame, but the raw detections of ball and robots are not available.
+ * Does nothing if amun does not support it
+ * @param enable - true to use the typed array, false for the full world state
+ */
+export function useWorldStateBuffer(enable: boolean) {
+	if (enable && amunLocal.SUPPORTS_WORLD_STATE_BUFFER) {
+		if (!worldStateBuffer) {
+			worldStateBuffer = new WorldStateBuffer();
+		}
+	} else {
+		worldStateBuffer = undefined;
+	}
+}
+
 /**
  * Update world state.
  * Has to be called once each frame
@@ -247,7 +266,13 @@ export function update() {
 		// TODO: getSelectedOptions is not yet implemented for typescript
 		// SelectedOptions = amunLocal.getSelectedOptions();
 	}
-	let hasVisionData = _updateWorld(amunLocal.getWorldState());
+	let hasVisionData: boolean;
+	if (worldStateBuffer) {
+		worldStateBuffer.update();
+		hasVisionData = _updateWorld(worldStateBuffer);
+	} else {
+		hasVisionData = _updateWorld(amunLocal.getWorldState());
+	}
 	_updateGameState(amunLocal.getGameState());
 	_updateUserInput(amunLocal.getUserInput());
 	IsReplay = amunLocal.isReplay ? amunLocal.isReplay() : false;
@@ -0,0 +1,178 @@
+/**
+ * @module worldbuffer
+ * Reads the world state from a flat Float64Array filled by amun
+ */
+
+/**************************************************************************
+*   Copyright 2026 ER-Force                                               *
+*   Robotics Erlangen e.V.                                                *
+*   http://www.robotics-erlangen.de/                                      *
+*   info@robotics-erlangen.de                                             *
+*                                                                         *
+*   This program is free software: you can redistribute it and/or modify  *
+*   it under the terms of the GNU General Public License as published by  *
+*   the Free Software Foundation, either version 3 of the License, or     *
+*   any later version.                                                    *
+*                                                                         *
+*   This program is distributed in the hope that it will be useful,       *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+*   GNU General Public License for more details.                          *
+*                                                                         *
+*   You should have received a copy of the GNU General Public License     *
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+**************************************************************************/
+
+/* eslint-disable @typescript-eslint/naming-convention */
+
+let amunLocal = amun;
+import * as pb from "base/protobuf";
+
+// Layout of the buffer, must match amunGetWorldStateBuffered in js_amun.cpp.
+// Unset optional values are NaN, unset optional flags are -1.
+// The header is followed by the ball and then by all yellow and all blue robots
+const REQUIRED_LENGTH = 0;
+const TIME_SECONDS = 1;
+const TIME_NANOSECONDS = 2;
+const WORLD_SOURCE = 3;
+const IS_SIMULATED = 4;
+const HAS_VISION_DATA = 5;
+const YELLOW_COUNT = 6;
+const BLUE_COUNT = 7;
+const HAS_BALL = 8;
+const BALL = 9;
+
+const BALL_P_X = 0;
+const BALL_P_Y = 1;
+const BALL_P_Z = 2;
+const BALL_V_X = 3;
+const BALL_V_Y = 4;
+const BALL_V_Z = 5;
+const BALL_TOUCHDOWN_X = 6;
+const BALL_TOUCHDOWN_Y = 7;
+const BALL_IS_BOUNCING = 8;
+const BALL_MAX_SPEED = 9;
+const BALL_RAW_COUNT = 10;
+const BALL_SIZE = 11;
+
+const ROBOT_ID = 0;
+const ROBOT_P_X = 1;
+const ROBOT_P_Y = 2;
+const ROBOT_PHI = 3;
+const ROBOT_V_X = 4;
+const ROBOT_V_Y = 5;
+const ROBOT_OMEGA = 6;
+const ROBOT_RAW_COUNT = 7;
+const ROBOT_SIZE = 8;
+
+const HEADER_SIZE = BALL + BALL_SIZE;
+// enough for two full teams, grows if the tracking reports more robots
+const INITIAL_ROBOT_CAPACITY = 32;
+
+const WORLD_SOURCES: (pb.world.WorldSource | undefined)[] = [undefined, pb.world.WorldSource.INTERNAL_SIMULATION,
+	pb.world.WorldSource.EXTERNAL_SIMULATION, pb.world.WorldSource.REAL_LIFE];
+
+function optional(value: number): number | undefined {
+	return Number.isNaN(value) ? undefined : value;
+}
+
+function optionalFlag(value: number): boolean | undefined {
+	return value < 0 ? undefined : value !== 0;
+}
+
+/**
+ * Ball in the world state buffer. Values are read on access and change with the next update.
+ * Raw detections are not copied, only their number is available
+ */
+export class BufferedBall implements pb.world.Ball {
+	public constructor(private readonly owner: WorldStateBuffer) { }
+
+	public get p_x() { return this.owner._data[BALL + BALL_P_X]; }
+	public get p_y() { return this.owner._data[BALL + BALL_P_Y]; }
+	public get p_z() { return optional(this.owner._data[BALL + BALL_P_Z]); }
+	public get v_x() { return this.owner._data[BALL + BALL_V_X]; }
+	public get v_y() { return this.owner._data[BALL + BALL_V_Y]; }
+	public get v_z() { return optional(this.owner._data[BALL + BALL_V_Z]); }
+	public get touchdown_x() { return optional(this.owner._data[BALL + BALL_TOUCHDOWN_X]); }
+	public get touchdown_y() { return optional(this.owner._data[BALL + BALL_TOUCHDOWN_Y]); }
+	public get is_bouncing() { return optionalFlag(this.owner._data[BALL + BALL_IS_BOUNCING]); }
+	public get max_speed() { return optional(this.owner._data[BALL + BALL_MAX_SPEED]); }
+	public get rawCount() { return this.owner._data[BALL + BALL_RAW_COUNT]; }
+}
+
+/**
+ * Robot in the world state buffer. Values are read on access and change with the next update.
+ * Raw detections are not copied, only their number is available
+ */
+export class BufferedRobot implements pb.world.Robot {
+	public constructor(private readonly owner: WorldStateBuffer, private readonly offset: number) { }
+
+	public get id() { return this.owner._data[this.offset + ROBOT_ID]; }
+	public get p_x() { return this.owner._data[this.offset + ROBOT_P_X]; }
+	public get p_y() { return this.owner._data[this.offset + ROBOT_P_Y]; }
+	public get phi() { return this.owner._data[this.offset + ROBOT_PHI]; }
+	public get v_x() { return this.owner._data[this.offset + ROBOT_V_X]; }
+	public get v_y() { return this.owner._data[this.offset + ROBOT_V_Y]; }
+	public get omega() { return this.owner._data[this.offset + ROBOT_OMEGA]; }
+	public get rawCount() { return this.owner._data[this.offset + ROBOT_RAW_COUNT]; }
+}
+
+/**
+ * World state that amun writes into a preallocated Float64Array.
+ * Ball and robots are views into that array which are reused every frame,
+ * so reading the world state does not create garbage for the ball and robots.
+ * Only available if amun.SUPPORTS_WORLD_STATE_BUFFER is true
+ */
+export class WorldStateBuffer implements pb.world.State {
+	public _data = new Float64Array(HEADER_SIZE + INITIAL_ROBOT_CAPACITY * ROBOT_SIZE);
+	public radio_response?: pb.robot.RadioResponse[];
+	public tracking_aoi?: pb.world.TrackingAOI;
+	public yellow: BufferedRobot[] = [];
+	public blue: BufferedRobot[] = [];
+
+	private readonly _ball = new BufferedBall(this);
+	private _robots: BufferedRobot[] = [];
+
+	/** Reads the current world state from amun, all previously returned views now show the new values */
+	public update() {
+		let remaining = amunLocal.getWorldStateBuffered(this._data);
+		if (remaining == undefined) {
+			this._data = new Float64Array(this._data[REQUIRED_LENGTH]);
+			remaining = amunLocal.getWorldStateBuffered(this._data)!;
+		}
+		this.radio_response = remaining.radio_response;
+		this.tracking_aoi = remaining.tracking_aoi;
+
+		const yellowCount = this._data[YELLOW_COUNT];
+		const blueCount = this._data[BLUE_COUNT];
+		while (this._robots.length < yellowCount + blueCount) {
+			this._robots.push(new BufferedRobot(this, HEADER_SIZE + this._robots.length * ROBOT_SIZE));
+		}
+		// only recreate the team lists when the number of robots changed
+		if (this.yellow.length !== yellowCount || this.blue.length !== blueCount) {
+			this.yellow = this._robots.slice(0, yellowCount);
+			this.blue = this._robots.slice(yellowCount, yellowCount + blueCount);
+		}
+	}
+
+	/** Time in nanoseconds */
+	public get time() {
+		return this._data[TIME_SECONDS] * 1E9 + this._data[TIME_NANOSECONDS];
+	}
+
+	public get ball(): BufferedBall | undefined {
+		return this._data[HAS_BALL] !== 0 ? this._ball : undefined;
+	}
+
+	public get world_source() {
+		return WORLD_SOURCES[this._data[WORLD_SOURCE]];
+	}
+
+	public get is_simulated() {
+		return optionalFlag(this._data[IS_SIMULATED]);
+	}
+
+	public get has_vision_data() {
+		return optionalFlag(this._data[HAS_VISION_DATA]);
+	}
+}
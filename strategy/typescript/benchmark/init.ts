@@ -0,0 +1,55 @@
+// Micro benchmarks for the strategy api, select this init script in the team widget
+// The results are shown in the plotter
+
+/* eslint-disable import/order */
+import "base/base";
+
+import * as Entrypoints from "base/entrypoints";
+import * as debug from "base/debug";
+import * as Debugger from "base/debugger";
+import * as World from "base/world";
+import * as vis from "base/vis";
+import * as plot from "base/plot";
+import { Vector } from "base/vector";
+
+
+// Compares how many visualizations per millisecond the individual and the batched functions can add
+const VISUALIZATION_BENCHMARK_COUNT = 2000;
+const visualizationBenchmark = function(): boolean {
+	const circlePos = new Vector(0, 0);
+	const path = [new Vector(0, 0), new Vector(1, 0), new Vector(1, 1), new Vector(0, 1)];
+
+	let start = Date.now();
+	for (let i = 0; i < VISUALIZATION_BENCHMARK_COUNT; i++) {
+		vis.addCircleRaw("benchmark/single", circlePos, i * 0.001, vis.colors.red, false);
+		vis.addPathRaw("benchmark/single", path, vis.colors.blue);
+	}
+	const singleTime = Math.max(Date.now() - start, 1);
+
+	start = Date.now();
+	const batch = new vis.VisualizationBatch();
+	for (let i = 0; i < VISUALIZATION_BENCHMARK_COUNT; i++) {
+		batch.addCircle("benchmark/batch", circlePos, i * 0.001, vis.colors.red, false);
+		batch.addPath("benchmark/batch", path, vis.colors.blue);
+	}
+	batch.submit();
+	const batchTime = Math.max(Date.now() - start, 1);
+
+	plot.addPlot("Benchmark.visualizations per ms.single", 2 * VISUALIZATION_BENCHMARK_COUNT / singleTime);
+	plot.addPlot("Benchmark.visualizations per ms.batch", 2 * VISUALIZATION_BENCHMARK_COUNT / batchTime);
+	return true;
+};
+Entrypoints.add("Visualization", visualizationBenchmark);
+
+const wrapper = function(func: () => boolean): Function {
+	return function() {
+		Debugger.runDebugger();
+		World.update();
+		func();
+		World.setRobotCommands();
+		debug.resetStack();
+		plot._plotAggregated();
+	};
+};
+
+export const scriptInfo = { name: "Benchmark", entrypoints: Entrypoints.get(wrapper) };
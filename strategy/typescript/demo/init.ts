@@ -70,6 +70,9 @@ Entrypoints.add("Demo", main);
 // You can also create a hierarchy of entrypoints
 Entrypoints.add("Sub/Demo", main);
 
+// Read ball and robots through a reused typed array, this avoids creating new objects for them every frame
+World.useWorldStateBuffer(true);
+
 // The strategy runs at a maximum frequency of 100Hz.
 // In case the strategy takes more than 10ms for a frame, only the latest available tracking output is used.
 // The strategy's wrapper function is called with the selected entrypoint passed as its first parameter